@@ -184,7 +184,7 @@ int main(int argc, char* argv[]) {
             {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, to_ui32(offsetof(vertex, color))},
         });
         float_pipeline->set_layout(layout);
-        if (!float_pipeline->create(render_pass->get()))
+        if (!float_pipeline->create(*render_pass))
             return false;
 
         if (int_supported) {
@@ -203,7 +203,7 @@ int main(int argc, char* argv[]) {
                 {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, to_ui32(offsetof(int_vertex, color))},
             });
             int_pipeline->set_layout(layout);
-            if (!int_pipeline->create(render_pass->get()))
+            if (!int_pipeline->create(*render_pass))
                 return false;
         }
 
@@ -226,7 +226,7 @@ int main(int argc, char* argv[]) {
             });
 
             double_pipeline->set_layout(layout);
-            if (!double_pipeline->create(render_pass->get()))
+            if (!double_pipeline->create(*render_pass))
                 return false;
         }
 
@@ -126,7 +126,7 @@ int main(int argc, char* argv[]) {
 
         render_pass::s_ptr render_pass = app.shading.get_pass();
 
-        if (!pipeline->create(render_pass->get()))
+        if (!pipeline->create(*render_pass))
             return false;
 
         render_pass->add_front(pipeline);
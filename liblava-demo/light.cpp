@@ -358,7 +358,7 @@ int main(int argc, char* argv[]) {
         if (!gbuffer_pipeline->create(gbuffer_renderpass->get()))
             return false;
 
-        if (!lighting_pipeline->create(lighting_renderpass->get()))
+        if (!lighting_pipeline->create(*lighting_renderpass))
             return false;
 
         return true;
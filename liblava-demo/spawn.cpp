@@ -38,6 +38,26 @@ int main(int argc, char* argv[]) {
     if (!app.setup())
         return error::not_ready;
 
+    // benchmark scenario: --spawn_instances 10000 --benchmark
+    ui32 instance_capacity = 10000;
+    app.get_cmd_line()({"-si", "--spawn_instances"}) >> instance_capacity;
+    instance_capacity = std::max(instance_capacity, 1u);
+
+    ui32 instance_count = 1;
+    if (app.get_cmd_line()[{"-si", "--spawn_instances"}])
+        instance_count = instance_capacity;
+
+    r32 instance_spacing = 2.5f;
+    bool animate_instances = false;
+    r32 instance_time = 0.f;
+
+    // frames that need new instance data (bit per frame)
+    ui64 instances_dirty = 0;
+
+    auto mark_instances_dirty = [&]() {
+        instances_dirty = (ui64(1) << app.block.get_frame_count()) - 1;
+    };
+
     mesh::s_ptr spawn_mesh;
 
     ms mesh_load_time;
@@ -68,6 +88,8 @@ int main(int argc, char* argv[]) {
                                           VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT))
         return error::create_failed;
 
+    instance_buffer::s_ptr instances;
+
     render_pipeline::s_ptr pipeline;
     pipeline_layout::s_ptr layout;
 
@@ -76,6 +98,16 @@ int main(int argc, char* argv[]) {
     VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
 
     app.on_create = [&]() {
+        instances = instance_buffer::make();
+        if (!instances->create(app.device,
+                               sizeof(mat4),
+                               instance_capacity,
+                               app.block.get_frame_count()))
+            return false;
+
+        instances->add_mat4_attribute(3, 0);
+        mark_instances_dirty();
+
         pipeline = render_pipeline::make(app.device, app.pipeline_cache);
         if (!pipeline->add_shader(app.producer.get_shader(_vertex_),
                                   VK_SHADER_STAGE_VERTEX_BIT))
@@ -90,12 +122,21 @@ int main(int argc, char* argv[]) {
         pipeline->set_depth_test_and_write();
         pipeline->set_depth_compare_op(VK_COMPARE_OP_LESS_OR_EQUAL);
 
-        pipeline->set_vertex_input_binding({0, sizeof(vertex), VK_VERTEX_INPUT_RATE_VERTEX});
-        pipeline->set_vertex_input_attributes({
+        pipeline->set_vertex_input_bindings({
+            {0, sizeof(vertex), VK_VERTEX_INPUT_RATE_VERTEX},
+            instances->get_binding_description(),
+        });
+
+        VkVertexInputAttributeDescriptions attributes = {
             {0, 0, VK_FORMAT_R32G32B32_SFLOAT, to_ui32(offsetof(vertex, position))},
             {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, to_ui32(offsetof(vertex, color))},
             {2, 0, VK_FORMAT_R32G32_SFLOAT, to_ui32(offsetof(vertex, uv))},
-        });
+        };
+        attributes.insert(attributes.end(),
+                          instances->get_attributes().begin(),
+                          instances->get_attributes().end());
+
+        pipeline->set_vertex_input_attributes(attributes);
 
         descriptor = descriptor::make();
         descriptor->add_binding(0,
@@ -162,15 +203,43 @@ int main(int argc, char* argv[]) {
 
         render_pass::s_ptr render_pass = app.shading.get_pass();
 
-        if (!pipeline->create(render_pass->get()))
+        if (!pipeline->create(*render_pass))
             return false;
 
         render_pass->add_front(pipeline);
 
         pipeline->on_process = [&](VkCommandBuffer cmd_buf) {
+            auto const frame = app.block.get_current_frame();
+
+            auto const frame_bit = ui64(1) << frame;
+            if (instances_dirty & frame_bit) {
+                auto models = instances->get<mat4>(frame);
+
+                auto const side = to_ui32(std::ceil(std::sqrt(r32(instance_count))));
+                auto const center = (side - 1) * instance_spacing * 0.5f;
+
+                for (auto i = 0u; i < instance_count; ++i) {
+                    v3 const position{(i % side) * instance_spacing - center,
+                                      0.f,
+                                      (i / side) * instance_spacing - center};
+
+                    models[i] = glm::translate(mat4(1.f), position);
+
+                    if (animate_instances)
+                        models[i] = glm::rotate(models[i], instance_time + i * 0.1f,
+                                                v3(0.f, 1.f, 0.f));
+                }
+
+                instances->flush(frame, instance_count);
+                instances_dirty &= ~frame_bit;
+            }
+
             layout->bind(cmd_buf, descriptor_set);
 
-            spawn_mesh->bind_draw(cmd_buf);
+            spawn_mesh->bind(cmd_buf);
+            instances->bind(cmd_buf, frame);
+
+            spawn_mesh->draw_instanced(cmd_buf, instance_count);
         };
 
         return true;
@@ -184,6 +253,8 @@ int main(int argc, char* argv[]) {
 
         pipeline->destroy();
         layout->destroy();
+
+        instances->destroy();
     };
 
     v3 spawn_position{0.f};
@@ -192,6 +263,8 @@ int main(int argc, char* argv[]) {
 
     bool update_spawn_matrix = false;
 
+    ui32 const one_instance = 1;
+
     app.imgui.layers.add("info", [&]() {
         ImGui::SetNextWindowPos({30, 30}, ImGuiCond_FirstUseEver);
         ImGui::SetNextWindowSize({330, 485}, ImGuiCond_FirstUseEver);
@@ -223,6 +296,19 @@ int main(int argc, char* argv[]) {
         uv2 texture_size = default_texture->get_size();
         ImGui::Text("texture: %d x %d", texture_size.x, texture_size.y);
 
+        if (ImGui::CollapsingHeader("instances")) {
+            auto update_instances = false;
+
+            update_instances |= ImGui::SliderScalar("count##instances", ImGuiDataType_U32,
+                                                    &instance_count, &one_instance,
+                                                    &instance_capacity);
+            update_instances |= ImGui::DragFloat("spacing##instances", &instance_spacing, 0.1f);
+            update_instances |= ImGui::Checkbox("animate##instances", &animate_instances);
+
+            if (update_instances)
+                mark_instances_dirty();
+        }
+
         ImGui::Separator();
 
         ImGui::Spacing();
@@ -303,6 +389,11 @@ int main(int argc, char* argv[]) {
     });
 
     app.on_update = [&](delta dt) {
+        if (animate_instances) {
+            instance_time += dt;
+            mark_instances_dirty();
+        }
+
         if (app.camera.activated()) {
             app.camera.update_view(dt, app.input.get_mouse_position());
 
@@ -10,6 +10,7 @@
 #include "liblava/app/app.hpp"
 #include "liblava/app/benchmark.hpp"
 #include "liblava/app/camera.hpp"
+#include "liblava/app/capture.hpp"
 #include "liblava/app/config.hpp"
 #include "liblava/app/def.hpp"
 #include "liblava/app/forward_shading.hpp"
@@ -102,20 +102,96 @@ bool app::create_block() {
 
         auto const current_frame = block.get_current_frame();
 
+        readback.update(current_frame);
+
         {
             scoped_label stage_mark(cmd_buf,
                                     _lava_texture_staging_,
                                     {0.f, 0.13f, 0.4f, 1.f});
 
             staging.stage(cmd_buf, current_frame);
+
+            if (auto const wait_value = staging.get_wait_value())
+                renderer.add_timeline_wait(upload_scheduler.get_semaphore(),
+                                           wait_value,
+                                           staging.get_wait_stage());
         }
 
         if (on_process)
             on_process(cmd_buf, current_frame);
 
         shading.get_pass()->process(cmd_buf, current_frame);
+
+        // render pass leaves the backbuffer in present layout
+        auto backbuffer = target->get_backbuffer(current_frame);
+        if (backbuffer)
+            backbuffer->set_state({
+                .layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                .write_stage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                .write_access = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+            });
+
+        if (!m_screenshot_path.empty()) {
+            auto const path = m_screenshot_path;
+            m_screenshot_path.clear();
+
+            auto const recorded = readback.record(cmd_buf,
+                                                  current_frame,
+                                                  backbuffer,
+                                                  [path](image_data::s_ptr image) {
+                                                      if (!write_image_png(image, path)) {
+                                                          logger()->error("screenshot failed: {}", path);
+                                                          return;
+                                                      }
+
+                                                      logger()->info("screenshot: {}", path);
+                                                  });
+            if (!recorded)
+                logger()->error("screenshot failed: {}", path);
+        }
+
+        if (next_capture_frame(m_capture)) {
+            auto const recorded = readback.record(cmd_buf,
+                                                  current_frame,
+                                                  backbuffer,
+                                                  [&, number = m_capture.current + 1](image_data::s_ptr image) {
+                                                      write_capture_frame(m_capture, image, number);
+                                                  });
+            if (recorded)
+                capture_frame_recorded(m_capture);
+
+            if (!m_capture.active && m_capture.exit)
+                add_run_once([&]() {
+                    shut_down();
+                    return run_continue;
+                });
+        }
     });
 
+    if (!headless)
+        readback.setup(device);
+
+    // textures are uploaded on a dedicated transfer queue if available
+    if (!headless && device->has_timeline_semaphore()) {
+        auto const graphics_family = device->graphics_queue().family;
+
+        for (auto& queue : device->get_transfer_queues()) {
+            if (queue.family == graphics_family)
+                continue;
+
+            if (upload_scheduler.create(device,
+                                        queue,
+                                        graphics_family,
+                                        target->get_frame_count())) {
+                staging.set_scheduler(&upload_scheduler);
+
+                logger()->trace("upload scheduler: queue family {}", queue.family);
+            }
+
+            break;
+        }
+    }
+
     return true;
 }
 
@@ -212,6 +288,13 @@ bool app::setup() {
     if (parse_benchmark(get_cmd_line(), m_frames))
         benchmark(*this, m_frames);
 
+    if (!headless && parse_capture(get_cmd_line(), m_capture)) {
+        if (m_capture.path.empty() && fs.create_folder(_capture_path_))
+            m_capture.path = fs.get_pref_dir() + _capture_path_;
+
+        start_capture(m_capture);
+    }
+
     return true;
 }
 
@@ -359,6 +442,15 @@ void app::setup_run() {
 
             block.destroy();
 
+            staging.clear();
+            staging.set_scheduler(nullptr);
+
+            upload_scheduler.destroy();
+
+            readback.teardown();
+
+            end_capture(m_capture);
+
             destroy_target();
         }
 
@@ -393,10 +485,12 @@ bool app::create_imgui() {
     imgui.setup(window.get(), imgui_config);
     if (!imgui.create(device,
                       target->get_frame_count(),
-                      shading.get_vk_pass(),
                       pipeline_cache))
         return false;
 
+    if (!imgui.get_pipeline()->create(*shading.get_pass()))
+        return false;
+
     if (format_srgb(target->get_format()))
         imgui.convert_style_to_srgb();
 
@@ -434,6 +528,10 @@ bool app::create_target() {
     if (!renderer.create(target->get_swapchain()))
         return false;
 
+    // static block commands record again for the new target
+    target->add_callback(&block.get_target_callback());
+    block.set_dirty();
+
     window.assign(&input);
 
     return on_create ? on_create() : true;
@@ -446,6 +544,8 @@ void app::destroy_target() {
 
     renderer.destroy();
     shading.destroy();
+
+    target->remove_callback(&block.get_target_callback());
     target->destroy();
 }
 
@@ -676,39 +776,17 @@ void app::render() {
 
 //-----------------------------------------------------------------------------
 string app::screenshot() {
-    if (headless)
-        return {};
-
-    auto backbuffer_image = target->get_backbuffer(renderer.get_frame());
-    if (!backbuffer_image)
-        return {};
-
-    auto image = grab_image(backbuffer_image);
-    if (!image)
+    if (headless || !readback.ready())
         return {};
 
     string screenshot_path = "screenshot/";
     if (!fs.create_folder(screenshot_path))
         return {};
 
-    auto const path = fs.get_pref_dir() + screenshot_path
-                      + get_current_time() + ".png";
-
-    auto const swizzle = !support_blit(device->get_vk_physical_device(),
-                                       backbuffer_image->get_format())
-                         && format_bgr(backbuffer_image->get_format());
-
-    auto const saved = write_image_png(device, image, path, swizzle);
-
-    image->destroy();
-
-    if (!saved) {
-        logger()->error("screenshot failed: {}", path);
-        return {};
-    }
+    m_screenshot_path = fs.get_pref_dir() + screenshot_path
+                        + get_current_time() + ".png";
 
-    logger()->info("screenshot: {}", path);
-    return path;
+    return m_screenshot_path;
 }
 
 //-----------------------------------------------------------------------------
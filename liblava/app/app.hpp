@@ -9,10 +9,13 @@
 
 #include "liblava/app/benchmark.hpp"
 #include "liblava/app/camera.hpp"
+#include "liblava/app/capture.hpp"
 #include "liblava/app/config.hpp"
 #include "liblava/app/forward_shading.hpp"
+#include "liblava/asset/image_readback.hpp"
 #include "liblava/block.hpp"
 #include "liblava/frame.hpp"
+#include "liblava/resource/staging.hpp"
 
 namespace lava {
 
@@ -71,9 +74,15 @@ struct app : frame {
     /// Gamepad
     gamepad pad;
 
-    /// Texture staging
+    /// Texture and buffer staging
     lava::staging staging;
 
+    /// Uploads on dedicated transfer queue (if available)
+    lava::upload_scheduler upload_scheduler;
+
+    /// Asynchronous readback of frame images
+    lava::image_readback readback;
+
     /// Basic block
     lava::block block;
 
@@ -204,6 +213,7 @@ struct app : frame {
 
     /**
      * @brief Take screenshot and save it to file
+     * @note Backbuffer is copied in the next frame and saved on a worker thread
      * @return string    Screenshot file path (empty: failed)
      */
     string screenshot();
@@ -345,6 +355,12 @@ private:
 
     /// Benchmark frames
     benchmark_data m_frames;
+
+    /// Path of requested screenshot (empty: none)
+    string m_screenshot_path;
+
+    /// Frame sequence capture
+    capture_data m_capture;
 };
 
 } // namespace lava
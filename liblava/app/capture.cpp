@@ -0,0 +1,248 @@
+/**
+ * @file         liblava/app/capture.cpp
+ * @brief        Frame sequence capture
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/app/capture.hpp"
+#include "liblava/asset/convert_image.hpp"
+#include "liblava/asset/write_image.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+namespace {
+
+/**
+ * @brief Get the file path of a capture frame
+ * @param data         Capture data setting
+ * @param number       Capture frame number
+ * @param extension    File extension
+ * @return string      File path
+ */
+string get_capture_file(capture_data const& data,
+                        index number,
+                        string_ref extension) {
+    auto file_path = std::filesystem::path(data.path);
+    file_path /= fmt::format("{}_{:06}.{}", _capture_file_, number, extension);
+    return file_path.string();
+}
+
+/**
+ * @brief Write data to a new file
+ * @param path       File path
+ * @param content    Data to write
+ * @param size       Size of data
+ * @return Write was successful or failed
+ */
+bool write_file(string_ref path,
+                void const* content,
+                size_t size) {
+    file file(path, file_mode::write);
+    if (!file.opened())
+        return false;
+
+    return file.write(static_cast<data::c_ptr>(content), size) == to_i64(size);
+}
+
+/**
+ * @brief Write RGBA8 image data as binary PPM (RGB)
+ * @param path     File path
+ * @param image    Image data
+ * @return Write was successful or failed
+ */
+bool write_ppm(string_ref path,
+               image_data::s_ptr image) {
+    auto const size = image->dimensions;
+    auto const pixel_count = size_t(size.x) * size.y;
+
+    auto const header = fmt::format("P6\n{} {}\n255\n", size.x, size.y);
+
+    std::vector<ui8> pixels(header.size() + pixel_count * 3);
+    memcpy(pixels.data(), header.data(), header.size());
+
+    pack_rgba_rgb(reinterpret_cast<ui8 const*>(image->get_data()),
+                  pixels.data() + header.size(),
+                  pixel_count);
+
+    return write_file(path, pixels.data(), pixels.size());
+}
+
+/**
+ * @brief Append RGBA8 image data as Y4M frame (BT.601, 4:4:4)
+ * @param data     Capture data setting
+ * @param image    Image data
+ * @return Write was successful or failed
+ */
+bool write_y4m_frame(capture_data& data,
+                     image_data::s_ptr image) {
+    auto const size = image->dimensions;
+
+    if (!data.stream) {
+        auto file_path = std::filesystem::path(data.path);
+        file_path /= fmt::format("{}.y4m", _capture_file_);
+
+        data.stream = std::make_shared<file>(file_path.string(), file_mode::write);
+        if (!data.stream->opened()) {
+            logger()->error("capture stream: {}", file_path.string());
+            return false;
+        }
+
+        data.stream_size = size;
+
+        auto const header = fmt::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C444\n",
+                                        size.x, size.y, data.fps);
+        data.stream->write(header.data(), header.size());
+    }
+
+    if (!data.stream->opened())
+        return false;
+
+    if (size != data.stream_size) {
+        logger()->warn("capture stream frame size changed: {}x{}", size.x, size.y);
+        return false;
+    }
+
+    auto const pixel_count = size_t(size.x) * size.y;
+
+    std::vector<ui8> planes(pixel_count * 3);
+    auto y_plane = planes.data();
+    auto u_plane = y_plane + pixel_count;
+    auto v_plane = u_plane + pixel_count;
+
+    auto source = reinterpret_cast<ui8 const*>(image->get_data());
+    for (auto i = 0u; i < pixel_count; ++i) {
+        i32 const r = source[i * 4];
+        i32 const g = source[i * 4 + 1];
+        i32 const b = source[i * 4 + 2];
+
+        y_plane[i] = ui8(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        u_plane[i] = ui8(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        v_plane[i] = ui8(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+
+    string const frame_header = "FRAME\n";
+    data.stream->write(frame_header.data(), frame_header.size());
+
+    return data.stream->write(reinterpret_cast<char const*>(planes.data()),
+                              planes.size())
+           == to_i64(planes.size());
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool parse_capture(cmd_line cmd_line, capture_data& data) {
+    if (!(cmd_line[{"-cap", "--capture"}]))
+        return false;
+
+    data = {};
+
+    auto const format = get_cmd(cmd_line, {"-capf", "--capture_format"});
+    if (format == "raw")
+        data.format = capture_format::raw;
+    else if (format == "ppm")
+        data.format = capture_format::ppm;
+    else if (format == "y4m")
+        data.format = capture_format::y4m;
+    else if (!format.empty() && (format != "png"))
+        logger()->warn("unknown capture format: {}", format);
+
+    cmd_line({"-capn", "--capture_every"}) >> data.every;
+    cmd_line({"-capc", "--capture_count"}) >> data.count;
+    cmd_line({"-capr", "--capture_fps"}) >> data.fps;
+    cmd_line({"-capx", "--capture_exit"}) >> data.exit;
+
+    data.path = get_cmd(cmd_line, {"-capp", "--capture_path"});
+
+    data.every = std::max(data.every, 1u);
+    data.fps = std::max(data.fps, 1u);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool start_capture(capture_data& data) {
+    if (!data.path.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(data.path, ec);
+        if (ec) {
+            logger()->error("capture path: {}", data.path);
+            return false;
+        }
+    }
+
+    data.frame = 0;
+    data.current = 0;
+    data.active = true;
+
+    logger()->info("capture start every {} frame(s) to {}",
+                   data.every, data.path);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool next_capture_frame(capture_data& data) {
+    if (!data.active)
+        return false;
+
+    auto const frame = data.frame++;
+    return (frame % data.every) == 0;
+}
+
+//-----------------------------------------------------------------------------
+void capture_frame_recorded(capture_data& data) {
+    data.current++;
+
+    if (data.count && (data.current >= data.count))
+        data.active = false;
+}
+
+//-----------------------------------------------------------------------------
+bool write_capture_frame(capture_data& data,
+                         image_data::s_ptr image,
+                         index number) {
+    if (!image) {
+        logger()->error("capture frame: {}", number);
+        return false;
+    }
+
+    auto result = false;
+
+    switch (data.format) {
+    case capture_format::raw:
+        result = write_file(get_capture_file(data, number, "rgba"),
+                            image->get_data(),
+                            image->size());
+        break;
+
+    case capture_format::ppm:
+        result = write_ppm(get_capture_file(data, number, "ppm"), image);
+        break;
+
+    case capture_format::png:
+        result = write_image_png(image, get_capture_file(data, number, "png"));
+        break;
+
+    case capture_format::y4m:
+        result = write_y4m_frame(data, image);
+        break;
+    }
+
+    if (!result)
+        logger()->error("capture frame: {}", number);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+void end_capture(capture_data& data) {
+    data.active = false;
+    data.stream = nullptr;
+
+    if (data.current)
+        logger()->info("capture end: {} frame(s)", data.current);
+}
+
+} // namespace lava
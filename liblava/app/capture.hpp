@@ -0,0 +1,112 @@
+/**
+ * @file         liblava/app/capture.hpp
+ * @brief        Frame sequence capture
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/app/def.hpp"
+#include "liblava/file/file.hpp"
+#include "liblava/frame/argh.hpp"
+#include "liblava/resource/image.hpp"
+
+namespace lava {
+
+/**
+ * @brief Capture output formats
+ */
+enum class capture_format : index {
+    raw = 0,
+    ppm,
+    png,
+    y4m
+};
+
+/**
+ * @brief Capture data
+ */
+struct capture_data {
+    /// Capture is running
+    bool active = false;
+
+    /// Output format
+    capture_format format = capture_format::png;
+
+    /// Capture every nth frame
+    ui32 every = 1;
+
+    /// Number of frames to capture (0: until shut down)
+    ui32 count = 0;
+
+    /// Frame rate of y4m stream
+    ui32 fps = 60;
+
+    /// Output path (empty: pref_dir/capture/)
+    string path;
+
+    /// Close app after count frames
+    bool exit = true;
+
+    /// Frames since capture start
+    index frame = 0;
+
+    /// Number of captured frames
+    index current = 0;
+
+    /// Y4M stream file
+    std::shared_ptr<file> stream;
+
+    /// Y4M stream frame size
+    uv2 stream_size = {};
+};
+
+/**
+ * @brief Parse command line arguments and set capture data
+ * @param cmd_line    Command line arguments
+ * @param data        Capture data
+ * @return Capture data is parsed or not ready
+ */
+bool parse_capture(cmd_line cmd_line, capture_data& data);
+
+/**
+ * @brief Start a capture run (creates output path)
+ * @param data    Capture data setting
+ * @return Start was successful or failed
+ */
+bool start_capture(capture_data& data);
+
+/**
+ * @brief Advance the capture by one frame
+ * @param data    Capture data setting
+ * @return Current frame should be captured or not
+ */
+bool next_capture_frame(capture_data& data);
+
+/**
+ * @brief Count a recorded capture frame (stops at capture count)
+ * @note Call only when the readback was recorded, skipped frames keep the numbering gapless
+ * @param data    Capture data setting
+ */
+void capture_frame_recorded(capture_data& data);
+
+/**
+ * @brief Write a captured frame
+ * @note Called on readback worker, frames must arrive in order for y4m
+ * @param data      Capture data setting
+ * @param image     RGBA8 image data
+ * @param number    Capture frame number
+ * @return Write was successful or failed
+ */
+bool write_capture_frame(capture_data& data,
+                         image_data::s_ptr image,
+                         index number);
+
+/**
+ * @brief End a capture run (closes stream)
+ * @param data    Capture data setting
+ */
+void end_capture(capture_data& data);
+
+} // namespace lava
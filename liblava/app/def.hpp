@@ -68,6 +68,11 @@ constexpr name _frames_ = "frames";
 constexpr name _timestamps_ = "timestamps";
 constexpr name _benchmark_json_ = "benchmark.json";
 
+/// capture
+
+constexpr name _capture_path_ = "capture/";
+constexpr name _capture_file_ = "capture";
+
 /// ImGui
 
 constexpr name _imgui_file_ = "imgui.ini";
@@ -19,6 +19,7 @@ bool forward_shading::create(render_target::s_ptr t) {
         return false;
 
     m_pass = render_pass::make(m_target->get_device());
+    m_pass->set_dynamic_rendering(m_target->get_device()->has_dynamic_rendering());
     {
         auto color_attachment = attachment::make(m_target->get_format());
         color_attachment->set_op(VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE);
@@ -78,6 +79,7 @@ bool forward_shading::create(render_target::s_ptr t) {
 
     m_target->on_create_attachments = [&]() -> VkAttachments {
         VkAttachments result;
+        std::vector<VkImages> images;
 
         if (!m_depth_stencil->create(m_target->get_device(), m_target->get_size()))
             return {};
@@ -89,8 +91,11 @@ bool forward_shading::create(render_target::s_ptr t) {
             attachments.push_back(m_depth_stencil->get_view());
 
             result.push_back(attachments);
+            images.push_back({backbuffer->get(), m_depth_stencil->get()});
         }
 
+        m_pass->set_attachment_images(images);
+
         return result;
     };
 
@@ -50,7 +50,7 @@ struct forward_shading {
 
     /**
      * @brief Get the Vulkan render pass
-     * @return VkRenderPass    Vulkan Render pass
+     * @return VkRenderPass    Vulkan Render pass (none with dynamic rendering)
      */
     VkRenderPass get_vk_pass() const {
         return m_pass->get();
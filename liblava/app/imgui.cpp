@@ -7,6 +7,7 @@
 
 #include "liblava/app/imgui.hpp"
 #include "liblava/app/def.hpp"
+#include "liblava/base/cmd_state.hpp"
 #include "liblava/base/debug_utils.hpp"
 #include "liblava/resource/format.hpp"
 #include "liblava/util/log.hpp"
@@ -584,16 +585,16 @@ void imgui::render_draw_lists(VkCommandBuffer cmd_buf) {
 
     std::array<VkDeviceSize, 1> const vertex_offset = {0};
     std::array<VkBuffer, 1> const buffers = {m_vertex_buffers[m_frame]->get()};
-    m_device->call().vkCmdBindVertexBuffers(cmd_buf,
-                                            0,
-                                            to_ui32(buffers.size()),
-                                            buffers.data(),
-                                            vertex_offset.data());
+    cmd_bind_vertex_buffers(cmd_buf,
+                            0,
+                            to_ui32(buffers.size()),
+                            buffers.data(),
+                            vertex_offset.data());
 
-    m_device->call().vkCmdBindIndexBuffer(cmd_buf,
-                                          m_index_buffers[m_frame]->get(),
-                                          0,
-                                          VK_INDEX_TYPE_UINT16);
+    cmd_bind_index_buffer(cmd_buf,
+                          m_index_buffers[m_frame]->get(),
+                          0,
+                          VK_INDEX_TYPE_UINT16);
 
     VkViewport viewport;
     viewport.x = 0;
@@ -603,33 +604,29 @@ void imgui::render_draw_lists(VkCommandBuffer cmd_buf) {
     viewport.minDepth = 0.f;
     viewport.maxDepth = 1.f;
 
-    std::array<VkViewport, 1> const viewports = {viewport};
-    m_device->call().vkCmdSetViewport(cmd_buf,
-                                      0,
-                                      to_ui32(viewports.size()),
-                                      viewports.data());
+    cmd_set_viewport(cmd_buf, viewport);
 
     auto& io = ImGui::GetIO();
 
     r32 scale[2];
     scale[0] = 2.f / io.DisplaySize.x;
     scale[1] = 2.f / io.DisplaySize.y;
-    m_device->call().vkCmdPushConstants(cmd_buf,
-                                        m_layout->get(),
-                                        VK_SHADER_STAGE_VERTEX_BIT,
-                                        sizeof(r32) * 0,
-                                        sizeof(r32) * 2,
-                                        scale);
+    cmd_push_constants(cmd_buf,
+                       m_layout->get(),
+                       VK_SHADER_STAGE_VERTEX_BIT,
+                       sizeof(r32) * 0,
+                       sizeof(r32) * 2,
+                       scale);
 
     r32 translate[2];
     translate[0] = -1.f;
     translate[1] = -1.f;
-    m_device->call().vkCmdPushConstants(cmd_buf,
-                                        m_layout->get(),
-                                        VK_SHADER_STAGE_VERTEX_BIT,
-                                        sizeof(r32) * 2,
-                                        sizeof(r32) * 2,
-                                        translate);
+    cmd_push_constants(cmd_buf,
+                       m_layout->get(),
+                       VK_SHADER_STAGE_VERTEX_BIT,
+                       sizeof(r32) * 2,
+                       sizeof(r32) * 2,
+                       translate);
 
     auto vtx_offset = 0u;
     auto idx_offset = 0u;
@@ -639,6 +636,10 @@ void imgui::render_draw_lists(VkCommandBuffer cmd_buf) {
             auto const* cmd = &cmd_list->CmdBuffer[c];
             if (cmd->UserCallback) {
                 cmd->UserCallback(cmd_list, cmd);
+
+                // callback may record raw binds
+                if (auto state = cmd_state::current(cmd_buf))
+                    state->invalidate();
             } else {
                 VkRect2D scissor;
                 scissor.offset = {
@@ -651,11 +652,7 @@ void imgui::render_draw_lists(VkCommandBuffer cmd_buf) {
                 scissor.extent = {(ui32)(cmd->ClipRect.z - cmd->ClipRect.x),
                                   (ui32)(cmd->ClipRect.w - cmd->ClipRect.y + 1)};
 
-                std::array<VkRect2D, 1> const scissors = {scissor};
-                m_device->call().vkCmdSetScissor(cmd_buf,
-                                                 0,
-                                                 to_ui32(scissors.size()),
-                                                 scissors.data());
+                cmd_set_scissor(cmd_buf, scissor);
 
                 m_device->call().vkCmdDrawIndexed(cmd_buf,
                                                   cmd->ElemCount,
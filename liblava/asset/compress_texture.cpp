@@ -0,0 +1,733 @@
+/**
+ * @file         liblava/asset/compress_texture.cpp
+ * @brief        Block compression of texture data (BCn)
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/compress_texture.hpp"
+#include "liblava/asset/convert_image.hpp"
+#include "liblava/file/file.hpp"
+#include "liblava/file/file_utils.hpp"
+#include "liblava/util/log.hpp"
+#include <cmath>
+#include <thread>
+
+// SSE2 is part of every x86-64 target
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define LAVA_COMPRESS_SSE2 1
+#endif
+
+#ifdef _WIN32
+    #pragma warning(push, 4)
+    #pragma warning(disable : 4458)
+    #pragma warning(disable : 4100)
+    #pragma warning(disable : 5054)
+    #pragma warning(disable : 4244)
+    #pragma warning(disable : 4189)
+#else
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wignored-qualifiers"
+    #pragma GCC diagnostic ignored "-Wunused-variable"
+    #pragma GCC diagnostic ignored "-Wtype-limits"
+    #pragma GCC diagnostic ignored "-Wempty-body"
+    #pragma GCC diagnostic ignored "-Wunused-result"
+    #pragma GCC diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#endif
+
+#include "gli/gli.hpp"
+
+#ifdef _WIN32
+    #pragma warning(pop)
+#else
+    #pragma GCC diagnostic pop
+#endif
+
+namespace lava {
+
+namespace {
+
+/// Minimum number of block rows per thread
+constexpr ui32 compress_min_block_rows = 32;
+
+/// 4x4 texels (RGBA8)
+using texel_block = std::array<std::array<i32, 4>, 16>;
+
+/// Interpolation weights of 4 bit indices (BC7)
+constexpr std::array<i32, 16> bc7_weights = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+};
+
+/**
+ * @brief Load a 4x4 block (edge texels are repeated)
+ * @param pixels     RGBA8 pixel data
+ * @param size       Size of image
+ * @param block_x    Block column
+ * @param block_y    Block row
+ * @param block      Target block
+ */
+void load_block(ui8 const* pixels,
+                uv2 size,
+                ui32 block_x,
+                ui32 block_y,
+                texel_block& block) {
+    for (auto y = 0u; y < 4; ++y) {
+        auto const py = std::min(block_y * 4 + y, size.y - 1);
+
+        for (auto x = 0u; x < 4; ++x) {
+            auto const px = std::min(block_x * 4 + x, size.x - 1);
+            auto const texel = pixels + (size_t(py) * size.x + px) * 4;
+
+            for (auto c = 0u; c < 4; ++c)
+                block[y * 4 + x][c] = texel[c];
+        }
+    }
+}
+
+/**
+ * @brief Find the nearest palette entry
+ * @tparam N          Number of palette entries
+ * @param texel       Texel to match
+ * @param palette     Palette colors
+ * @param channels    Number of channels to compare
+ * @return ui32       Palette index
+ */
+template <size_t N>
+ui32 nearest_index(std::array<i32, 4> const& texel,
+                   std::array<std::array<i32, 4>, N> const& palette,
+                   ui32 channels) {
+    auto best = 0u;
+    auto best_error = std::numeric_limits<i32>::max();
+
+#if LAVA_COMPRESS_SSE2
+    if constexpr (N % 4 == 0) {
+        auto load = [](std::array<i32, 4> const& color) {
+            return _mm_loadu_si128(reinterpret_cast<__m128i const*>(color.data()));
+        };
+
+        // 16-bit channels of two entries per register, unused channels masked out
+        auto const mask = _mm_setr_epi16(channels > 0 ? -1 : 0, channels > 1 ? -1 : 0,
+                                         channels > 2 ? -1 : 0, channels > 3 ? -1 : 0,
+                                         channels > 0 ? -1 : 0, channels > 1 ? -1 : 0,
+                                         channels > 2 ? -1 : 0, channels > 3 ? -1 : 0);
+        auto const value = _mm_packs_epi32(load(texel), load(texel));
+
+        auto squared = [&](std::array<i32, 4> const& first,
+                           std::array<i32, 4> const& second) {
+            auto const diff = _mm_and_si128(_mm_sub_epi16(value,
+                                                          _mm_packs_epi32(load(first),
+                                                                          load(second))),
+                                            mask);
+            return _mm_castsi128_ps(_mm_madd_epi16(diff, diff));
+        };
+
+        alignas(16) std::array<i32, 4> errors;
+
+        // 4 entries per step
+        for (auto i = 0u; i < N; i += 4) {
+            auto const low = squared(palette[i], palette[i + 1]);
+            auto const high = squared(palette[i + 2], palette[i + 3]);
+
+            _mm_store_si128(reinterpret_cast<__m128i*>(errors.data()),
+                            _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0))),
+                                          _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)))));
+
+            for (auto j = 0u; j < 4; ++j) {
+                if (errors[j] < best_error) {
+                    best_error = errors[j];
+                    best = i + j;
+                }
+            }
+        }
+
+        return best;
+    }
+#endif
+
+    for (auto i = 0u; i < N; ++i) {
+        auto error = 0;
+        for (auto c = 0u; c < channels; ++c) {
+            auto const diff = texel[c] - palette[i][c];
+            error += diff * diff;
+        }
+
+        if (error < best_error) {
+            best_error = error;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Get the bounding box of a block
+ * @param block       Source block
+ * @param channels    Number of channels
+ * @param low         Minimum per channel
+ * @param high        Maximum per channel
+ */
+void block_bounds(texel_block const& block,
+                  ui32 channels,
+                  std::array<i32, 4>& low,
+                  std::array<i32, 4>& high) {
+    low.fill(255);
+    high.fill(0);
+
+    for (auto const& texel : block)
+        for (auto c = 0u; c < channels; ++c) {
+            low[c] = std::min(low[c], texel[c]);
+            high[c] = std::max(high[c], texel[c]);
+        }
+}
+
+/**
+ * @brief Pack a color to RGB565
+ * @param color    RGB color
+ * @return ui16    Packed color
+ */
+ui16 pack_565(std::array<i32, 4> const& color) {
+    auto const r = (color[0] * 31 + 127) / 255;
+    auto const g = (color[1] * 63 + 127) / 255;
+    auto const b = (color[2] * 31 + 127) / 255;
+
+    return ui16((r << 11) | (g << 5) | b);
+}
+
+/**
+ * @brief Unpack a RGB565 color
+ * @param packed    Packed color
+ * @return std::array<i32, 4>    RGB color
+ */
+std::array<i32, 4> unpack_565(ui16 packed) {
+    auto const r = (packed >> 11) & 31;
+    auto const g = (packed >> 5) & 63;
+    auto const b = packed & 31;
+
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255};
+}
+
+/**
+ * @brief Encode a BC1 block (4 color mode)
+ * @param block     Source block
+ * @param target    8 bytes
+ */
+void encode_bc1(texel_block const& block,
+                ui8* target) {
+    std::array<i32, 4> low, high;
+    block_bounds(block, 3, low, high);
+
+    // inset bounding box to reduce the error at the ends
+    for (auto c = 0u; c < 3; ++c) {
+        auto const inset = (high[c] - low[c]) >> 4;
+        low[c] += inset;
+        high[c] -= inset;
+    }
+
+    auto color_0 = pack_565(high);
+    auto color_1 = pack_565(low);
+    if (color_0 < color_1)
+        std::swap(color_0, color_1);
+
+    ui32 indices = 0;
+
+    if (color_0 != color_1) {
+        std::array<std::array<i32, 4>, 4> palette = {};
+        palette[0] = unpack_565(color_0);
+        palette[1] = unpack_565(color_1);
+
+        for (auto c = 0u; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (auto i = 0u; i < 16; ++i)
+            indices |= nearest_index(block[i], palette, 3) << (2 * i);
+    }
+
+    memcpy(target, &color_0, 2);
+    memcpy(target + 2, &color_1, 2);
+    memcpy(target + 4, &indices, 4);
+}
+
+/**
+ * @brief Encode a BC4 block (8 value mode)
+ * @param block      Source block
+ * @param channel    Channel to encode
+ * @param target     8 bytes
+ */
+void encode_bc4(texel_block const& block,
+                ui32 channel,
+                ui8* target) {
+    auto low = 255;
+    auto high = 0;
+
+    for (auto const& texel : block) {
+        low = std::min(low, texel[channel]);
+        high = std::max(high, texel[channel]);
+    }
+
+    ui64 indices = 0;
+
+    if (high > low) {
+        std::array<std::array<i32, 4>, 8> palette = {};
+        palette[0][0] = high;
+        palette[1][0] = low;
+
+        for (auto i = 1; i < 7; ++i)
+            palette[i + 1][0] = ((7 - i) * high + i * low + 3) / 7;
+
+        for (auto i = 0u; i < 16; ++i) {
+            std::array<i32, 4> const value = {block[i][channel], 0, 0, 0};
+            indices |= ui64(nearest_index(value, palette, 1)) << (3 * i);
+        }
+    }
+
+    target[0] = ui8(high);
+    target[1] = ui8(low);
+
+    for (auto i = 0u; i < 6; ++i)
+        target[2 + i] = ui8(indices >> (8 * i));
+}
+
+/**
+ * @brief Bits of a 128 bit block
+ */
+struct block_bits {
+    /// Block data
+    std::array<ui8, 16> data = {};
+
+    /// Write position
+    ui32 position = 0;
+
+    /**
+     * @brief Write bits (LSB first)
+     * @param value    Value to write
+     * @param count    Number of bits
+     */
+    void write(ui32 value,
+               ui32 count) {
+        for (auto i = 0u; i < count; ++i, ++position)
+            if ((value >> i) & 1)
+                data[position / 8] |= ui8(1 << (position % 8));
+    }
+};
+
+/**
+ * @brief Quantize an endpoint to 7 bits with p-bit (BC7 mode 6)
+ * @param color       Endpoint color
+ * @param quantized   7 bit channels
+ * @return ui32       P-bit
+ */
+ui32 quantize_bc7_endpoint(std::array<i32, 4> const& color,
+                           std::array<i32, 4>& quantized) {
+    auto best_p_bit = 0u;
+    auto best_error = std::numeric_limits<i32>::max();
+
+    for (auto p_bit = 0; p_bit < 2; ++p_bit) {
+        std::array<i32, 4> candidate;
+        auto error = 0;
+
+        for (auto c = 0u; c < 4; ++c) {
+            candidate[c] = std::clamp((color[c] - p_bit + 1) / 2, 0, 127);
+            error += std::abs(((candidate[c] << 1) | p_bit) - color[c]);
+        }
+
+        if (error < best_error) {
+            best_error = error;
+            best_p_bit = p_bit;
+            quantized = candidate;
+        }
+    }
+
+    return best_p_bit;
+}
+
+/**
+ * @brief Encode a BC7 block (mode 6: one subset, RGBA endpoints, 4 bit indices)
+ * @param block     Source block
+ * @param target    16 bytes
+ */
+void encode_bc7(texel_block const& block,
+                ui8* target) {
+    std::array<i32, 4> low, high;
+    block_bounds(block, 4, low, high);
+
+    std::array<std::array<i32, 4>, 2> endpoints;
+    std::array<ui32, 2> p_bits = {
+        quantize_bc7_endpoint(low, endpoints[0]),
+        quantize_bc7_endpoint(high, endpoints[1]),
+    };
+
+    std::array<std::array<i32, 4>, 16> palette = {};
+    for (auto i = 0u; i < 16; ++i)
+        for (auto c = 0u; c < 4; ++c) {
+            auto const e0 = (endpoints[0][c] << 1) | i32(p_bits[0]);
+            auto const e1 = (endpoints[1][c] << 1) | i32(p_bits[1]);
+            palette[i][c] = (e0 * (64 - bc7_weights[i]) + e1 * bc7_weights[i] + 32) >> 6;
+        }
+
+    std::array<ui32, 16> indices;
+    for (auto i = 0u; i < 16; ++i)
+        indices[i] = nearest_index(block[i], palette, 4);
+
+    // anchor index has an implicit zero high bit
+    if (indices[0] & 8) {
+        std::swap(endpoints[0], endpoints[1]);
+        std::swap(p_bits[0], p_bits[1]);
+
+        for (auto& value : indices)
+            value = 15 - value;
+    }
+
+    block_bits bits;
+    bits.write(1 << 6, 7);
+
+    for (auto c = 0u; c < 4; ++c) {
+        bits.write(ui32(endpoints[0][c]), 7);
+        bits.write(ui32(endpoints[1][c]), 7);
+    }
+
+    bits.write(p_bits[0], 1);
+    bits.write(p_bits[1], 1);
+
+    bits.write(indices[0], 3);
+    for (auto i = 1u; i < 16; ++i)
+        bits.write(indices[i], 4);
+
+    memcpy(target, bits.data.data(), bits.data.size());
+}
+
+/**
+ * @brief Encode a block
+ * @param format    Block format
+ * @param block     Source block
+ * @param target    Target block
+ */
+void encode_block(block_format format,
+                  texel_block const& block,
+                  ui8* target) {
+    switch (format) {
+    case block_format::bc1:
+        encode_bc1(block, target);
+        break;
+
+    case block_format::bc3:
+        encode_bc4(block, 3, target);
+        encode_bc1(block, target + 8);
+        break;
+
+    case block_format::bc4:
+        encode_bc4(block, 0, target);
+        break;
+
+    case block_format::bc5:
+        encode_bc4(block, 0, target);
+        encode_bc4(block, 1, target + 8);
+        break;
+
+    case block_format::bc7:
+        encode_bc7(block, target);
+        break;
+
+    case block_format::none:
+        break;
+    }
+}
+
+/**
+ * @brief Downsample to the next mip level (2x2 box filter)
+ * @param source         RGBA8 pixels
+ * @param source_size    Size of source
+ * @param target         Target pixels
+ * @param srgb           Filter color in linear space
+ * @return uv2           Size of target
+ */
+uv2 downsample(ui8 const* source,
+               uv2 source_size,
+               std::vector<ui8>& target,
+               bool srgb) {
+    uv2 const size = {std::max(source_size.x / 2, 1u),
+                      std::max(source_size.y / 2, 1u)};
+
+    auto const source_count = size_t(source_size.x) * source_size.y;
+    auto const pixel_count = size_t(size.x) * size.y;
+
+    std::vector<r32> linear(source_count * 4);
+    if (srgb)
+        decode_srgb(source, linear.data(), source_count);
+    else
+        convert_unorm_float(source, linear.data(), linear.size());
+
+    std::vector<r32> filtered(pixel_count * 4);
+
+    for (auto y = 0u; y < size.y; ++y) {
+        std::array<ui32, 2> const rows = {std::min(y * 2, source_size.y - 1),
+                                          std::min(y * 2 + 1, source_size.y - 1)};
+
+        for (auto x = 0u; x < size.x; ++x) {
+            std::array<ui32, 2> const columns = {std::min(x * 2, source_size.x - 1),
+                                                 std::min(x * 2 + 1, source_size.x - 1)};
+
+            auto texel = filtered.data() + (size_t(y) * size.x + x) * 4;
+
+            for (auto row : rows)
+                for (auto column : columns) {
+                    auto const value = linear.data() + (size_t(row) * source_size.x + column) * 4;
+                    for (auto c = 0u; c < 4; ++c)
+                        texel[c] += value[c] * 0.25f;
+                }
+        }
+    }
+
+    std::vector<ui8> result(pixel_count * 4);
+    if (srgb)
+        encode_srgb(filtered.data(), result.data(), pixel_count);
+    else
+        convert_float_unorm(filtered.data(), result.data(), filtered.size());
+
+    target = std::move(result);
+    return size;
+}
+
+/**
+ * @brief Get the gli format of a block format
+ * @param format          Block format
+ * @param srgb            Color data is sRGB
+ * @return gli::format    gli format (undefined: none)
+ */
+gli::format get_gli_format(block_format format,
+                           bool srgb) {
+    switch (format) {
+    case block_format::bc1:
+        return srgb ? gli::FORMAT_RGB_DXT1_SRGB_BLOCK8
+                    : gli::FORMAT_RGB_DXT1_UNORM_BLOCK8;
+
+    case block_format::bc3:
+        return srgb ? gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16
+                    : gli::FORMAT_RGBA_DXT5_UNORM_BLOCK16;
+
+    case block_format::bc4:
+        return gli::FORMAT_R_ATI1N_UNORM_BLOCK8;
+
+    case block_format::bc5:
+        return gli::FORMAT_RG_ATI2N_UNORM_BLOCK16;
+
+    case block_format::bc7:
+        return srgb ? gli::FORMAT_RGBA_BP_SRGB_BLOCK16
+                    : gli::FORMAT_RGBA_BP_UNORM_BLOCK16;
+
+    case block_format::none:
+        break;
+    }
+
+    return gli::FORMAT_UNDEFINED;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+VkFormat get_block_format(block_format format,
+                          bool srgb) {
+    switch (format) {
+    case block_format::bc1:
+        return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK
+                    : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+
+    case block_format::bc3:
+        return srgb ? VK_FORMAT_BC3_SRGB_BLOCK
+                    : VK_FORMAT_BC3_UNORM_BLOCK;
+
+    case block_format::bc4:
+        return VK_FORMAT_BC4_UNORM_BLOCK;
+
+    case block_format::bc5:
+        return VK_FORMAT_BC5_UNORM_BLOCK;
+
+    case block_format::bc7:
+        return srgb ? VK_FORMAT_BC7_SRGB_BLOCK
+                    : VK_FORMAT_BC7_UNORM_BLOCK;
+
+    case block_format::none:
+        break;
+    }
+
+    return VK_FORMAT_UNDEFINED;
+}
+
+//-----------------------------------------------------------------------------
+ui32 get_block_format_size(block_format format) {
+    switch (format) {
+    case block_format::bc1:
+    case block_format::bc4:
+        return 8;
+
+    case block_format::bc3:
+    case block_format::bc5:
+    case block_format::bc7:
+        return 16;
+
+    case block_format::none:
+        break;
+    }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+bool compress_image(c_data::ref pixels,
+                    uv2 size,
+                    block_format format,
+                    std::vector<char>& target,
+                    ui32 thread_count) {
+    auto const block_size = get_block_format_size(format);
+    if (!pixels.addr || block_size == 0 || size.x == 0 || size.y == 0
+        || pixels.size < size_t(size.x) * size.y * 4)
+        return false;
+
+    auto const blocks_x = (size.x + 3) / 4;
+    auto const blocks_y = (size.y + 3) / 4;
+
+    target.resize(size_t(blocks_x) * blocks_y * block_size);
+
+    auto source = reinterpret_cast<ui8 const*>(pixels.addr);
+    auto blocks = reinterpret_cast<ui8*>(target.data());
+
+    auto compress_rows = [&](ui32 first_row, ui32 last_row) {
+        texel_block block;
+
+        for (auto block_y = first_row; block_y < last_row; ++block_y)
+            for (auto block_x = 0u; block_x < blocks_x; ++block_x) {
+                load_block(source, size, block_x, block_y, block);
+                encode_block(format, block,
+                             blocks + (size_t(block_y) * blocks_x + block_x) * block_size);
+            }
+    };
+
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    auto const chunk_count = std::clamp(blocks_y / compress_min_block_rows,
+                                        1u,
+                                        thread_count);
+
+    if (chunk_count == 1) {
+        compress_rows(0, blocks_y);
+        return true;
+    }
+
+    auto const chunk_rows = (blocks_y + chunk_count - 1) / chunk_count;
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunk_count);
+
+    for (auto first_row = 0u; first_row < blocks_y; first_row += chunk_rows)
+        threads.emplace_back(compress_rows,
+                             first_row,
+                             std::min(first_row + chunk_rows, blocks_y));
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool write_compressed_texture(string_ref filename,
+                              c_data::ref pixels,
+                              uv2 size,
+                              block_format format,
+                              bool srgb,
+                              ui32 thread_count) {
+    auto const gli_format = get_gli_format(format, srgb);
+    if (gli_format == gli::FORMAT_UNDEFINED || !pixels.addr
+        || size.x == 0 || size.y == 0) {
+        logger()->error("compress texture: {}", filename);
+        return false;
+    }
+
+    auto level_count = 1u;
+    for (auto dim = std::max(size.x, size.y); dim > 1; dim >>= 1)
+        ++level_count;
+
+    gli::texture2d tex(gli_format,
+                       gli::extent2d(size.x, size.y),
+                       level_count);
+
+    // single and dual channel data (masks, normals) is filtered linear
+    auto const srgb_filter = srgb
+                             && (format != block_format::bc4)
+                             && (format != block_format::bc5);
+
+    auto level_pixels = reinterpret_cast<ui8 const*>(pixels.addr);
+    auto level_size = size;
+
+    std::vector<ui8> mip_pixels;
+    std::vector<char> blocks;
+
+    for (auto level = 0u; level < level_count; ++level) {
+        c_data const level_data(level_pixels,
+                                size_t(level_size.x) * level_size.y * 4);
+
+        if (!compress_image(level_data, level_size, format, blocks, thread_count)
+            || blocks.size() != tex.size(level)) {
+            logger()->error("compress texture level: {} - {}", filename, level);
+            return false;
+        }
+
+        memcpy(tex.data(0, 0, level), blocks.data(), blocks.size());
+
+        if (level + 1 < level_count) {
+            level_size = downsample(level_pixels, level_size, mip_pixels, srgb_filter);
+            level_pixels = mip_pixels.data();
+        }
+    }
+
+    std::vector<char> file_data;
+    auto const saved = extension(filename, "DDS") ? gli::save_dds(tex, file_data)
+                                                  : gli::save_ktx(tex, file_data);
+    if (!saved) {
+        logger()->error("save compressed texture: {}", filename);
+        return false;
+    }
+
+    file file(filename, file_mode::write);
+    if (!file.opened()
+        || file.write(file_data.data(), file_data.size()) != i64(file_data.size())) {
+        logger()->error("write compressed texture: {}", filename);
+        return false;
+    }
+
+    logger()->trace("texture compressed: {} ({} levels, {} bytes)",
+                    filename, level_count, file_data.size());
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool write_compressed_texture(string_ref filename,
+                              image_data::s_ptr image,
+                              block_format format,
+                              bool srgb,
+                              ui32 thread_count) {
+    if (!image || !image->ready())
+        return false;
+
+    if (image->channels != 4 || image->channel_size != 1) {
+        logger()->error("compress texture: {} channels of {} bytes (RGBA8 expected)",
+                        image->channels, image->channel_size);
+        return false;
+    }
+
+    auto const size = image->dimensions;
+
+    return write_compressed_texture(filename,
+                                    {image->get_data(), size_t(size.x) * size.y * 4},
+                                    size,
+                                    format,
+                                    srgb,
+                                    thread_count);
+}
+
+} // namespace lava
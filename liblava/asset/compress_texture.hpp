@@ -0,0 +1,92 @@
+/**
+ * @file         liblava/asset/compress_texture.hpp
+ * @brief        Block compression of texture data (BCn)
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/image.hpp"
+
+namespace lava {
+
+/**
+ * @brief Block compression formats (BC7 uses mode 6 only)
+ */
+enum class block_format : index {
+    none = 0,
+    bc1,
+    bc3,
+    bc4,
+    bc5,
+    bc7
+};
+
+/**
+ * @brief Get the Vulkan format of a block format
+ * @param format        Block format
+ * @param srgb          Color data is sRGB (bc1, bc3, bc7)
+ * @return VkFormat     Vulkan format
+ */
+VkFormat get_block_format(block_format format,
+                          bool srgb = true);
+
+/**
+ * @brief Get the size of a 4x4 block
+ * @param format    Block format
+ * @return ui32     Size of block in bytes (0: none)
+ */
+ui32 get_block_format_size(block_format format);
+
+/**
+ * @brief Compress RGBA8 pixels into blocks
+ * @note Edge blocks of sizes that are not a multiple of 4 repeat the last pixels,
+ *       palette search uses SSE2 on x86-64
+ * @param pixels          RGBA8 pixel data
+ * @param size            Size of image
+ * @param format          Block format
+ * @param target          Compressed blocks (row by row)
+ * @param thread_count    Number of threads (0: hardware concurrency, small images are compressed on caller)
+ * @return Compress was successful or failed
+ */
+bool compress_image(c_data::ref pixels,
+                    uv2 size,
+                    block_format format,
+                    std::vector<char>& target,
+                    ui32 thread_count = 0);
+
+/**
+ * @brief Compress RGBA8 pixels with full mip chain and write a KTX or DDS file
+ * @note Mip levels are box filtered (in linear space for sRGB, bc4 and bc5 are never sRGB)
+ * @param filename        File to write (.ktx or .dds)
+ * @param pixels          RGBA8 pixel data
+ * @param size            Size of image
+ * @param format          Block format
+ * @param srgb            Color data is sRGB (bc1, bc3, bc7)
+ * @param thread_count    Number of threads (0: hardware concurrency, 1: on caller)
+ * @return Write was successful or failed
+ */
+bool write_compressed_texture(string_ref filename,
+                              c_data::ref pixels,
+                              uv2 size,
+                              block_format format,
+                              bool srgb = true,
+                              ui32 thread_count = 0);
+
+/**
+ * @brief Compress image data with full mip chain and write a KTX or DDS file
+ * @param filename        File to write (.ktx or .dds)
+ * @param image           Image data (RGBA8 only, other layouts fail)
+ * @param format          Block format
+ * @param srgb            Color data is sRGB (bc1, bc3, bc7)
+ * @param thread_count    Number of threads (0: hardware concurrency, 1: on caller)
+ * @return Write was successful or failed
+ */
+bool write_compressed_texture(string_ref filename,
+                              image_data::s_ptr image,
+                              block_format format,
+                              bool srgb = true,
+                              ui32 thread_count = 0);
+
+} // namespace lava
@@ -0,0 +1,459 @@
+/**
+ * @file         liblava/asset/convert_image.cpp
+ * @brief        Pixel format conversion
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/convert_image.hpp"
+#include <array>
+#include <cmath>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define LAVA_CONVERT_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define LAVA_CONVERT_TARGET(isa)
+    #else
+        #define LAVA_CONVERT_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace lava {
+
+namespace {
+
+/// Minimum number of values per thread
+constexpr size_t convert_min_chunk = 1 << 16;
+
+/// Size of sRGB encode table
+constexpr ui32 srgb_encode_size = 4096;
+
+/**
+ * @brief Split a conversion into contiguous chunks over threads
+ * @param count           Number of pixels or values
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ * @param convert         Conversion of range [first, last)
+ */
+void convert_chunks(size_t count,
+                    ui32 thread_count,
+                    auto const& convert) {
+    if (count == 0)
+        return;
+
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    auto const chunk_count = std::clamp(count / convert_min_chunk,
+                                        size_t(1),
+                                        size_t(thread_count));
+
+    if (chunk_count == 1) {
+        convert(size_t(0), count);
+        return;
+    }
+
+    auto const chunk_size = (count + chunk_count - 1) / chunk_count;
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunk_count);
+
+    for (size_t first = 0; first < count; first += chunk_size)
+        threads.emplace_back([&convert, first, last = std::min(first + chunk_size, count)]() {
+            convert(first, last);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+#if LAVA_CONVERT_X86
+
+/// Instruction set extensions for conversion
+enum class convert_isa : ui8 {
+    none = 0,
+    ssse3,
+    avx2,
+};
+
+/**
+ * @brief Get the best instruction set extension of this CPU
+ * @return convert_isa    Supported extension
+ */
+convert_isa get_convert_isa() {
+    static auto const isa = []() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4] = {};
+        __cpuid(info, 0);
+        auto const max_leaf = info[0];
+
+        __cpuid(info, 1);
+        auto const ssse3 = (info[2] & (1 << 9)) != 0;
+        auto const os_avx = (info[2] & (1 << 27)) != 0 // OSXSAVE
+                            && (info[2] & (1 << 28)) != 0 // AVX
+                            && (_xgetbv(0) & 6) == 6; // XMM and YMM state
+
+        auto avx2 = false;
+        if (os_avx && max_leaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+    #else
+        __builtin_cpu_init();
+        auto const ssse3 = __builtin_cpu_supports("ssse3") != 0;
+        auto const avx2 = __builtin_cpu_supports("avx2") != 0;
+    #endif
+
+        if (avx2)
+            return convert_isa::avx2;
+        if (ssse3)
+            return convert_isa::ssse3;
+        return convert_isa::none;
+    }();
+
+    return isa;
+}
+
+/**
+ * @brief Swap red and blue of pixels with AVX2
+ * @param source         Source pixels
+ * @param target         Target pixels
+ * @param pixel_count    Number of pixels
+ * @return size_t        Number of converted pixels
+ */
+LAVA_CONVERT_TARGET("avx2")
+size_t swizzle_avx2(ui8 const* source,
+                    ui8* target,
+                    size_t pixel_count) {
+    auto const mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                       2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        auto const value = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i * 4),
+                            _mm256_shuffle_epi8(value, mask));
+    }
+
+    return i;
+}
+
+/**
+ * @brief Swap red and blue of pixels with SSSE3
+ * @param source         Source pixels
+ * @param target         Target pixels
+ * @param pixel_count    Number of pixels
+ * @return size_t        Number of converted pixels
+ */
+LAVA_CONVERT_TARGET("ssse3")
+size_t swizzle_ssse3(ui8 const* source,
+                     ui8* target,
+                     size_t pixel_count) {
+    auto const mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    size_t i = 0;
+    for (; i + 4 <= pixel_count; i += 4) {
+        auto const value = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 4),
+                         _mm_shuffle_epi8(value, mask));
+    }
+
+    return i;
+}
+
+/**
+ * @brief Pack pixels to RGB with AVX2
+ * @param source         Source pixels
+ * @param target         Target pixels
+ * @param pixel_count    Number of pixels
+ * @param swap_rb        Swap red and blue
+ * @return size_t        Number of converted pixels
+ */
+LAVA_CONVERT_TARGET("avx2")
+size_t pack_avx2(ui8 const* source,
+                 ui8* target,
+                 size_t pixel_count,
+                 bool swap_rb) {
+    auto const mask = swap_rb
+                          ? _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                             2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+                          : _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    auto const lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    // 32-byte store writes 8 bytes past the 8 packed pixels
+    size_t i = 0;
+    for (; i + 11 <= pixel_count; i += 8) {
+        auto const value = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i * 4));
+        auto const packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(value, mask), lanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i * 3), packed);
+    }
+
+    return i;
+}
+
+/**
+ * @brief Pack pixels to RGB with SSSE3
+ * @param source         Source pixels
+ * @param target         Target pixels
+ * @param pixel_count    Number of pixels
+ * @param swap_rb        Swap red and blue
+ * @return size_t        Number of converted pixels
+ */
+LAVA_CONVERT_TARGET("ssse3")
+size_t pack_ssse3(ui8 const* source,
+                  ui8* target,
+                  size_t pixel_count,
+                  bool swap_rb) {
+    auto const mask = swap_rb
+                          ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+                          : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    // 16-byte store writes 4 bytes past the 4 packed pixels
+    size_t i = 0;
+    for (; i + 6 <= pixel_count; i += 4) {
+        auto const value = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 3),
+                         _mm_shuffle_epi8(value, mask));
+    }
+
+    return i;
+}
+
+#endif
+
+/**
+ * @brief Swap red and blue of pixels
+ * @param source         Source pixels
+ * @param target         Target pixels
+ * @param pixel_count    Number of pixels
+ */
+void swizzle_span(ui8 const* source,
+                  ui8* target,
+                  size_t pixel_count) {
+    size_t i = 0;
+
+#if LAVA_CONVERT_X86
+    switch (get_convert_isa()) {
+    case convert_isa::avx2:
+        i = swizzle_avx2(source, target, pixel_count);
+        break;
+    case convert_isa::ssse3:
+        i = swizzle_ssse3(source, target, pixel_count);
+        break;
+    case convert_isa::none:
+        break;
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= pixel_count; i += 16) {
+        auto value = vld4q_u8(source + i * 4);
+        std::swap(value.val[0], value.val[2]);
+        vst4q_u8(target + i * 4, value);
+    }
+#endif
+
+    for (; i < pixel_count; ++i) {
+        auto const r = source[i * 4];
+        target[i * 4] = source[i * 4 + 2];
+        target[i * 4 + 1] = source[i * 4 + 1];
+        target[i * 4 + 2] = r;
+        target[i * 4 + 3] = source[i * 4 + 3];
+    }
+}
+
+/**
+ * @brief Pack pixels to RGB
+ * @param source         Source pixels
+ * @param target         Target pixels
+ * @param pixel_count    Number of pixels
+ * @param swap_rb        Swap red and blue
+ */
+void pack_span(ui8 const* source,
+               ui8* target,
+               size_t pixel_count,
+               bool swap_rb) {
+    size_t i = 0;
+
+#if LAVA_CONVERT_X86
+    switch (get_convert_isa()) {
+    case convert_isa::avx2:
+        i = pack_avx2(source, target, pixel_count, swap_rb);
+        break;
+    case convert_isa::ssse3:
+        i = pack_ssse3(source, target, pixel_count, swap_rb);
+        break;
+    case convert_isa::none:
+        break;
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= pixel_count; i += 16) {
+        auto const value = vld4q_u8(source + i * 4);
+
+        uint8x16x3_t packed;
+        packed.val[0] = swap_rb ? value.val[2] : value.val[0];
+        packed.val[1] = value.val[1];
+        packed.val[2] = swap_rb ? value.val[0] : value.val[2];
+        vst3q_u8(target + i * 3, packed);
+    }
+#endif
+
+    auto const r = swap_rb ? 2 : 0;
+    auto const b = swap_rb ? 0 : 2;
+
+    for (; i < pixel_count; ++i) {
+        target[i * 3] = source[i * 4 + r];
+        target[i * 3 + 1] = source[i * 4 + 1];
+        target[i * 3 + 2] = source[i * 4 + b];
+    }
+}
+
+/**
+ * @brief Get the sRGB decode table
+ * @return r32 const*    Linear value of each 8-bit sRGB value
+ */
+r32 const* get_srgb_decode_table() {
+    static auto const table = []() {
+        std::array<r32, 256> result{};
+        for (auto i = 0u; i < result.size(); ++i) {
+            auto const value = r32(i) / 255.f;
+            result[i] = value <= 0.04045f
+                            ? value / 12.92f
+                            : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+        return result;
+    }();
+
+    return table.data();
+}
+
+/**
+ * @brief Get the sRGB encode table
+ * @return ui8 const*    8-bit sRGB value of each linear step
+ */
+ui8 const* get_srgb_encode_table() {
+    static auto const table = []() {
+        std::array<ui8, srgb_encode_size> result{};
+        for (auto i = 0u; i < result.size(); ++i) {
+            auto const value = r32(i) / (srgb_encode_size - 1);
+            auto const encoded = value <= 0.0031308f
+                                     ? value * 12.92f
+                                     : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+            result[i] = ui8(std::clamp(encoded, 0.f, 1.f) * 255.f + 0.5f);
+        }
+        return result;
+    }();
+
+    return table.data();
+}
+
+/**
+ * @brief Convert a float value to 8-bit unorm
+ * @param value    Float value
+ * @return ui8     Unorm value
+ */
+inline ui8 to_unorm(r32 value) {
+    return ui8(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f);
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+void swizzle_rgba_bgra(ui8 const* source,
+                       ui8* target,
+                       size_t pixel_count,
+                       ui32 thread_count) {
+    convert_chunks(pixel_count, thread_count, [&](size_t first, size_t last) {
+        swizzle_span(source + first * 4, target + first * 4, last - first);
+    });
+}
+
+//-----------------------------------------------------------------------------
+void pack_rgba_rgb(ui8 const* source,
+                   ui8* target,
+                   size_t pixel_count,
+                   bool swap_rb,
+                   ui32 thread_count) {
+    convert_chunks(pixel_count, thread_count, [&](size_t first, size_t last) {
+        pack_span(source + first * 4, target + first * 3, last - first, swap_rb);
+    });
+}
+
+//-----------------------------------------------------------------------------
+void convert_unorm_float(ui8 const* source,
+                         r32* target,
+                         size_t count,
+                         ui32 thread_count) {
+    convert_chunks(count, thread_count, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i)
+            target[i] = source[i] * (1.f / 255.f);
+    });
+}
+
+//-----------------------------------------------------------------------------
+void convert_float_unorm(r32 const* source,
+                         ui8* target,
+                         size_t count,
+                         ui32 thread_count) {
+    convert_chunks(count, thread_count, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i)
+            target[i] = to_unorm(source[i]);
+    });
+}
+
+//-----------------------------------------------------------------------------
+void decode_srgb(ui8 const* source,
+                 r32* target,
+                 size_t pixel_count,
+                 ui32 thread_count) {
+    auto const table = get_srgb_decode_table();
+
+    convert_chunks(pixel_count, thread_count, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i) {
+            target[i * 4] = table[source[i * 4]];
+            target[i * 4 + 1] = table[source[i * 4 + 1]];
+            target[i * 4 + 2] = table[source[i * 4 + 2]];
+            target[i * 4 + 3] = source[i * 4 + 3] * (1.f / 255.f);
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+void encode_srgb(r32 const* source,
+                 ui8* target,
+                 size_t pixel_count,
+                 ui32 thread_count) {
+    auto const table = get_srgb_encode_table();
+
+    auto const encode = [table](r32 value) {
+        return table[ui32(std::clamp(value, 0.f, 1.f) * (srgb_encode_size - 1) + 0.5f)];
+    };
+
+    convert_chunks(pixel_count, thread_count, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i) {
+            target[i * 4] = encode(source[i * 4]);
+            target[i * 4 + 1] = encode(source[i * 4 + 1]);
+            target[i * 4 + 2] = encode(source[i * 4 + 2]);
+            target[i * 4 + 3] = to_unorm(source[i * 4 + 3]);
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+void premultiply_alpha(ui8* pixels,
+                       size_t pixel_count,
+                       ui32 thread_count) {
+    convert_chunks(pixel_count, thread_count, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i) {
+            ui32 const alpha = pixels[i * 4 + 3];
+            pixels[i * 4] = ui8((pixels[i * 4] * alpha + 127) / 255);
+            pixels[i * 4 + 1] = ui8((pixels[i * 4 + 1] * alpha + 127) / 255);
+            pixels[i * 4 + 2] = ui8((pixels[i * 4 + 2] * alpha + 127) / 255);
+        }
+    });
+}
+
+} // namespace lava
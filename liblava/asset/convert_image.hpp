@@ -0,0 +1,102 @@
+/**
+ * @file         liblava/asset/convert_image.hpp
+ * @brief        Pixel format conversion
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/core/types.hpp"
+
+namespace lava {
+
+/**
+ * @brief Swap red and blue of 8-bit RGBA or BGRA pixels
+ * @note Source and target may be the same, large images are split over threads,
+ *       uses AVX2 or SSSE3 when the CPU supports them (no build flags needed)
+ * @param source          Source pixels (4 bytes each)
+ * @param target          Target pixels (4 bytes each)
+ * @param pixel_count     Number of pixels
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ */
+void swizzle_rgba_bgra(ui8 const* source,
+                       ui8* target,
+                       size_t pixel_count,
+                       ui32 thread_count = 0);
+
+/**
+ * @brief Pack 8-bit RGBA pixels to RGB (alpha dropped)
+ * @note Uses AVX2 or SSSE3 when the CPU supports them (no build flags needed)
+ * @param source          Source pixels (4 bytes each)
+ * @param target          Target pixels (3 bytes each)
+ * @param pixel_count     Number of pixels
+ * @param swap_rb         Swap red and blue (BGRA source)
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ */
+void pack_rgba_rgb(ui8 const* source,
+                   ui8* target,
+                   size_t pixel_count,
+                   bool swap_rb = false,
+                   ui32 thread_count = 0);
+
+/**
+ * @brief Convert 8-bit unorm values to float
+ * @param source          Source values
+ * @param target          Target values (0 - 1)
+ * @param count           Number of values
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ */
+void convert_unorm_float(ui8 const* source,
+                         r32* target,
+                         size_t count,
+                         ui32 thread_count = 0);
+
+/**
+ * @brief Convert float values to 8-bit unorm (clamped and rounded)
+ * @param source          Source values
+ * @param target          Target values
+ * @param count           Number of values
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ */
+void convert_float_unorm(r32 const* source,
+                         ui8* target,
+                         size_t count,
+                         ui32 thread_count = 0);
+
+/**
+ * @brief Decode 8-bit sRGB RGBA pixels to linear float (alpha is linear)
+ * @param source          Source pixels (4 bytes each)
+ * @param target          Target pixels (4 floats each)
+ * @param pixel_count     Number of pixels
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ */
+void decode_srgb(ui8 const* source,
+                 r32* target,
+                 size_t pixel_count,
+                 ui32 thread_count = 0);
+
+/**
+ * @brief Encode linear float RGBA pixels to 8-bit sRGB (alpha is linear)
+ * @note Uses a lookup table, the result is within one step of the exact value
+ * @param source          Source pixels (4 floats each)
+ * @param target          Target pixels (4 bytes each)
+ * @param pixel_count     Number of pixels
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ */
+void encode_srgb(r32 const* source,
+                 ui8* target,
+                 size_t pixel_count,
+                 ui32 thread_count = 0);
+
+/**
+ * @brief Premultiply 8-bit RGBA pixels by alpha (in place)
+ * @param pixels          Pixels (4 bytes each)
+ * @param pixel_count     Number of pixels
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ */
+void premultiply_alpha(ui8* pixels,
+                       size_t pixel_count,
+                       ui32 thread_count = 0);
+
+} // namespace lava
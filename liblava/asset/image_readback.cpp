@@ -0,0 +1,253 @@
+/**
+ * @file         liblava/asset/image_readback.cpp
+ * @brief        Asynchronous image readback
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/image_readback.hpp"
+#include "liblava/asset/convert_image.hpp"
+#include "liblava/base/cmd_state.hpp"
+#include "liblava/resource/barrier_batch.hpp"
+#include "liblava/resource/format.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+namespace {
+
+/**
+ * @brief Check if a format can be read back as RGBA8
+ * @param format    Image format
+ * @return Format is supported or not
+ */
+bool readback_format(VkFormat format) {
+    switch (format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
+    case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool image_readback::setup(device::ptr device,
+                           ui32 thread_count,
+                           ui32 max_pending) {
+    if (ready())
+        teardown();
+
+    m_device = device;
+    m_max_pending = std::max(max_pending, 1u);
+
+    m_pool = std::make_unique<thread_pool>();
+    m_pool->setup(std::max(thread_count, 1u));
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void image_readback::teardown() {
+    if (!ready())
+        return;
+
+    flush();
+
+    m_pool->teardown();
+    m_pool = nullptr;
+
+    m_free_buffers.clear();
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+buffer::s_ptr image_readback::acquire_buffer(VkDeviceSize size) {
+    {
+        std::unique_lock<std::mutex> lock(m_free_mutex);
+
+        for (auto it = m_free_buffers.begin(); it != m_free_buffers.end(); ++it) {
+            if ((*it)->get_size() != size)
+                continue;
+
+            auto result = *it;
+            m_free_buffers.erase(it);
+            return result;
+        }
+    }
+
+    auto result = buffer::make();
+    if (!result->create_mapped(m_device,
+                               nullptr,
+                               size,
+                               VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                               VMA_MEMORY_USAGE_GPU_TO_CPU))
+        return nullptr;
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+bool image_readback::record(VkCommandBuffer cmd_buf,
+                            index frame,
+                            image::s_ptr source,
+                            done_func on_done) {
+    if (!ready() || !source)
+        return false;
+
+    mark_cmd_transient();
+
+    auto const format = source->get_format();
+    if (!readback_format(format)) {
+        logger()->error("image readback format: {}", to_ui32(format));
+        return false;
+    }
+
+    if (m_pending >= m_max_pending) {
+        logger()->warn("image readback skipped: {} pending", m_max_pending);
+        return false;
+    }
+
+    auto const layout = source->get_current_layout();
+    if (layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        logger()->error("image readback: source layout undefined");
+        return false;
+    }
+
+    auto const size = source->get_size();
+
+    auto target = acquire_buffer(VkDeviceSize(size.x) * size.y * 4);
+    if (!target) {
+        logger()->error("create image readback buffer");
+        return false;
+    }
+
+    barrier_batch batch(m_device);
+    batch.transition(source,
+                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                     VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                     VK_ACCESS_2_TRANSFER_READ_BIT);
+    batch.flush(cmd_buf);
+
+    VkBufferImageCopy const region{
+        .bufferOffset = 0,
+        .imageSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .imageExtent = {size.x, size.y, 1},
+    };
+
+    m_device->call().vkCmdCopyImageToBuffer(cmd_buf,
+                                            source->get(),
+                                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                            target->get(),
+                                            1,
+                                            &region);
+
+    batch.transition(source,
+                     layout,
+                     VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                     VK_ACCESS_2_MEMORY_READ_BIT);
+    batch.flush(cmd_buf);
+
+    VkBufferMemoryBarrier const host_barrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = target->get(),
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    m_device->call().vkCmdPipelineBarrier(cmd_buf,
+                                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                          VK_PIPELINE_STAGE_HOST_BIT,
+                                          0,
+                                          0, nullptr,
+                                          1, &host_barrier,
+                                          0, nullptr);
+
+    m_recorded[frame].push_back({
+        .buffer = target,
+        .size = size,
+        .format = format,
+        .on_done = on_done,
+    });
+
+    ++m_pending;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void image_readback::update(index frame) {
+    if (!ready() || !m_recorded.count(frame))
+        return;
+
+    for (auto& item : m_recorded.at(frame)) {
+        m_pool->enqueue([&, item = std::move(item)](id::ref) {
+            process(item);
+
+            --m_pending;
+        });
+    }
+
+    m_recorded.erase(frame);
+}
+
+//-----------------------------------------------------------------------------
+void image_readback::flush() {
+    if (!ready())
+        return;
+
+    while (!m_recorded.empty())
+        update(m_recorded.begin()->first);
+
+    m_pool->wait();
+}
+
+//-----------------------------------------------------------------------------
+void image_readback::process(readback const& item) {
+    item.buffer->invalidate();
+
+    auto const pixel_count = size_t(item.size.x) * item.size.y;
+
+    auto result = std::make_shared<image_data>();
+    result->set_data(data::as_ptr(malloc(pixel_count * 4)));
+
+    if (result->ready()) {
+        result->dimensions = item.size;
+        result->channels = 4;
+
+        auto const source = static_cast<ui8 const*>(item.buffer->get_mapped_data());
+        auto target = reinterpret_cast<ui8*>(result->get_data());
+
+        if (format_bgr(item.format))
+            swizzle_rgba_bgra(source, target, pixel_count);
+        else
+            memcpy(target, source, pixel_count * 4);
+    } else {
+        result = nullptr;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_free_mutex);
+        m_free_buffers.push_back(item.buffer);
+    }
+
+    if (item.on_done)
+        item.on_done(result);
+}
+
+} // namespace lava
@@ -0,0 +1,145 @@
+/**
+ * @file         liblava/asset/image_readback.hpp
+ * @brief        Asynchronous image readback
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/buffer.hpp"
+#include "liblava/resource/image.hpp"
+#include "liblava/util/thread.hpp"
+
+namespace lava {
+
+/**
+ * @brief Image readback (copy in frame, convert on worker threads)
+ * @note Host visible buffers are recycled, so continuous readbacks run on a ring,
+ *       completion order is only guaranteed with a single worker thread
+ */
+struct image_readback {
+    /// Pointer to image readback
+    using ptr = image_readback*;
+
+    /// Readback done function (called on worker thread, nullptr: readback failed)
+    using done_func = std::function<void(image_data::s_ptr)>;
+
+    /**
+     * @brief Destroy the image readback
+     */
+    ~image_readback() {
+        teardown();
+    }
+
+    /**
+     * @brief Set up the image readback
+     * @note Readbacks complete in record order only with one worker thread,
+     *       more workers run done functions concurrently and out of order
+     * @param device          Vulkan device
+     * @param thread_count    Number of worker threads (1: ordered completion)
+     * @param max_pending     Maximum number of readbacks in flight (record fails above)
+     * @return Setup was successful or failed
+     */
+    bool setup(device::ptr device,
+               ui32 thread_count = 1,
+               ui32 max_pending = 16);
+
+    /**
+     * @brief Tear down the image readback (pending readbacks are completed)
+     * @note Device must be idle
+     */
+    void teardown();
+
+    /**
+     * @brief Record a readback of an image into the frame
+     * @note Record after the last write of the image, only 8-bit RGBA and BGRA formats are converted
+     * @param cmd_buf    Command buffer of frame
+     * @param frame      Frame index
+     * @param source     Source image (first level and layer, tracked layout is restored)
+     * @param on_done    Called on worker thread with RGBA8 image data
+     * @return Record was successful or failed
+     */
+    bool record(VkCommandBuffer cmd_buf,
+                index frame,
+                image::s_ptr source,
+                done_func on_done);
+
+    /**
+     * @brief Hand finished readbacks of a frame to the workers
+     * @note Call when the frame is done on device, before recording it again
+     * @param frame    Frame index
+     */
+    void update(index frame);
+
+    /**
+     * @brief Complete all recorded readbacks
+     * @note Device must be idle
+     */
+    void flush();
+
+    /**
+     * @brief Check if the image readback is set up
+     * @return Image readback is ready or not
+     */
+    bool ready() const {
+        return m_pool != nullptr;
+    }
+
+private:
+    /**
+     * @brief Recorded readback
+     */
+    struct readback {
+        /// List of readbacks
+        using list = std::vector<readback>;
+
+        /// Host visible copy
+        buffer::s_ptr buffer;
+
+        /// Size of image
+        uv2 size = {};
+
+        /// Format of image
+        VkFormat format = VK_FORMAT_UNDEFINED;
+
+        /// Done function
+        done_func on_done;
+    };
+
+    /**
+     * @brief Convert a finished readback and return its buffer (worker thread)
+     * @param item    Finished readback
+     */
+    void process(readback const& item);
+
+    /**
+     * @brief Get a free buffer or create a new one
+     * @param size    Buffer size
+     * @return buffer::s_ptr    Host visible buffer (nullptr: failed)
+     */
+    buffer::s_ptr acquire_buffer(VkDeviceSize size);
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Worker threads
+    std::unique_ptr<thread_pool> m_pool;
+
+    /// Map of recorded readbacks by frame index
+    std::map<index, readback::list> m_recorded;
+
+    /// Free host visible buffers
+    buffer::s_list m_free_buffers;
+
+    /// Free buffers mutex
+    std::mutex m_free_mutex;
+
+    /// Number of recorded and unfinished readbacks
+    std::atomic<ui32> m_pending = 0;
+
+    /// Maximum number of readbacks in flight
+    ui32 m_max_pending = 16;
+};
+
+} // namespace lava
@@ -0,0 +1,1230 @@
+/**
+ * @file         liblava/asset/load_gltf.cpp
+ * @brief        Load glTF 2.0 model from file
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/load_gltf.hpp"
+#include "liblava/file.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtc/type_ptr.hpp"
+#include <set>
+
+namespace lava {
+
+namespace {
+
+/// glTF binary magic ("glTF")
+constexpr ui32 glb_magic = 0x46546C67;
+
+/// glTF binary chunk type json ("JSON")
+constexpr ui32 glb_chunk_json = 0x4E4F534A;
+
+/// glTF binary chunk type binary ("BIN")
+constexpr ui32 glb_chunk_bin = 0x004E4942;
+
+/**
+ * @brief glTF accessor component types
+ */
+enum gltf_component : ui32 {
+    gltf_byte = 5120,
+    gltf_unsigned_byte = 5121,
+    gltf_short = 5122,
+    gltf_unsigned_short = 5123,
+    gltf_unsigned_int = 5125,
+    gltf_float = 5126,
+};
+
+/// glTF primitive mode triangles
+constexpr ui32 gltf_mode_triangles = 4;
+
+/**
+ * @brief Resolved glTF accessor
+ */
+struct accessor_view {
+    /// Pointer to first element
+    data::c_ptr addr = nullptr;
+
+    /// Distance between elements in bytes
+    size_t stride = 0;
+
+    /// Number of elements
+    size_t count = 0;
+
+    /// Component type
+    ui32 component_type = 0;
+
+    /// Components per element
+    ui32 components = 0;
+
+    /// Normalized integer components
+    bool normalized = false;
+
+    /**
+     * @brief Check if the accessor is valid
+     * @return Accessor is valid or not
+     */
+    bool valid() const {
+        return addr != nullptr;
+    }
+
+    /**
+     * @brief Check if elements are tightly packed
+     * @return Elements are tightly packed or not
+     */
+    bool packed() const {
+        return stride == component_size(component_type) * components;
+    }
+
+    /**
+     * @brief Get size of a component type
+     * @param type       Component type
+     * @return size_t    Size in bytes
+     */
+    static size_t component_size(ui32 type) {
+        switch (type) {
+        case gltf_byte:
+        case gltf_unsigned_byte:
+            return 1;
+        case gltf_short:
+        case gltf_unsigned_short:
+            return 2;
+        case gltf_unsigned_int:
+        case gltf_float:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Read a component as float
+     * @param element      Element index
+     * @param component    Component index
+     * @return r32         Component value
+     */
+    r32 read_float(size_t element, ui32 component) const {
+        auto src = addr + element * stride
+                   + component * component_size(component_type);
+
+        switch (component_type) {
+        case gltf_float: {
+            r32 value;
+            memcpy(&value, src, sizeof(value));
+            return value;
+        }
+        case gltf_unsigned_byte: {
+            auto value = *reinterpret_cast<ui8 const*>(src);
+            return normalized ? value / 255.f : value;
+        }
+        case gltf_byte: {
+            auto value = *reinterpret_cast<i8 const*>(src);
+            return normalized ? std::max(value / 127.f, -1.f) : value;
+        }
+        case gltf_unsigned_short: {
+            ui16 value;
+            memcpy(&value, src, sizeof(value));
+            return normalized ? value / 65535.f : value;
+        }
+        case gltf_short: {
+            i16 value;
+            memcpy(&value, src, sizeof(value));
+            return normalized ? std::max(value / 32767.f, -1.f) : value;
+        }
+        case gltf_unsigned_int: {
+            ui32 value;
+            memcpy(&value, src, sizeof(value));
+            return r32(value);
+        }
+        default:
+            return 0.f;
+        }
+    }
+
+    /**
+     * @brief Read an element as index
+     * @param element    Element index
+     * @return ui32      Index value
+     */
+    ui32 read_index(size_t element) const {
+        auto src = addr + element * stride;
+
+        switch (component_type) {
+        case gltf_unsigned_byte:
+            return *reinterpret_cast<ui8 const*>(src);
+        case gltf_unsigned_short: {
+            ui16 value;
+            memcpy(&value, src, sizeof(value));
+            return value;
+        }
+        case gltf_unsigned_int: {
+            ui32 value;
+            memcpy(&value, src, sizeof(value));
+            return value;
+        }
+        default:
+            return 0;
+        }
+    }
+};
+
+/**
+ * @brief Get number of components by accessor type
+ * @param type    Accessor type
+ * @return ui32   Number of components
+ */
+ui32 accessor_components(string_ref type) {
+    if (type == "SCALAR")
+        return 1;
+    if (type == "VEC2")
+        return 2;
+    if (type == "VEC3")
+        return 3;
+    if (type == "VEC4" || type == "MAT2")
+        return 4;
+    if (type == "MAT3")
+        return 9;
+    if (type == "MAT4")
+        return 16;
+    return 0;
+}
+
+/**
+ * @brief Decode base64 data
+ * @param source    Base64 encoded string
+ * @param target    Decoded data
+ * @return Decode was successful or failed
+ */
+bool decode_base64(std::string_view source, u_data& target) {
+    auto decode = [](char c) -> i32 {
+        if (c >= 'A' && c <= 'Z')
+            return c - 'A';
+        if (c >= 'a' && c <= 'z')
+            return c - 'a' + 26;
+        if (c >= '0' && c <= '9')
+            return c - '0' + 52;
+        if (c == '+')
+            return 62;
+        if (c == '/')
+            return 63;
+        return -1;
+    };
+
+    while (!source.empty() && source.back() == '=')
+        source.remove_suffix(1);
+
+    if (!target.set((source.size() * 3) / 4))
+        return false;
+
+    auto out = target.addr;
+    ui32 bits = 0;
+    i32 bit_count = 0;
+    for (auto c : source) {
+        auto value = decode(c);
+        if (value < 0)
+            return false;
+
+        bits = (bits << 6) | ui32(value);
+        bit_count += 6;
+        if (bit_count >= 8) {
+            bit_count -= 8;
+            *out++ = char((bits >> bit_count) & 0xFF);
+        }
+    }
+
+    target.size = out - target.addr;
+    return true;
+}
+
+/**
+ * @brief Get a member of a json object
+ * @param object          Json object
+ * @param key             Member name
+ * @return json const*    Member (nullptr: missing)
+ */
+json const* get_member(json const& object,
+                       name key) {
+    if (!object.is_object())
+        return nullptr;
+
+    auto const it = object.find(key);
+    return it != object.end() ? &*it : nullptr;
+}
+
+/**
+ * @brief Get the size of an array member
+ * @param object     Json object
+ * @param key        Member name
+ * @return size_t    Number of elements (0: missing or no array)
+ */
+size_t array_size(json const& object,
+                  name key) {
+    auto const member = get_member(object, key);
+    return member && member->is_array() ? member->size() : 0;
+}
+
+/**
+ * @brief Read an optional unsigned integer member
+ * @param object    Json object
+ * @param key       Member name
+ * @param result    Value (unchanged if missing)
+ * @return Member is missing or an unsigned integer
+ */
+bool read_size(json const& object,
+               name key,
+               size_t& result) {
+    auto const member = get_member(object, key);
+    if (!member)
+        return true;
+
+    if (!member->is_number_unsigned())
+        return false;
+
+    result = member->get<size_t>();
+    return true;
+}
+
+/**
+ * @brief Read an index member
+ * @param object    Json object
+ * @param key       Member name
+ * @param count     Number of valid indices
+ * @param result    Index value
+ * @return Member is a valid index or not
+ */
+bool read_index(json const& object,
+                name key,
+                size_t count,
+                index& result) {
+    auto const member = get_member(object, key);
+    if (!member || !member->is_number_unsigned())
+        return false;
+
+    auto const value = member->get<size_t>();
+    if (value >= count)
+        return false;
+
+    result = index(value);
+    return true;
+}
+
+/**
+ * @brief Read an index element
+ * @param value     Json value
+ * @param count     Number of valid indices
+ * @param result    Index value
+ * @return Element is a valid index or not
+ */
+bool read_index(json const& value,
+                size_t count,
+                index& result) {
+    if (!value.is_number_unsigned() || value.get<size_t>() >= count)
+        return false;
+
+    result = index(value.get<size_t>());
+    return true;
+}
+
+/**
+ * @brief Read a number member
+ * @param object      Json object
+ * @param key         Member name
+ * @param fallback    Value if missing or no number
+ * @return r32        Value
+ */
+r32 read_number(json const& object,
+                name key,
+                r32 fallback) {
+    auto const member = get_member(object, key);
+    return member && member->is_number() ? member->get<r32>() : fallback;
+}
+
+/**
+ * @brief Read a string member
+ * @param object     Json object
+ * @param key        Member name
+ * @return string    Value (empty: missing or no string)
+ */
+string read_string(json const& object,
+                   name key) {
+    auto const member = get_member(object, key);
+    return member && member->is_string() ? member->get<string>() : string();
+}
+
+/**
+ * @brief Read a number array member
+ * @param object    Json object
+ * @param key       Member name
+ * @param result    Target values
+ * @param count     Number of values
+ * @return Member is an array of count numbers or not
+ */
+bool read_numbers(json const& object,
+                  name key,
+                  r32* result,
+                  size_t count) {
+    auto const member = get_member(object, key);
+    if (!member || !member->is_array() || member->size() != count)
+        return false;
+
+    for (auto i = 0u; i < count; ++i) {
+        if (!(*member)[i].is_number())
+            return false;
+
+        result[i] = (*member)[i].get<r32>();
+    }
+
+    return true;
+}
+
+/// Maximum byte stride of a buffer view
+constexpr size_t max_byte_stride = 252;
+
+/**
+ * @brief glTF document with resolved buffers
+ */
+struct gltf_document {
+    /// Json document
+    json j;
+
+    /// Base path for external resources
+    std::filesystem::path base_path;
+
+    /// Owned buffer storage
+    std::deque<u_data> storage;
+
+    /// Buffers (views into storage)
+    std::vector<c_data> buffers;
+
+    /**
+     * @brief Resolve an accessor
+     * @param idx               Accessor index
+     * @return accessor_view    Resolved accessor (invalid on error)
+     */
+    accessor_view get_accessor(index idx) const {
+        accessor_view result;
+
+        if (idx >= array_size(j, "accessors")) {
+            logger()->error("gltf accessor {} out of range", idx);
+            return result;
+        }
+
+        auto const& accessor = j["accessors"][idx];
+        if (get_member(accessor, "sparse")) {
+            logger()->warn("gltf sparse accessors not supported");
+            return result;
+        }
+
+        index view_index = 0;
+        if (!read_index(accessor, "bufferView", array_size(j, "bufferViews"), view_index)) {
+            logger()->error("gltf accessor {} with invalid buffer view", idx);
+            return result;
+        }
+
+        auto const& view = j["bufferViews"][view_index];
+
+        index buffer_index = 0;
+        if (!read_index(view, "buffer", buffers.size(), buffer_index)) {
+            logger()->error("gltf buffer view {} with invalid buffer", view_index);
+            return result;
+        }
+
+        size_t component_type = 0;
+        size_t count = 0;
+        size_t view_offset = 0;
+        size_t view_length = 0;
+        size_t accessor_offset = 0;
+        if (!read_size(accessor, "componentType", component_type)
+            || !read_size(accessor, "count", count)
+            || !read_size(view, "byteOffset", view_offset)
+            || !read_size(view, "byteLength", view_length)
+            || !read_size(accessor, "byteOffset", accessor_offset)) {
+            logger()->error("gltf accessor {} with invalid values", idx);
+            return result;
+        }
+
+        auto const normalized = get_member(accessor, "normalized");
+        result.component_type = ui32(std::min(component_type, size_t(no_index)));
+        result.components = accessor_components(read_string(accessor, "type"));
+        result.count = count;
+        result.normalized = normalized && normalized->is_boolean() && normalized->get<bool>();
+
+        auto element_size = accessor_view::component_size(result.component_type)
+                            * result.components;
+        if (element_size == 0) {
+            logger()->error("gltf accessor {} with invalid type", idx);
+            return result;
+        }
+
+        result.stride = element_size;
+        if (!read_size(view, "byteStride", result.stride)
+            || (result.stride < element_size)
+            || (result.stride > max_byte_stride)) {
+            logger()->error("gltf buffer view {} with invalid stride", view_index);
+            return result;
+        }
+
+        auto const& buffer = buffers.at(buffer_index);
+        if (!get_member(view, "byteLength") && (view_offset <= buffer.size))
+            view_length = buffer.size - view_offset;
+
+        if ((view_offset > buffer.size) || (view_length > buffer.size - view_offset)) {
+            logger()->error("gltf buffer view {} out of bounds", view_index);
+            return result;
+        }
+
+        // count is bounded by the view length before it is multiplied
+        if ((accessor_offset > view_length)
+            || ((count > 0)
+                && ((count > view_length)
+                    || ((count - 1) * result.stride + element_size > view_length - accessor_offset)))) {
+            logger()->error("gltf accessor {} out of bounds", idx);
+            return result;
+        }
+
+        result.addr = buffer.addr + view_offset + accessor_offset;
+        return result;
+    }
+
+    /**
+     * @brief Load the buffers of the document
+     * @param glb_bin    Binary chunk of glb file
+     * @return Load was successful or failed
+     */
+    bool load_buffers(c_data glb_bin) {
+        auto const count = array_size(j, "buffers");
+        for (auto i = 0u; i < count; ++i) {
+            auto const& buffer = j["buffers"][i];
+
+            if (!buffer.is_object()) {
+                logger()->error("gltf buffer {} invalid", i);
+                return false;
+            }
+
+            auto const uri_member = get_member(buffer, "uri");
+            if (!uri_member) {
+                if (!glb_bin.addr) {
+                    logger()->error("gltf buffer without uri");
+                    return false;
+                }
+
+                buffers.push_back(glb_bin);
+                continue;
+            }
+
+            if (!uri_member->is_string()) {
+                logger()->error("gltf buffer {} with invalid uri", i);
+                return false;
+            }
+
+            auto uri = uri_member->get<string>();
+            auto& target = storage.emplace_back();
+
+            if (uri.starts_with("data:")) {
+                auto pos = uri.find(";base64,");
+                if (pos == string::npos
+                    || !decode_base64(std::string_view(uri).substr(pos + 8), target)) {
+                    logger()->error("gltf decode buffer data uri");
+                    return false;
+                }
+            } else {
+                auto path = (base_path / uri).generic_string();
+                if (!load_file_data(path, target)) {
+                    logger()->error("gltf load buffer {}", path);
+                    return false;
+                }
+            }
+
+            buffers.push_back(c_data(target.addr, target.size));
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Get texture file of a texture info
+     * @param info             Texture info
+     * @param format           Texture format
+     * @param result           Texture file (empty path: none)
+     * @return Texture info is valid or not
+     */
+    bool get_texture_file(json const& info,
+                          VkFormat format,
+                          texture_file& result) const {
+        result.format = format;
+
+        index texture_index = 0;
+        if (!read_index(info, "index", array_size(j, "textures"), texture_index)) {
+            logger()->error("gltf texture info with invalid index");
+            return false;
+        }
+
+        auto const& texture = j["textures"][texture_index];
+        if (!get_member(texture, "source"))
+            return true;
+
+        index image_index = 0;
+        if (!read_index(texture, "source", array_size(j, "images"), image_index)) {
+            logger()->error("gltf texture {} with invalid source", texture_index);
+            return false;
+        }
+
+        auto uri = read_string(j["images"][image_index], "uri");
+        if (uri.empty()) {
+            logger()->debug("gltf embedded image skipped");
+            return true;
+        }
+
+        if (uri.starts_with("data:")) {
+            logger()->debug("gltf data uri image skipped");
+            return true;
+        }
+
+        result.path = (base_path / uri).generic_string();
+        return true;
+    }
+};
+
+/**
+ * @brief Parse a glTF or glb file
+ * @param file_data   File data
+ * @param base_path   Base path for external resources
+ * @param doc         Target document
+ * @return Parse was successful or failed
+ */
+bool parse_document(c_data::ref file_data,
+                    string_ref base_path,
+                    gltf_document& doc) {
+    doc.base_path = base_path;
+
+    c_data json_chunk(file_data.addr, file_data.size);
+    c_data bin_chunk;
+
+    ui32 magic = 0;
+    if (file_data.size >= 12)
+        memcpy(&magic, file_data.addr, sizeof(magic));
+
+    if (magic == glb_magic) {
+        ui32 header[3];
+        memcpy(header, file_data.addr, sizeof(header));
+        if (header[1] != 2) {
+            logger()->error("glb version {} not supported", header[1]);
+            return false;
+        }
+
+        json_chunk = {};
+
+        auto length = std::min(size_t(header[2]), file_data.size);
+        size_t offset = sizeof(header);
+        while (offset + 8 <= length) {
+            ui32 chunk[2];
+            memcpy(chunk, file_data.addr + offset, sizeof(chunk));
+            offset += sizeof(chunk);
+
+            if (offset + chunk[0] > length)
+                break;
+
+            if (chunk[1] == glb_chunk_json)
+                json_chunk = c_data(file_data.addr + offset, chunk[0]);
+            else if (chunk[1] == glb_chunk_bin && !bin_chunk.addr)
+                bin_chunk = c_data(file_data.addr + offset, chunk[0]);
+
+            offset += align_up(chunk[0], 4u);
+        }
+
+        if (!json_chunk.addr) {
+            logger()->error("glb without json chunk");
+            return false;
+        }
+    }
+
+    doc.j = json::parse(json_chunk.addr,
+                        json_chunk.addr + json_chunk.size,
+                        nullptr, false);
+    if (doc.j.is_discarded() || !doc.j.is_object()) {
+        logger()->error("gltf parse json");
+        return false;
+    }
+
+    auto const asset = get_member(doc.j, "asset");
+    auto version = asset ? read_string(*asset, "version") : string();
+    if (!version.starts_with("2.")) {
+        logger()->error("gltf version {} not supported", version);
+        return false;
+    }
+
+    return doc.load_buffers(bin_chunk);
+}
+
+/**
+ * @brief Check if an interleaved accessor matches the vertex layout
+ * @param doc          glTF document
+ * @param attributes   Primitive attributes
+ * @param count        Number of vertices
+ * @return Layout matches vertex or not
+ */
+bool matches_vertex_layout(gltf_document const& doc,
+                           json const& attributes,
+                           size_t count) {
+    struct layout_attribute {
+        name attribute;
+        size_t offset;
+        ui32 components;
+    };
+
+    std::array<layout_attribute, 4> const layout = {{
+        {"POSITION", offsetof(vertex, position), 3},
+        {"COLOR_0", offsetof(vertex, color), 4},
+        {"TEXCOORD_0", offsetof(vertex, uv), 2},
+        {"NORMAL", offsetof(vertex, normal), 3},
+    }};
+
+    data::c_ptr base = nullptr;
+    for (auto const& attr : layout) {
+        index accessor_index = 0;
+        if (!read_index(attributes, attr.attribute,
+                        array_size(doc.j, "accessors"), accessor_index))
+            return false;
+
+        auto view = doc.get_accessor(accessor_index);
+        if (!view.valid()
+            || view.count != count
+            || view.stride != sizeof(vertex)
+            || view.component_type != gltf_float
+            || view.components != attr.components)
+            return false;
+
+        if (!base)
+            base = view.addr - attr.offset;
+        else if (view.addr != base + attr.offset)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Load a glTF primitive into mesh data
+ * @note Unsupported primitives leave the mesh empty
+ * @param doc          glTF document
+ * @param primitive    Primitive json
+ * @param target       Target mesh
+ * @return Load was successful or failed
+ */
+bool load_primitive(gltf_document const& doc,
+                    json const& primitive,
+                    mesh::s_ptr const& target) {
+    size_t mode = gltf_mode_triangles;
+    if (!read_size(primitive, "mode", mode)) {
+        logger()->error("gltf primitive with invalid mode");
+        return false;
+    }
+
+    if (mode != gltf_mode_triangles) {
+        logger()->warn("gltf primitive mode {} skipped", mode);
+        return true;
+    }
+
+    auto const attributes_member = get_member(primitive, "attributes");
+    if (!attributes_member || !attributes_member->is_object()) {
+        logger()->error("gltf primitive without attributes");
+        return false;
+    }
+
+    auto const& attributes = *attributes_member;
+    auto const accessor_count = array_size(doc.j, "accessors");
+
+    index position_index = 0;
+    if (!read_index(attributes, "POSITION", accessor_count, position_index)) {
+        logger()->error("gltf primitive with invalid position accessor");
+        return false;
+    }
+
+    auto positions = doc.get_accessor(position_index);
+    if (!positions.valid() || positions.components != 3)
+        return false;
+
+    auto& vertices = target->get_vertices();
+
+    if (matches_vertex_layout(doc, attributes, positions.count)) {
+        // interleaved data matches vertex: copy all at once,
+        // mesh data stays on the host for merge and reload
+        vertices.resize(positions.count);
+        memcpy(vertices.data(),
+               positions.addr - offsetof(vertex, position),
+               positions.count * sizeof(vertex));
+    } else {
+        vertices.resize(positions.count);
+
+        auto valid = true;
+
+        // write each attribute straight into the mesh vertices
+        auto fill = [&](name attribute,
+                        ui32 min_components,
+                        auto&& write) {
+            if (!get_member(attributes, attribute))
+                return false;
+
+            index accessor_index = 0;
+            if (!read_index(attributes, attribute, accessor_count, accessor_index)) {
+                logger()->error("gltf primitive with invalid {} accessor", attribute);
+                valid = false;
+                return false;
+            }
+
+            auto view = doc.get_accessor(accessor_index);
+            if (!view.valid() || view.count < vertices.size()
+                || view.components < min_components) {
+                logger()->error("gltf primitive with invalid {} data", attribute);
+                valid = false;
+                return false;
+            }
+
+            if (view.component_type == gltf_float && view.packed()) {
+                for (auto i = 0u; i < vertices.size(); ++i)
+                    write(vertices[i],
+                          reinterpret_cast<r32 const*>(view.addr + i * view.stride),
+                          view.components);
+            } else {
+                std::array<r32, 4> values{};
+                for (auto i = 0u; i < vertices.size(); ++i) {
+                    for (auto c = 0u; c < std::min(view.components, 4u); ++c)
+                        values[c] = view.read_float(i, c);
+
+                    write(vertices[i], values.data(), view.components);
+                }
+            }
+
+            return true;
+        };
+
+        fill("POSITION", 3, [](vertex& v, r32 const* values, ui32) {
+            memcpy(&v.position, values, sizeof(v.position));
+        });
+
+        if (!fill("COLOR_0", 3, [](vertex& v, r32 const* values, ui32 components) {
+                v.color = v4(values[0], values[1], values[2],
+                             components > 3 ? values[3] : 1.f);
+            })) {
+            for (auto& v : vertices)
+                v.color = v4(1.f);
+        }
+
+        if (!fill("TEXCOORD_0", 2, [](vertex& v, r32 const* values, ui32) {
+                memcpy(&v.uv, values, sizeof(v.uv));
+            })) {
+            for (auto& v : vertices)
+                v.uv = v2(0.f);
+        }
+
+        if (!fill("NORMAL", 3, [](vertex& v, r32 const* values, ui32) {
+                memcpy(&v.normal, values, sizeof(v.normal));
+            })) {
+            for (auto& v : vertices)
+                v.normal = v3(0.f);
+        }
+
+        if (!valid)
+            return false;
+    }
+
+    if (get_member(primitive, "indices")) {
+        index indices_index = 0;
+        if (!read_index(primitive, "indices", accessor_count, indices_index)) {
+            logger()->error("gltf primitive with invalid indices accessor");
+            return false;
+        }
+
+        auto view = doc.get_accessor(indices_index);
+        if (!view.valid() || view.components != 1
+            || (view.component_type != gltf_unsigned_byte
+                && view.component_type != gltf_unsigned_short
+                && view.component_type != gltf_unsigned_int)) {
+            logger()->error("gltf primitive with invalid indices");
+            return false;
+        }
+
+        auto& indices = target->get_indices();
+        indices.resize(view.count);
+
+        if (view.component_type == gltf_unsigned_int && view.packed()) {
+            memcpy(indices.data(), view.addr, view.count * sizeof(ui32));
+        } else {
+            for (auto i = 0u; i < view.count; ++i)
+                indices[i] = view.read_index(i);
+        }
+
+        auto const vertex_count = vertices.size();
+        auto const out_of_range = std::any_of(indices.begin(), indices.end(), [&](ui32 value) {
+            return value >= vertex_count;
+        });
+        if (out_of_range) {
+            logger()->error("gltf primitive index out of range ({} vertices)", vertex_count);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get local transform of a node
+ * @param node     Node json
+ * @param result   Local transform
+ * @return Transform is valid or not
+ */
+bool node_transform(json const& node,
+                    mat4& result) {
+    if (get_member(node, "matrix")) {
+        std::array<r32, 16> m{};
+        if (!read_numbers(node, "matrix", m.data(), m.size()))
+            return false;
+
+        for (auto i = 0u; i < 16; ++i)
+            result[i / 4][i % 4] = m[i];
+        return true;
+    }
+
+    result = mat4(1.f);
+
+    if (get_member(node, "translation")) {
+        v3 t;
+        if (!read_numbers(node, "translation", glm::value_ptr(t), 3))
+            return false;
+
+        result = glm::translate(result, t);
+    }
+
+    if (get_member(node, "rotation")) {
+        v4 r;
+        if (!read_numbers(node, "rotation", glm::value_ptr(r), 4))
+            return false;
+
+        result *= glm::mat4_cast(glm::quat(r.w, r.x, r.y, r.z));
+    }
+
+    if (get_member(node, "scale")) {
+        v3 s;
+        if (!read_numbers(node, "scale", glm::value_ptr(s), 3))
+            return false;
+
+        result = glm::scale(result, s);
+    }
+
+    return true;
+}
+
+/**
+ * @brief glTF scene loader
+ */
+struct gltf_loader {
+    /// glTF document
+    gltf_document const& doc;
+
+    /// Target model
+    gltf_model::s_ptr model;
+
+    /// Loaded meshes per glTF mesh (one per primitive)
+    std::map<index, std::vector<std::pair<mesh::s_ptr, index>>> meshes;
+
+    /// Invalid data found
+    bool failed = false;
+
+    /**
+     * @brief Get the primitives of a glTF mesh
+     * @param mesh_index    Index of glTF mesh
+     * @return List of meshes with material index
+     */
+    std::vector<std::pair<mesh::s_ptr, index>> const& get_mesh(index mesh_index) {
+        if (auto it = meshes.find(mesh_index); it != meshes.end())
+            return it->second;
+
+        auto& result = meshes[mesh_index];
+
+        auto const& gltf_mesh = doc.j["meshes"][mesh_index];
+        auto const count = array_size(gltf_mesh, "primitives");
+        if (count == 0) {
+            logger()->error("gltf mesh {} without primitives", mesh_index);
+            failed = true;
+            return result;
+        }
+
+        for (auto i = 0u; i < count; ++i) {
+            auto const& primitive = gltf_mesh["primitives"][i];
+
+            auto material = no_index;
+            if (get_member(primitive, "material")
+                && !read_index(primitive, "material", model->materials.size(), material)) {
+                logger()->error("gltf mesh {} with invalid material", mesh_index);
+                failed = true;
+                return result;
+            }
+
+            auto primitive_mesh = mesh::make();
+            if (!load_primitive(doc, primitive, primitive_mesh)) {
+                failed = true;
+                return result;
+            }
+
+            if (!primitive_mesh->empty())
+                result.emplace_back(primitive_mesh, material);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Add a node and its children
+     * @param node_index    Index of node
+     * @param parent        Parent transform
+     * @param depth         Recursion depth
+     */
+    void add_node(index node_index,
+                  mat4 const& parent,
+                  ui32 depth = 0) {
+        if (depth > 64) {
+            logger()->error("gltf node hierarchy too deep");
+            failed = true;
+            return;
+        }
+
+        auto const& node = doc.j["nodes"][node_index];
+
+        mat4 local(1.f);
+        if (!node_transform(node, local)) {
+            logger()->error("gltf node {} with invalid transform", node_index);
+            failed = true;
+            return;
+        }
+
+        auto transform = parent * local;
+
+        if (get_member(node, "mesh")) {
+            index mesh_index = 0;
+            if (!read_index(node, "mesh", array_size(doc.j, "meshes"), mesh_index)) {
+                logger()->error("gltf node {} with invalid mesh", node_index);
+                failed = true;
+                return;
+            }
+
+            for (auto const& [primitive_mesh, material] : get_mesh(mesh_index))
+                model->primitives.push_back({primitive_mesh, material, transform});
+        }
+
+        auto const node_count = array_size(doc.j, "nodes");
+        auto const child_count = array_size(node, "children");
+        for (auto i = 0u; i < child_count && !failed; ++i) {
+            index child = 0;
+            if (!read_index(node["children"][i], node_count, child)) {
+                logger()->error("gltf node {} with invalid child", node_index);
+                failed = true;
+                return;
+            }
+
+            add_node(child, transform, depth + 1);
+        }
+    }
+
+    /**
+     * @brief Add all primitives of the default scene
+     */
+    void add_scene() {
+        auto const& j = doc.j;
+
+        auto const scene_count = array_size(j, "scenes");
+        if (scene_count > 0) {
+            index scene_index = 0;
+            if (get_member(j, "scene")
+                && !read_index(j, "scene", scene_count, scene_index)) {
+                logger()->error("gltf with invalid default scene");
+                failed = true;
+                return;
+            }
+
+            auto const& scene = j["scenes"][scene_index];
+            auto const node_count = array_size(j, "nodes");
+            auto const root_count = array_size(scene, "nodes");
+            for (auto i = 0u; i < root_count && !failed; ++i) {
+                index node_index = 0;
+                if (!read_index(scene["nodes"][i], node_count, node_index)) {
+                    logger()->error("gltf scene {} with invalid node", scene_index);
+                    failed = true;
+                    return;
+                }
+
+                add_node(node_index, mat4(1.f));
+            }
+            return;
+        }
+
+        // no scene: place every mesh at the origin
+        auto const mesh_count = array_size(j, "meshes");
+        for (auto i = 0u; i < mesh_count && !failed; ++i)
+            for (auto const& [primitive_mesh, material] : get_mesh(i))
+                model->primitives.push_back({primitive_mesh, material, mat4(1.f)});
+    }
+
+    /**
+     * @brief Read a texture of a material
+     * @param object    Material or pbr json
+     * @param key       Texture info name
+     * @param format    Texture format
+     * @param result    Texture file
+     */
+    void read_texture(json const& object,
+                      name key,
+                      VkFormat format,
+                      texture_file& result) {
+        auto const info = get_member(object, key);
+        if (info && !doc.get_texture_file(*info, format, result))
+            failed = true;
+    }
+
+    /**
+     * @brief Add all materials
+     */
+    void add_materials() {
+        auto const count = array_size(doc.j, "materials");
+        for (auto i = 0u; i < count; ++i) {
+            auto const& material = doc.j["materials"][i];
+
+            gltf_material result;
+            result.name = read_string(material, "name");
+
+            if (auto const pbr = get_member(material, "pbrMetallicRoughness")) {
+                if (get_member(*pbr, "baseColorFactor")
+                    && !read_numbers(*pbr, "baseColorFactor",
+                                     glm::value_ptr(result.base_color_factor), 4)) {
+                    logger()->error("gltf material {} with invalid base color", i);
+                    failed = true;
+                }
+
+                result.metallic_factor = read_number(*pbr, "metallicFactor", 1.f);
+                result.roughness_factor = read_number(*pbr, "roughnessFactor", 1.f);
+
+                read_texture(*pbr, "baseColorTexture",
+                             VK_FORMAT_R8G8B8A8_SRGB, result.base_color_texture);
+                read_texture(*pbr, "metallicRoughnessTexture",
+                             VK_FORMAT_R8G8B8A8_UNORM, result.metallic_roughness_texture);
+            }
+
+            if (get_member(material, "emissiveFactor")
+                && !read_numbers(material, "emissiveFactor",
+                                 glm::value_ptr(result.emissive_factor), 3)) {
+                logger()->error("gltf material {} with invalid emissive factor", i);
+                failed = true;
+            }
+
+            read_texture(material, "normalTexture",
+                         VK_FORMAT_R8G8B8A8_UNORM, result.normal_texture);
+            read_texture(material, "occlusionTexture",
+                         VK_FORMAT_R8G8B8A8_UNORM, result.occlusion_texture);
+            read_texture(material, "emissiveTexture",
+                         VK_FORMAT_R8G8B8A8_SRGB, result.emissive_texture);
+
+            model->materials.push_back(result);
+        }
+    }
+};
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+gltf_model::s_ptr parse_gltf(c_data::ref source,
+                             string_ref base_path) {
+    gltf_document doc;
+    if (!parse_document(source, base_path, doc))
+        return nullptr;
+
+    auto model = gltf_model::make();
+
+    gltf_loader loader{doc, model};
+    loader.add_materials();
+    if (!loader.failed)
+        loader.add_scene();
+
+    if (loader.failed)
+        return nullptr;
+
+    if (model->primitives.empty()) {
+        logger()->error("gltf without primitives");
+        return nullptr;
+    }
+
+    return model;
+}
+
+//-----------------------------------------------------------------------------
+gltf_model::s_ptr load_gltf(device::ptr device,
+                            string_ref filename,
+                            bool create_buffers,
+                            staging::ptr staging) {
+    if (!extension(filename, {"GLTF", "GLB"}))
+        return nullptr;
+
+    file_data file_data(filename);
+    if (!file_data.addr) {
+        logger()->error("gltf load file {}", filename);
+        return nullptr;
+    }
+
+    auto model = parse_gltf(file_data,
+                            std::filesystem::path(filename).parent_path().generic_string());
+    if (!model) {
+        logger()->error("gltf load {}", filename);
+        return nullptr;
+    }
+
+    if (create_buffers) {
+        // meshes are shared between nodes referencing the same glTF mesh
+        std::set<mesh::s_ptr> created;
+        for (auto const& primitive : model->primitives) {
+            if (!created.insert(primitive.mesh).second)
+                continue;
+
+            if (staging ? !primitive.mesh->create(device, staging)
+                        : !primitive.mesh->create(device))
+                return nullptr;
+        }
+    }
+
+    return model;
+}
+
+//-----------------------------------------------------------------------------
+mesh::s_ptr merge_gltf_primitives(gltf_model::s_ptr const& model) {
+    auto result = mesh::make();
+
+    auto& vertices = result->get_vertices();
+    auto& indices = result->get_indices();
+
+    for (auto const& primitive : model->primitives) {
+        auto const base = to_ui32(vertices.size());
+        auto const normal_matrix = mat3(glm::transpose(glm::inverse(primitive.transform)));
+
+        for (auto v : primitive.mesh->get_vertices()) {
+            v.position = v3(primitive.transform * v4(v.position, 1.f));
+
+            if (v.normal != v3(0.f))
+                v.normal = glm::normalize(normal_matrix * v.normal);
+
+            vertices.push_back(v);
+        }
+
+        if (primitive.mesh->get_indices().empty()) {
+            for (auto i = 0u; i < primitive.mesh->get_vertices_count(); ++i)
+                indices.push_back(base + i);
+        } else {
+            for (auto i : primitive.mesh->get_indices())
+                indices.push_back(base + i);
+        }
+    }
+
+    if (result->empty())
+        return nullptr;
+
+    return result;
+}
+
+} // namespace lava
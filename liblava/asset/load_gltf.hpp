@@ -0,0 +1,132 @@
+/**
+ * @file         liblava/asset/load_gltf.hpp
+ * @brief        Load glTF 2.0 model from file
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/mesh.hpp"
+#include "liblava/resource/texture.hpp"
+
+namespace lava {
+
+/**
+ * @brief glTF material
+ */
+struct gltf_material {
+    /// List of glTF materials
+    using list = std::vector<gltf_material>;
+
+    /// Name of material
+    string name;
+
+    /// Base color factor
+    v4 base_color_factor = v4(1.f);
+
+    /// Metallic factor
+    r32 metallic_factor = 1.f;
+
+    /// Roughness factor
+    r32 roughness_factor = 1.f;
+
+    /// Emissive factor
+    v3 emissive_factor = v3(0.f);
+
+    /// Base color texture (sRGB)
+    texture_file base_color_texture;
+
+    /// Metallic roughness texture
+    texture_file metallic_roughness_texture;
+
+    /// Normal texture
+    texture_file normal_texture;
+
+    /// Occlusion texture
+    texture_file occlusion_texture;
+
+    /// Emissive texture (sRGB)
+    texture_file emissive_texture;
+};
+
+/**
+ * @brief glTF primitive placed in the scene
+ */
+struct gltf_primitive {
+    /// List of glTF primitives
+    using list = std::vector<gltf_primitive>;
+
+    /// Primitive mesh (shared between nodes referencing the same glTF mesh)
+    mesh::s_ptr mesh;
+
+    /// Index of material (no_index: default material)
+    index material = no_index;
+
+    /// World transform of node
+    mat4 transform = mat4(1.f);
+};
+
+/**
+ * @brief glTF model
+ */
+struct gltf_model : entity {
+    /// Shared pointer to glTF model
+    using s_ptr = std::shared_ptr<gltf_model>;
+
+    /**
+     * @brief Make a new glTF model
+     * @return s_ptr    Shared pointer to glTF model
+     */
+    static s_ptr make() {
+        return std::make_shared<gltf_model>();
+    }
+
+    /**
+     * @brief Destroy the glTF model
+     */
+    void destroy() {
+        primitives.clear();
+        materials.clear();
+    }
+
+    /// List of primitives
+    gltf_primitive::list primitives;
+
+    /// List of materials
+    gltf_material::list materials;
+};
+
+/**
+ * @brief Parse glTF 2.0 model from memory (.gltf / .glb)
+ * @note Mesh data of primitives only, invalid indices or ranges fail the parse
+ * @param source               glTF or glb file data
+ * @param base_path            Base path of external buffers and images
+ * @return gltf_model::s_ptr   Parsed model (nullptr: failed)
+ */
+gltf_model::s_ptr parse_gltf(c_data::ref source,
+                             string_ref base_path = {});
+
+/**
+ * @brief Load glTF 2.0 model from file (.gltf / .glb)
+ * @note Buffers are filled from the mesh data of primitives, which stays on the host
+ *       (matching interleaved vertex layouts are copied with one memcpy)
+ * @param device               Vulkan device
+ * @param filename             File to load
+ * @param create_buffers       Create mesh buffers of primitives
+ * @param staging              Staging for device local upload (nullptr: upload now)
+ * @return gltf_model::s_ptr   Loaded model
+ */
+gltf_model::s_ptr load_gltf(device::ptr device,
+                            string_ref filename,
+                            bool create_buffers = true,
+                            staging::ptr staging = nullptr);
+
+/**
+ * @brief Merge all primitives of a glTF model into one mesh
+ * @param model            glTF model (mesh data of primitives)
+ * @return mesh::s_ptr     Merged mesh (without buffers)
+ */
+mesh::s_ptr merge_gltf_primitives(gltf_model::s_ptr const& model);
+
+} // namespace lava
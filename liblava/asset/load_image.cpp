@@ -7,6 +7,7 @@
 
 #include "liblava/asset/load_image.hpp"
 #include "liblava/file/file.hpp"
+#include "liblava/file/file_utils.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -26,7 +27,7 @@ image_data::s_ptr load_image(string_ref filename) {
             return nullptr;
     }
 
-    i32 tex_width, tex_height, tex_channels = 0;
+    i32 tex_width = 0, tex_height = 0, tex_channels = 0;
     auto result = std::make_shared<image_data>();
     if (!result)
         return nullptr;
@@ -45,14 +46,14 @@ image_data::s_ptr load_image(string_ref filename) {
         return nullptr;
 
     result->dimensions = {tex_width, tex_height};
-    result->channels = tex_channels;
+    result->channels = 4;
 
     return result;
 }
 
 //-----------------------------------------------------------------------------
 image_data::s_ptr load_image(c_data::ref data) {
-    i32 tex_width, tex_height, tex_channels = 0;
+    i32 tex_width = 0, tex_height = 0, tex_channels = 0;
     auto result = std::make_shared<image_data>();
     if (!result)
         return nullptr;
@@ -66,9 +67,119 @@ image_data::s_ptr load_image(c_data::ref data) {
         return nullptr;
 
     result->dimensions = {tex_width, tex_height};
-    result->channels = tex_channels;
+    result->channels = 4;
 
     return result;
 }
 
+//-----------------------------------------------------------------------------
+image_data::s_ptr load_image(string_ref filename,
+                             image_pixel pixel,
+                             ui32 channels) {
+    u_data data;
+    if (!load_file_data(filename, data))
+        return nullptr;
+
+    return load_image(c_data(data), pixel, channels);
+}
+
+//-----------------------------------------------------------------------------
+image_data::s_ptr load_image(c_data::ref data,
+                             image_pixel pixel,
+                             ui32 channels) {
+    auto const source = (stbi_uc const*)data.addr;
+    auto const source_size = to_i32(data.size);
+
+    i32 tex_width = 0, tex_height = 0, tex_channels = 0;
+    if (!stbi_info_from_memory(source, source_size,
+                               &tex_width, &tex_height, &tex_channels))
+        return nullptr;
+
+    // RGB formats are barely supported for sampling
+    if (channels == 0)
+        channels = to_ui32(tex_channels == 3 ? 4 : tex_channels);
+
+    if (channels > 4)
+        return nullptr;
+
+    auto result = std::make_shared<image_data>();
+    if (!result)
+        return nullptr;
+
+    switch (pixel) {
+    case image_pixel::u8: {
+        result->set_data(data::as_ptr(stbi_load_from_memory(source, source_size,
+                                                            &tex_width, &tex_height,
+                                                            &tex_channels, to_i32(channels))));
+        result->channel_size = 1;
+        break;
+    }
+    case image_pixel::u16: {
+        result->set_data(data::as_ptr(stbi_load_16_from_memory(source, source_size,
+                                                               &tex_width, &tex_height,
+                                                               &tex_channels, to_i32(channels))));
+        result->channel_size = 2;
+        break;
+    }
+    case image_pixel::f32: {
+        result->set_data(data::as_ptr(stbi_loadf_from_memory(source, source_size,
+                                                             &tex_width, &tex_height,
+                                                             &tex_channels, to_i32(channels))));
+        result->channel_size = 4;
+        break;
+    }
+    }
+
+    if (!result->ready())
+        return nullptr;
+
+    result->dimensions = {tex_width, tex_height};
+    result->channels = channels;
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+image_pixel get_image_pixel(c_data::ref data) {
+    auto const source = (stbi_uc const*)data.addr;
+    auto const source_size = to_i32(data.size);
+
+    if (stbi_is_hdr_from_memory(source, source_size))
+        return image_pixel::f32;
+
+    if (stbi_is_16_bit_from_memory(source, source_size))
+        return image_pixel::u16;
+
+    return image_pixel::u8;
+}
+
+//-----------------------------------------------------------------------------
+VkFormat get_image_format(image_data const& image,
+                          bool srgb) {
+    if (image.channel_size == 1) {
+        if (image.channels == 1)
+            return VK_FORMAT_R8_UNORM;
+        if (image.channels == 2)
+            return VK_FORMAT_R8G8_UNORM;
+        if (image.channels == 4)
+            return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    } else if (image.channel_size == 2) {
+        if (image.channels == 1)
+            return VK_FORMAT_R16_UNORM;
+        if (image.channels == 2)
+            return VK_FORMAT_R16G16_UNORM;
+        if (image.channels == 4)
+            return VK_FORMAT_R16G16B16A16_UNORM;
+    } else if (image.channel_size == 4) {
+        if (image.channels == 1)
+            return VK_FORMAT_R16_SFLOAT;
+        if (image.channels == 2)
+            return VK_FORMAT_R16G16_SFLOAT;
+        if (image.channels == 4)
+            return VK_FORMAT_R16G16B16A16_SFLOAT;
+    }
+
+    return VK_FORMAT_UNDEFINED;
+}
+
 } // namespace lava
@@ -12,17 +12,65 @@
 namespace lava {
 
 /**
- * @brief Load image data from file
+ * @brief Image pixel types
+ */
+enum class image_pixel : index {
+    u8 = 0,
+    u16,
+    f32
+};
+
+/**
+ * @brief Load image data from file (RGBA8)
  * @param filename              File to load
  * @return image_data::s_ptr    Loaded image
  */
 image_data::s_ptr load_image(string_ref filename);
 
 /**
- * @brief Load image data from memory
+ * @brief Load image data from memory (RGBA8)
  * @param data                  Memory data to load
  * @return image_data::s_ptr    Loaded image
  */
 image_data::s_ptr load_image(c_data::ref data);
 
+/**
+ * @brief Load image data from file
+ * @param filename              File to load
+ * @param pixel                 Pixel type of image data
+ * @param channels              Number of channels (0: source channels, RGB is expanded to RGBA)
+ * @return image_data::s_ptr    Loaded image
+ */
+image_data::s_ptr load_image(string_ref filename,
+                             image_pixel pixel,
+                             ui32 channels = 0);
+
+/**
+ * @brief Load image data from memory
+ * @param data                  Memory data to load
+ * @param pixel                 Pixel type of image data
+ * @param channels              Number of channels (0: source channels, RGB is expanded to RGBA)
+ * @return image_data::s_ptr    Loaded image
+ */
+image_data::s_ptr load_image(c_data::ref data,
+                             image_pixel pixel,
+                             ui32 channels = 0);
+
+/**
+ * @brief Get the source pixel type of image data in memory
+ * @param data             Memory data to check
+ * @return image_pixel     Pixel type (f32: HDR, u16: 16-bit)
+ */
+image_pixel get_image_pixel(c_data::ref data);
+
+/**
+ * @brief Get the texture format matching image data
+ * @note Float data is meant to be uploaded as half floats
+ * @param image       Image data
+ * @param srgb        Color data is sRGB (8-bit RGBA only)
+ * @return VkFormat   Texture format (undefined: not supported)
+ */
+VkFormat get_image_format(image_data const& image,
+                          bool srgb = false);
+
 } // namespace lava
@@ -6,6 +6,8 @@
  */
 
 #include "liblava/asset/load_mesh.hpp"
+#include "liblava/asset/load_gltf.hpp"
+#include "liblava/asset/load_obj.hpp"
 #include "liblava/file.hpp"
 
 #ifdef _WIN32
@@ -27,8 +29,42 @@
 namespace lava {
 
 //-----------------------------------------------------------------------------
-mesh::s_ptr load_mesh(device::ptr device, string_ref filename, string_ref temp_dir) {
+mesh::s_ptr load_mesh(device::ptr device,
+                      string_ref filename,
+                      string_ref temp_dir,
+                      staging::ptr staging) {
+    if (extension(filename, {"GLTF", "GLB"})) {
+        auto model = load_gltf(device, filename, false);
+        if (!model)
+            return nullptr;
+
+        auto mesh = merge_gltf_primitives(model);
+        if (!mesh)
+            return nullptr;
+
+        if (staging ? !mesh->create(device, staging) : !mesh->create(device))
+            return nullptr;
+
+        return mesh;
+    }
+
     if (extension(filename, "OBJ")) {
+        {
+            file_data const obj_data(filename);
+            if (!obj_data.addr)
+                return nullptr;
+
+            auto mesh = mesh::make();
+            if (parse_obj(obj_data, mesh->get_data())) {
+                if (staging ? !mesh->create(device, staging) : !mesh->create(device))
+                    return nullptr;
+
+                return mesh;
+            }
+
+            logger()->debug("load mesh with tinyobj: {}", filename);
+        }
+
         tinyobj::attrib_t attrib;
         std::vector<tinyobj::shape_t> shapes;
         std::vector<tinyobj::material_t> materials;
@@ -96,7 +132,7 @@ mesh::s_ptr load_mesh(device::ptr device, string_ref filename, string_ref temp_d
             if (mesh->empty())
                 return nullptr;
 
-            if (!mesh->create(device))
+            if (staging ? !mesh->create(device, staging) : !mesh->create(device))
                 return nullptr;
 
             return mesh;
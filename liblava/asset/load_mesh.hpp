@@ -12,14 +12,17 @@
 namespace lava {
 
 /**
- * @brief Load mesh from file
+ * @brief Load mesh from file (OBJ, glTF)
+ * @note glTF primitives are merged into one mesh with node transforms applied
  * @param device          Vulkan device
  * @param filename        File to load
- * @param temp_dir        Temporary directory
+ * @param temp_dir        Temporary directory (tinyobj fallback)
+ * @param staging         Staging for device local upload (nullptr: upload now)
  * @return mesh::s_ptr    Loaded mesh
  */
 mesh::s_ptr load_mesh(device::ptr device,
                       string_ref filename,
-                      string_ref temp_dir);
+                      string_ref temp_dir,
+                      staging::ptr staging = nullptr);
 
 } // namespace lava
@@ -0,0 +1,447 @@
+/**
+ * @file         liblava/asset/load_obj.cpp
+ * @brief        Parallel OBJ parser
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/load_obj.hpp"
+#include <charconv>
+#include <thread>
+
+namespace lava {
+
+namespace {
+
+/// Minimum chunk size for parallel parsing
+constexpr size_t obj_min_chunk_size = 256 * 1024;
+
+/**
+ * @brief Face corner with indices (0-based)
+ */
+struct obj_corner {
+    /// Position index
+    i64 position = 0;
+
+    /// Texture coordinate index (-1: none)
+    i64 uv = -1;
+
+    /// Normal index (-1: none)
+    i64 normal = -1;
+
+    /// Relative indices (resolved against chunk, need chunk offset)
+    ui8 relative = 0;
+};
+
+/// Relative position flag
+constexpr ui8 obj_relative_position = 1 << 0;
+
+/// Relative texture coordinate flag
+constexpr ui8 obj_relative_uv = 1 << 1;
+
+/// Relative normal flag
+constexpr ui8 obj_relative_normal = 1 << 2;
+
+/**
+ * @brief Parsed OBJ chunk
+ */
+struct obj_chunk {
+    /// Chunk data
+    std::string_view text;
+
+    /// Positions
+    std::vector<v3> positions;
+
+    /// Texture coordinates
+    std::vector<v2> uvs;
+
+    /// Normals
+    std::vector<v3> normals;
+
+    /// Triangulated face corners
+    std::vector<obj_corner> corners;
+
+    /// Chunk offsets (positions, uvs, normals)
+    std::array<i64, 3> offsets = {};
+
+    /// First vertex of chunk
+    size_t first_vertex = 0;
+
+    /// Parse was successful or failed
+    bool valid = true;
+};
+
+/**
+ * @brief OBJ line cursor
+ */
+struct obj_cursor {
+    /// Current position
+    char const* pos;
+
+    /// End of line
+    char const* end;
+
+    /**
+     * @brief Skip spaces and tabs
+     */
+    void skip_space() {
+        while (pos < end && (*pos == ' ' || *pos == '\t'))
+            ++pos;
+    }
+
+    /**
+     * @brief Check if cursor reached the end
+     * @return End reached or not
+     */
+    bool done() {
+        skip_space();
+        return pos >= end;
+    }
+
+    /**
+     * @brief Read a float
+     * @param value    Target value
+     * @return Read was successful or failed
+     */
+    bool read(r32& value) {
+        skip_space();
+        if (pos < end && *pos == '+')
+            ++pos;
+
+        auto const result = std::from_chars(pos, end, value);
+        if (result.ec != std::errc())
+            return false;
+
+        pos = result.ptr;
+        return true;
+    }
+
+    /**
+     * @brief Read an integer
+     * @param value    Target value
+     * @return Read was successful or failed
+     */
+    bool read(i64& value) {
+        if (pos < end && *pos == '+')
+            ++pos;
+
+        auto const result = std::from_chars(pos, end, value);
+        if (result.ec != std::errc())
+            return false;
+
+        pos = result.ptr;
+        return true;
+    }
+};
+
+/**
+ * @brief Resolve an OBJ index (1-based or negative)
+ * @param value       Parsed index
+ * @param count       Elements of this kind parsed in chunk so far
+ * @param relative    Relative flags of corner
+ * @param flag        Relative flag of index kind
+ * @param target      Resolved index
+ * @return Index is valid or not
+ */
+bool resolve_index(i64 value,
+                   size_t count,
+                   ui8& relative,
+                   ui8 flag,
+                   i64& target) {
+    if (value > 0) {
+        target = value - 1;
+        return true;
+    }
+
+    if (value < 0) {
+        // relative to elements defined before this line
+        target = i64(count) + value;
+        relative |= flag;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Parse a face line
+ * @param cursor    Line cursor
+ * @param chunk     Target chunk
+ * @return Parse was successful or failed
+ */
+bool parse_face(obj_cursor& cursor,
+                obj_chunk& chunk) {
+    std::array<obj_corner, 3> fan;
+    auto corner_count = 0u;
+
+    while (!cursor.done()) {
+        obj_corner corner;
+
+        i64 value = 0;
+        if (!cursor.read(value)
+            || !resolve_index(value, chunk.positions.size(), corner.relative,
+                              obj_relative_position, corner.position))
+            return false;
+
+        if (cursor.pos < cursor.end && *cursor.pos == '/') {
+            ++cursor.pos;
+
+            if (cursor.pos < cursor.end && *cursor.pos != '/') {
+                if (!cursor.read(value)
+                    || !resolve_index(value, chunk.uvs.size(), corner.relative,
+                                      obj_relative_uv, corner.uv))
+                    return false;
+            }
+
+            if (cursor.pos < cursor.end && *cursor.pos == '/') {
+                ++cursor.pos;
+
+                if (!cursor.read(value)
+                    || !resolve_index(value, chunk.normals.size(), corner.relative,
+                                      obj_relative_normal, corner.normal))
+                    return false;
+            }
+        }
+
+        // triangle fan: (first, previous, current)
+        if (corner_count < 2) {
+            fan[corner_count] = corner;
+        } else {
+            chunk.corners.push_back(fan[0]);
+            chunk.corners.push_back(fan[1]);
+            chunk.corners.push_back(corner);
+
+            fan[1] = corner;
+        }
+
+        ++corner_count;
+    }
+
+    return corner_count >= 3;
+}
+
+/**
+ * @brief Parse a chunk of lines
+ * @param chunk    Chunk to parse
+ */
+void parse_chunk(obj_chunk& chunk) {
+    auto pos = chunk.text.data();
+    auto const end = pos + chunk.text.size();
+
+    while (pos < end) {
+        auto line_end = static_cast<char const*>(memchr(pos, '\n', end - pos));
+        if (!line_end)
+            line_end = end;
+
+        obj_cursor cursor{pos, line_end};
+        if (cursor.end > cursor.pos && *(cursor.end - 1) == '\r')
+            --cursor.end;
+
+        pos = line_end + 1;
+
+        cursor.skip_space();
+        if (cursor.end - cursor.pos < 2)
+            continue;
+
+        auto const c0 = cursor.pos[0];
+        auto const c1 = cursor.pos[1];
+
+        if (c0 == 'v' && (c1 == ' ' || c1 == '\t')) {
+            cursor.pos += 1;
+
+            v3 position;
+            if (!cursor.read(position.x) || !cursor.read(position.y)
+                || !cursor.read(position.z)) {
+                chunk.valid = false;
+                return;
+            }
+
+            chunk.positions.push_back(position);
+        } else if (c0 == 'v' && c1 == 't') {
+            cursor.pos += 2;
+
+            v2 uv{0.f};
+            if (!cursor.read(uv.x)) {
+                chunk.valid = false;
+                return;
+            }
+
+            cursor.read(uv.y);
+
+            chunk.uvs.push_back(uv);
+        } else if (c0 == 'v' && c1 == 'n') {
+            cursor.pos += 2;
+
+            v3 normal;
+            if (!cursor.read(normal.x) || !cursor.read(normal.y)
+                || !cursor.read(normal.z)) {
+                chunk.valid = false;
+                return;
+            }
+
+            chunk.normals.push_back(normal);
+        } else if (c0 == 'f' && (c1 == ' ' || c1 == '\t')) {
+            cursor.pos += 1;
+
+            if (!parse_face(cursor, chunk)) {
+                chunk.valid = false;
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Run a function for each chunk in parallel
+ * @param chunks    List of chunks
+ * @param func      Function to run
+ */
+void for_each_chunk(std::vector<obj_chunk>& chunks,
+                    auto func) {
+    if (chunks.size() == 1) {
+        func(chunks.front());
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunks.size());
+
+    for (auto& chunk : chunks)
+        threads.emplace_back([&func, &chunk]() {
+            func(chunk);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool parse_obj(c_data::ref source,
+               mesh_data& target,
+               ui32 thread_count) {
+    if (!source.addr || source.size == 0)
+        return false;
+
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    auto const chunk_count = std::clamp(source.size / obj_min_chunk_size,
+                                        size_t(1),
+                                        size_t(thread_count));
+
+    // split into line aligned chunks
+    std::vector<obj_chunk> chunks(chunk_count);
+
+    std::string_view const text(source.addr, source.size);
+    auto const chunk_size = text.size() / chunk_count;
+
+    size_t begin = 0;
+    for (auto i = 0u; i < chunk_count; ++i) {
+        auto end = text.size();
+        if (i + 1 < chunk_count) {
+            end = text.find('\n', std::max(begin, (i + 1) * chunk_size));
+            end = end == std::string_view::npos ? text.size() : end + 1;
+        }
+
+        chunks[i].text = text.substr(begin, end - begin);
+        begin = end;
+    }
+
+    for_each_chunk(chunks, parse_chunk);
+
+    // global index fixups
+    std::array<i64, 3> totals = {};
+    size_t vertex_count = 0;
+
+    for (auto& chunk : chunks) {
+        if (!chunk.valid)
+            return false;
+
+        chunk.offsets = totals;
+        chunk.first_vertex = vertex_count;
+
+        totals[0] += chunk.positions.size();
+        totals[1] += chunk.uvs.size();
+        totals[2] += chunk.normals.size();
+        vertex_count += chunk.corners.size();
+    }
+
+    if (vertex_count == 0)
+        return false;
+
+    std::vector<v3> positions;
+    std::vector<v2> uvs;
+    std::vector<v3> normals;
+
+    positions.reserve(totals[0]);
+    uvs.reserve(totals[1]);
+    normals.reserve(totals[2]);
+
+    for (auto& chunk : chunks) {
+        positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+        uvs.insert(uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+    }
+
+    target.vertices.resize(vertex_count);
+    target.indices.resize(vertex_count);
+
+    // emit vertices of each chunk into its own range
+    for_each_chunk(chunks, [&](obj_chunk& chunk) {
+        auto resolve = [&](i64 value, ui8 relative, ui8 flag, index kind) {
+            return relative & flag ? value + chunk.offsets[kind] : value;
+        };
+
+        for (auto i = 0u; i < chunk.corners.size(); ++i) {
+            auto const& corner = chunk.corners[i];
+            auto const vertex_index = chunk.first_vertex + i;
+
+            auto const position = resolve(corner.position, corner.relative,
+                                          obj_relative_position, 0);
+            if (position < 0 || position >= i64(positions.size())) {
+                chunk.valid = false;
+                return;
+            }
+
+            auto& vertex = target.vertices[vertex_index];
+            vertex.position = positions[position];
+            vertex.color = v4(1.f);
+            vertex.uv = v2(0.f);
+            vertex.normal = v3(0.f);
+
+            if (corner.uv >= 0 || corner.relative & obj_relative_uv) {
+                auto const uv = resolve(corner.uv, corner.relative,
+                                        obj_relative_uv, 1);
+                if (uv < 0 || uv >= i64(uvs.size())) {
+                    chunk.valid = false;
+                    return;
+                }
+
+                vertex.uv = v2(uvs[uv].x, 1.f - uvs[uv].y);
+            }
+
+            if (corner.normal >= 0 || corner.relative & obj_relative_normal) {
+                auto const normal = resolve(corner.normal, corner.relative,
+                                            obj_relative_normal, 2);
+                if (normal < 0 || normal >= i64(normals.size())) {
+                    chunk.valid = false;
+                    return;
+                }
+
+                vertex.normal = normals[normal];
+            }
+
+            target.indices[vertex_index] = to_ui32(vertex_index);
+        }
+    });
+
+    for (auto const& chunk : chunks)
+        if (!chunk.valid)
+            return false;
+
+    return true;
+}
+
+} // namespace lava
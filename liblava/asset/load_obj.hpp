@@ -0,0 +1,26 @@
+/**
+ * @file         liblava/asset/load_obj.hpp
+ * @brief        Parallel OBJ parser
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/mesh.hpp"
+
+namespace lava {
+
+/**
+ * @brief Parse OBJ data from memory (v, vt, vn, f)
+ * @note Same layout as load_mesh: one vertex per face corner, polygons are triangulated as fans
+ * @param source          OBJ file data
+ * @param target          Mesh data to fill
+ * @param thread_count    Number of threads (0: hardware concurrency, small data is parsed on caller)
+ * @return Parse was successful or failed
+ */
+bool parse_obj(c_data::ref source,
+               mesh_data& target,
+               ui32 thread_count = 0);
+
+} // namespace lava
@@ -6,6 +6,7 @@
  */
 
 #include "liblava/asset/load_texture.hpp"
+#include "liblava/asset/load_image.hpp"
 #include "liblava/file.hpp"
 #include "liblava/resource/format.hpp"
 
@@ -34,7 +35,7 @@
     #pragma GCC diagnostic pop
 #endif
 
-#include "stb_image.h"
+#include "glm/gtc/packing.hpp"
 
 namespace lava {
 
@@ -196,46 +197,78 @@ texture::s_ptr create_gli_texture_cube_map(device::ptr device,
  * @brief Create a stbi texture
  * @param device             Vulkan device
  * @param file               File to load
+ * @param format             Format of texture (undefined: source channels and precision)
  * @param temp_data          Data of texture
  * @return texture::s_ptr    Loaded texture
  */
 texture::s_ptr create_stbi_texture(device::ptr device,
                                    file::ref file,
+                                   VkFormat format,
                                    u_data::ref temp_data) {
-    i32 tex_width = 0, tex_height = 0;
-    stbi_uc* data = nullptr;
-
-    if (file.opened())
-        data = stbi_load_from_memory((stbi_uc const*)temp_data.addr,
-                                     to_i32(temp_data.size),
-                                     &tex_width,
-                                     &tex_height,
-                                     nullptr,
-                                     STBI_rgb_alpha);
-    else
-        data = stbi_load(str(file.get_path()),
-                         &tex_width,
-                         &tex_height,
-                         nullptr,
-                         STBI_rgb_alpha);
-
-    if (!data)
+    if (!file.opened())
+        return nullptr;
+
+    c_data const source(temp_data.addr, temp_data.size);
+
+    // HDR data is never clamped to 8-bit
+    auto const pixel = get_image_pixel(source);
+    auto const native = format == VK_FORMAT_UNDEFINED || pixel == image_pixel::f32;
+
+    auto image = native ? load_image(source, pixel)
+                        : load_image(source, image_pixel::u8, 4);
+    if (!image)
+        return nullptr;
+
+    // requested 8-bit RGBA keeps its color space (UNORM data maps)
+    auto const rgba8 = format == VK_FORMAT_R8G8B8A8_UNORM
+                       || format == VK_FORMAT_R8G8B8A8_SRGB;
+
+    auto texture_format = native ? get_image_format(*image, true)
+                                 : rgba8 ? format
+                                         : VK_FORMAT_R8G8B8A8_SRGB;
+
+    // fall back to 8-bit if 16-bit format is not supported
+    if (image->channel_size == 2
+        && !find_supported_format(device->get_vk_physical_device(),
+                                  {texture_format},
+                                  VK_IMAGE_USAGE_SAMPLED_BIT)) {
+        image = load_image(source, image_pixel::u8, image->channels);
+        if (!image)
+            return nullptr;
+
+        texture_format = get_image_format(*image, true);
+    }
+
+    if (texture_format == VK_FORMAT_UNDEFINED)
         return nullptr;
 
     auto texture = texture::make();
 
-    uv2 const size = {tex_width, tex_height};
-    auto const font_format = VK_FORMAT_R8G8B8A8_SRGB;
-    if (!texture->create(device, size, font_format))
+    // grey and grey alpha
+    if (image->channels == 1)
+        texture->set_component({VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R,
+                                VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE});
+    else if (image->channels == 2)
+        texture->set_component({VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R,
+                                VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G});
+
+    if (!texture->create(device, image->dimensions, texture_format,
+                         {}, texture_type::tex_2d, true))
         return nullptr;
 
-    auto const uploadSize = tex_width * tex_height * format_block_size(font_format);
-    auto result = texture->upload(data, uploadSize);
+    if (image->channel_size == sizeof(r32)) {
+        // half floats
+        auto const values = reinterpret_cast<r32 const*>(image->get_data());
 
-    stbi_image_free(data);
+        std::vector<ui16> half_values(image->size() / sizeof(r32));
+        for (auto i = 0u; i < half_values.size(); ++i)
+            half_values[i] = glm::packHalf1x16(values[i]);
 
-    if (!result)
+        if (!texture->upload(half_values.data(), half_values.size() * sizeof(ui16)))
+            return nullptr;
+    } else if (!texture->upload(image->get_data(), image->size())) {
         return nullptr;
+    }
 
     return texture;
 }
@@ -298,6 +331,7 @@ texture::s_ptr load_texture(device::ptr device,
     } else {
         return create_stbi_texture(device,
                                    file,
+                                   tex_file.format,
                                    temp_data);
     }
 
@@ -312,33 +346,38 @@ texture::s_ptr create_default_texture(device::ptr device,
     auto result = texture::make();
 
     auto const format = VK_FORMAT_R8G8B8A8_UNORM;
-    if (!result->create(device, size, format))
+    if (!result->create(device, size, format, {}, texture_type::tex_2d, true))
         return nullptr;
 
-    i32 const block_size = format_block_size(format);
+    auto const block_size = format_block_size(format);
     u_data data(size.x * size.y * block_size);
-    memset(data.addr, 0, data.size);
-
-    ui32 const color_r = 255 * color.r;
-    ui32 const color_g = 255 * color.g;
-    ui32 const color_b = 255 * color.b;
-    ui32 const color_a = 255 * alpha;
-
-    for (auto y = 0u; y < size.y; ++y) {
-        for (auto x = 0u; x < size.x; ++x) {
-            auto const index = (x * block_size)
-                               + (y * size.y * block_size);
-            if (((y % 128 < 64) && (x % 128 < 64))
-                || ((y % 128 >= 64) && (x % 128 >= 64))) {
-                data.addr[index] = color_r;
-                data.addr[index + 1] = color_g;
-                data.addr[index + 2] = color_b;
-            }
-
-            data.addr[index + 3] = color_a;
-        }
+
+    std::array<ui8, 4> const color_texel = {ui8(255 * color.r),
+                                            ui8(255 * color.g),
+                                            ui8(255 * color.b),
+                                            ui8(255 * alpha)};
+    std::array<ui8, 4> const alpha_texel = {0, 0, 0, color_texel[3]};
+
+    // checker rows starting with color or alpha tile, copied per row
+    auto const row_size = size.x * block_size;
+    std::vector<ui8> rows(row_size * 2);
+
+    for (auto x = 0u; x < size.x; ++x) {
+        auto const color_first = x % 128 < 64;
+
+        memcpy(rows.data() + x * block_size,
+               color_first ? color_texel.data() : alpha_texel.data(),
+               block_size);
+        memcpy(rows.data() + row_size + x * block_size,
+               color_first ? alpha_texel.data() : color_texel.data(),
+               block_size);
     }
 
+    for (auto y = 0u; y < size.y; ++y)
+        memcpy(data.addr + y * row_size,
+               rows.data() + (y % 128 < 64 ? 0 : row_size),
+               row_size);
+
     if (!result->upload(data.addr, data.size))
         return nullptr;
 
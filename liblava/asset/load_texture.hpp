@@ -13,6 +13,7 @@ namespace lava {
 
 /**
  * @brief Load texture from file
+ * @note Image files with undefined format keep their channels and precision (HDR is always float)
  * @param device             Vulkan device
  * @param tex_file           Texture file
  * @param type               Type of texture
@@ -26,7 +27,7 @@ texture::s_ptr load_texture(device::ptr device,
  * @brief Load texture from file with default format (sRGB)
  * @param device             Vulkan device
  * @param filename           File to load
- * @param format             Format of texture
+ * @param format             Format of texture (8-bit RGBA: UNORM or sRGB, undefined: source channels)
  * @param type               Type of texture
  * @return texture::s_ptr    Loaded texture
  */
@@ -0,0 +1,88 @@
+/**
+ * @file         liblava/asset/test/compress_texture.cpp
+ * @brief        Block compression unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("compress image", "[bcn]") {
+    SECTION("block sizes and formats") {
+        REQUIRE(get_block_format_size(block_format::bc1) == 8);
+        REQUIRE(get_block_format_size(block_format::bc5) == 16);
+        REQUIRE(get_block_format_size(block_format::none) == 0);
+
+        REQUIRE(get_block_format(block_format::bc7) == VK_FORMAT_BC7_SRGB_BLOCK);
+        REQUIRE(get_block_format(block_format::bc1, false) == VK_FORMAT_BC1_RGB_UNORM_BLOCK);
+        REQUIRE(get_block_format(block_format::bc4, true) == VK_FORMAT_BC4_UNORM_BLOCK);
+    }
+
+    SECTION("solid color with partial blocks") {
+        uv2 const size = {6, 5};
+
+        std::vector<ui8> pixels(size.x * size.y * 4);
+        for (auto i = 0u; i < pixels.size(); i += 4) {
+            pixels[i] = 255;
+            pixels[i + 1] = 0;
+            pixels[i + 2] = 0;
+            pixels[i + 3] = 128;
+        }
+
+        c_data const data(pixels.data(), pixels.size());
+
+        std::vector<char> blocks;
+        REQUIRE(compress_image(data, size, block_format::bc1, blocks, 1));
+        REQUIRE(blocks.size() == 4 * 8);
+
+        // pure red in RGB565, all indices select the first color
+        ui16 color = 0;
+        memcpy(&color, blocks.data(), 2);
+        REQUIRE(color == 0xF800);
+
+        REQUIRE(compress_image(data, size, block_format::bc4, blocks, 1));
+        REQUIRE(blocks.size() == 4 * 8);
+        REQUIRE(ui8(blocks[0]) == 255);
+
+        REQUIRE(compress_image(data, size, block_format::bc7, blocks, 1));
+        REQUIRE(blocks.size() == 4 * 16);
+        REQUIRE((ui8(blocks[0]) & 0x7F) == 0x40); // mode 6
+    }
+
+    SECTION("threads match single thread") {
+        uv2 const size = {64, 512};
+
+        std::vector<ui8> pixels(size.x * size.y * 4);
+        for (auto i = 0u; i < pixels.size(); ++i)
+            pixels[i] = ui8((i * 7) ^ (i >> 5));
+
+        c_data const data(pixels.data(), pixels.size());
+
+        std::vector<char> single;
+        std::vector<char> threaded;
+        REQUIRE(compress_image(data, size, block_format::bc3, single, 1));
+        REQUIRE(compress_image(data, size, block_format::bc3, threaded, 4));
+        REQUIRE(single == threaded);
+    }
+
+    SECTION("invalid input") {
+        std::vector<char> blocks;
+        std::vector<ui8> pixels(16);
+
+        REQUIRE_FALSE(compress_image({pixels.data(), pixels.size()}, {4, 4},
+                                     block_format::bc1, blocks));
+        REQUIRE_FALSE(compress_image({pixels.data(), pixels.size()}, {2, 2},
+                                     block_format::none, blocks));
+
+        // only RGBA8 image data is compressed
+        auto image = std::make_shared<image_data>();
+        image->set_data(data::as_ptr(malloc(4 * 4 * 3 * 2)));
+        image->dimensions = {4, 4};
+        image->channels = 3;
+        image->channel_size = 2;
+
+        REQUIRE_FALSE(write_compressed_texture("invalid.ktx", image,
+                                               block_format::bc1));
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file         liblava/asset/test/convert_image.cpp
+ * @brief        Pixel format conversion unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("convert image", "[pixel]") {
+    // odd count to cover vector and scalar paths
+    auto const pixel_count = 37u;
+
+    std::vector<ui8> pixels(pixel_count * 4);
+    for (auto i = 0u; i < pixels.size(); ++i)
+        pixels[i] = ui8(i * 31 + 7);
+
+    SECTION("swizzle") {
+        std::vector<ui8> target(pixels.size());
+        swizzle_rgba_bgra(pixels.data(), target.data(), pixel_count, 1);
+
+        for (auto i = 0u; i < pixel_count; ++i) {
+            REQUIRE(target[i * 4] == pixels[i * 4 + 2]);
+            REQUIRE(target[i * 4 + 1] == pixels[i * 4 + 1]);
+            REQUIRE(target[i * 4 + 2] == pixels[i * 4]);
+            REQUIRE(target[i * 4 + 3] == pixels[i * 4 + 3]);
+        }
+
+        auto in_place = pixels;
+        swizzle_rgba_bgra(in_place.data(), in_place.data(), pixel_count, 1);
+        REQUIRE(in_place == target);
+    }
+
+    SECTION("pack rgb") {
+        std::vector<ui8> target(pixel_count * 3);
+        pack_rgba_rgb(pixels.data(), target.data(), pixel_count, true, 1);
+
+        for (auto i = 0u; i < pixel_count; ++i) {
+            REQUIRE(target[i * 3] == pixels[i * 4 + 2]);
+            REQUIRE(target[i * 3 + 1] == pixels[i * 4 + 1]);
+            REQUIRE(target[i * 3 + 2] == pixels[i * 4]);
+        }
+    }
+
+    SECTION("unorm and srgb round trip") {
+        std::vector<r32> values(pixels.size());
+        std::vector<ui8> result(pixels.size());
+
+        convert_unorm_float(pixels.data(), values.data(), values.size(), 1);
+        convert_float_unorm(values.data(), result.data(), values.size(), 1);
+        REQUIRE(result == pixels);
+
+        decode_srgb(pixels.data(), values.data(), pixel_count, 1);
+        encode_srgb(values.data(), result.data(), pixel_count, 1);
+        for (auto i = 0u; i < pixels.size(); ++i)
+            REQUIRE(std::abs(i32(result[i]) - i32(pixels[i])) <= 1);
+    }
+
+    SECTION("premultiply") {
+        std::vector<ui8> texels = {255, 128, 0, 128, 10, 20, 30, 0};
+        premultiply_alpha(texels.data(), 2, 1);
+
+        REQUIRE(texels == std::vector<ui8>{128, 64, 0, 128, 0, 0, 0, 0});
+    }
+}
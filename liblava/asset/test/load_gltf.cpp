@@ -0,0 +1,100 @@
+/**
+ * @file         liblava/asset/test/load_gltf.cpp
+ * @brief        glTF parser unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+namespace {
+
+/// Triangle with 3 positions and indices 0 1 2
+string const triangle_data = "AAAAAAAAAAAAAAAAAACAPwAAAAAAAAAAAAAAAAAAgD8AAAAAAAABAAIAAAA=";
+
+/// Triangle with indices 0 1 5
+string const bad_index_data = "AAAAAAAAAAAAAAAAAACAPwAAAAAAAAAAAAAAAAAAgD8AAAAAAAABAAUAAAA=";
+
+/**
+ * @brief Make a glTF document of a triangle
+ * @param buffer_data      Base64 buffer data
+ * @param index_view       Buffer view of indices
+ * @param position_count   Number of positions
+ * @param material         Material json
+ * @return string          glTF json
+ */
+string make_triangle(string_ref buffer_data,
+                     string_ref index_view = "1",
+                     string_ref position_count = "3",
+                     string_ref material = "{}") {
+    return R"({"asset": {"version": "2.0"},
+               "buffers": [{"byteLength": 44,
+                            "uri": "data:application/octet-stream;base64,)"
+           + buffer_data + R"("}],
+               "bufferViews": [{"buffer": 0, "byteLength": 36},
+                               {"buffer": 0, "byteOffset": 36, "byteLength": 6}],
+               "accessors": [{"bufferView": 0, "componentType": 5126,
+                              "count": )"
+           + position_count + R"(, "type": "VEC3"},
+                             {"bufferView": )"
+           + index_view + R"(, "componentType": 5123,
+                              "count": 3, "type": "SCALAR"}],
+               "materials": [)"
+           + material + R"(],
+               "meshes": [{"primitives": [{"attributes": {"POSITION": 0},
+                                           "indices": 1, "material": 0}]}]})";
+}
+
+/**
+ * @brief Parse a glTF json string
+ * @param source               glTF json
+ * @return gltf_model::s_ptr   Parsed model
+ */
+gltf_model::s_ptr parse(string_ref source) {
+    return parse_gltf(c_data(source.data(), source.size()));
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("parse gltf", "[gltf]") {
+    SECTION("triangle") {
+        auto model = parse(make_triangle(triangle_data));
+        REQUIRE(model);
+
+        REQUIRE(model->primitives.size() == 1);
+        REQUIRE(model->materials.size() == 1);
+
+        auto const& primitive = model->primitives.front();
+        REQUIRE(primitive.material == 0);
+        REQUIRE(primitive.mesh->get_vertices().size() == 3);
+        REQUIRE(primitive.mesh->get_vertices().at(1).position == v3(1.f, 0.f, 0.f));
+        REQUIRE(primitive.mesh->get_indices() == index_list{0, 1, 2});
+    }
+
+    SECTION("index out of vertex range") {
+        REQUIRE_FALSE(parse(make_triangle(bad_index_data)));
+    }
+
+    SECTION("buffer view out of range") {
+        REQUIRE_FALSE(parse(make_triangle(triangle_data, "7")));
+    }
+
+    SECTION("buffer view with wrong type") {
+        REQUIRE_FALSE(parse(make_triangle(triangle_data, "\"1\"")));
+    }
+
+    SECTION("accessor past buffer view") {
+        REQUIRE_FALSE(parse(make_triangle(triangle_data, "1", "4")));
+    }
+
+    SECTION("texture out of range") {
+        REQUIRE_FALSE(parse(make_triangle(triangle_data, "1", "3",
+                                          R"({"normalTexture": {"index": 2}})")));
+    }
+
+    SECTION("invalid json") {
+        REQUIRE_FALSE(parse("{\"asset\": "));
+        REQUIRE_FALSE(parse("[]"));
+    }
+}
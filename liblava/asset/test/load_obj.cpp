@@ -0,0 +1,66 @@
+/**
+ * @file         liblava/asset/test/load_obj.cpp
+ * @brief        OBJ parser unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("parse obj", "[obj]") {
+    SECTION("quad with relative indices") {
+        string const obj = "v 0 0 0\n"
+                           "v 1 0 0\r\n"
+                           "v 1 1 0\n"
+                           "v 0 1 0\n"
+                           "vt 0 0\n"
+                           "vt 1 1\n"
+                           "vn 0 0 1\n"
+                           "f 1/1/1 2/1/1 3/2/1 4/2/1\n"
+                           "f -4//-1 -3//-1 -2//-1\n";
+
+        mesh_data data;
+        REQUIRE(parse_obj(c_data(obj.data(), obj.size()), data, 1));
+
+        REQUIRE(data.vertices.size() == 9);
+        REQUIRE(data.indices.size() == 9);
+
+        REQUIRE(data.vertices.at(2).position == v3(1.f, 1.f, 0.f));
+        REQUIRE(data.vertices.at(2).uv == v2(1.f, 0.f));
+        REQUIRE(data.vertices.at(5).position == v3(0.f, 1.f, 0.f));
+        REQUIRE(data.vertices.at(6).uv == v2(0.f));
+        REQUIRE(data.vertices.at(8).normal == v3(0.f, 0.f, 1.f));
+        REQUIRE(data.indices.at(8) == 8);
+    }
+
+    SECTION("invalid index") {
+        string const obj = "v 0 0 0\n"
+                           "f 1 2 3\n";
+
+        mesh_data data;
+        REQUIRE_FALSE(parse_obj(c_data(obj.data(), obj.size()), data, 1));
+    }
+
+    SECTION("chunked parsing matches single thread") {
+        string obj;
+        for (auto i = 0u; i < 50000; ++i) {
+            obj += "v " + std::to_string(i) + ".5 0.25 -2\nvt 0.5 0.75\nvn 0 1 0\n";
+            if (i >= 2)
+                obj += "f -3/-3/-1 -2/-2/-2 -1/-1/-3\n";
+        }
+
+        mesh_data single;
+        REQUIRE(parse_obj(c_data(obj.data(), obj.size()), single, 1));
+
+        mesh_data chunked;
+        REQUIRE(parse_obj(c_data(obj.data(), obj.size()), chunked, 8));
+
+        REQUIRE(single.vertices.size() == chunked.vertices.size());
+        for (auto i = 0u; i < single.vertices.size(); ++i) {
+            REQUIRE(single.vertices[i].position == chunked.vertices[i].position);
+            REQUIRE(single.vertices[i].uv == chunked.vertices[i].uv);
+            REQUIRE(single.indices[i] == chunked.indices[i]);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file         liblava/asset/test/texture_stream.cpp
+ * @brief        Texture stream unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("texture requests", "[texture_stream]") {
+    texture_requests requests;
+
+    auto ready_count = 0u;
+    auto failed_count = 0u;
+
+    auto on_ready = [&](texture::s_ptr product) {
+        if (product)
+            ++ready_count;
+        else
+            ++failed_count;
+    };
+
+    SECTION("coalesce requests of a name") {
+        REQUIRE(requests.add("a", on_ready));
+        REQUIRE_FALSE(requests.add("a", on_ready));
+        REQUIRE(requests.add("b", on_ready));
+
+        requests.finish("a", texture::make());
+
+        REQUIRE(ready_count == 2);
+        REQUIRE_FALSE(requests.pending("a"));
+        REQUIRE(requests.pending("b"));
+    }
+
+    SECTION("failed load reports all and allows retry") {
+        REQUIRE(requests.add("a", on_ready));
+        REQUIRE_FALSE(requests.add("a", on_ready));
+        REQUIRE_FALSE(requests.add("a", {}));
+
+        requests.finish("a", nullptr);
+
+        REQUIRE(failed_count == 2);
+        REQUIRE(ready_count == 0);
+        REQUIRE_FALSE(requests.pending("a"));
+
+        REQUIRE(requests.add("a", on_ready));
+    }
+
+    SECTION("request again from ready function") {
+        REQUIRE(requests.add("a", [&](texture::s_ptr product) {
+            on_ready(product);
+            REQUIRE(requests.add("a", on_ready));
+        }));
+
+        requests.finish("a", nullptr);
+
+        REQUIRE(failed_count == 1);
+        REQUIRE(requests.pending("a"));
+    }
+
+    SECTION("finish unknown name") {
+        requests.finish("a", nullptr);
+        REQUIRE(failed_count == 0);
+    }
+}
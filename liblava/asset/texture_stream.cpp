@@ -0,0 +1,167 @@
+/**
+ * @file         liblava/asset/texture_stream.cpp
+ * @brief        Asynchronous texture streaming
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/texture_stream.hpp"
+#include "liblava/asset/load_texture.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+bool texture_requests::add(string_ref name,
+                           ready_func on_ready) {
+    auto& request = m_requests[name];
+    request.push_back(on_ready);
+
+    return request.size() == 1;
+}
+
+//-----------------------------------------------------------------------------
+void texture_requests::finish(string_ref name,
+                              texture::s_ptr product) {
+    auto const item = m_requests.find(name);
+    if (item == m_requests.end())
+        return;
+
+    // ready functions may request the name again
+    auto ready_funcs = std::move(item->second);
+    m_requests.erase(item);
+
+    for (auto& ready : ready_funcs)
+        if (ready)
+            ready(product);
+}
+
+//-----------------------------------------------------------------------------
+bool texture_stream::setup(device::ptr device,
+                           staging::ptr staging,
+                           ui32 thread_count) {
+    if (ready())
+        teardown();
+
+    m_device = device;
+    m_staging = staging;
+
+    m_placeholder = create_default_texture(m_device, {4, 4});
+    if (!m_placeholder) {
+        logger()->error("create texture stream placeholder");
+        return false;
+    }
+
+    m_staging->add(m_placeholder);
+
+    m_pool = std::make_unique<thread_pool>();
+    m_pool->setup(std::max(thread_count, 1u));
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void texture_stream::teardown() {
+    if (m_pool) {
+        m_pool->teardown();
+        m_pool = nullptr;
+    }
+
+    m_done.clear();
+    m_uploading.clear();
+    m_pending = 0;
+
+    if (m_placeholder) {
+        m_placeholder->destroy();
+        m_placeholder = nullptr;
+    }
+
+    m_staging = nullptr;
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+texture::s_ptr texture_stream::request(texture_file const& tex_file,
+                                       ready_func on_ready,
+                                       texture_type type) {
+    return request(
+        [this, tex_file, type]() {
+            return load_texture(m_device, tex_file, type);
+        },
+        tex_file.path,
+        on_ready);
+}
+
+//-----------------------------------------------------------------------------
+texture::s_ptr texture_stream::request(load_func load,
+                                       string_ref path,
+                                       ready_func on_ready) {
+    if (!ready() || !load)
+        return nullptr;
+
+    ++m_pending;
+
+    m_pool->enqueue([this, load, on_ready, path = string(path)](id::ref) {
+        auto product = load();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.push_back({product, on_ready, path});
+    });
+
+    return m_placeholder;
+}
+
+//-----------------------------------------------------------------------------
+ui32 texture_stream::update() {
+    if (m_pending == 0)
+        return 0;
+
+    result::list failed_list;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (auto& item : m_done) {
+            if (!item.texture) {
+                logger()->error("stream texture: {}", item.path);
+                failed_list.push_back(std::move(item));
+                continue;
+            }
+
+            m_staging->add(item.texture);
+            m_uploading.push_back(std::move(item));
+        }
+
+        m_done.clear();
+    }
+
+    // called outside of lock, ready functions may request again
+    for (auto& item : failed_list) {
+        --m_pending;
+
+        if (item.on_ready)
+            item.on_ready(nullptr);
+    }
+
+    // upload data is released when the copy has finished on the device
+    auto const staged = std::stable_partition(m_uploading.begin(),
+                                              m_uploading.end(),
+                                              [](result const& item) {
+                                                  return item.texture->get_upload_size() > 0;
+                                              });
+
+    result::list ready_list(std::make_move_iterator(staged),
+                            std::make_move_iterator(m_uploading.end()));
+    m_uploading.erase(staged, m_uploading.end());
+
+    for (auto& item : ready_list) {
+        --m_pending;
+
+        if (item.on_ready)
+            item.on_ready(item.texture);
+    }
+
+    return to_ui32(ready_list.size());
+}
+
+} // namespace lava
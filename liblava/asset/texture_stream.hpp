@@ -0,0 +1,185 @@
+/**
+ * @file         liblava/asset/texture_stream.hpp
+ * @brief        Asynchronous texture streaming
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/staging.hpp"
+#include "liblava/util/thread.hpp"
+#include <atomic>
+
+namespace lava {
+
+/**
+ * @brief Pending texture requests by name (coalesces repeated requests)
+ */
+struct texture_requests {
+    /// Texture ready function (nullptr: load failed)
+    using ready_func = std::function<void(texture::s_ptr)>;
+
+    /**
+     * @brief Add a request
+     * @param name        Name of texture
+     * @param on_ready    Ready function
+     * @return Request is the first for the name (load it) or not
+     */
+    bool add(string_ref name,
+             ready_func on_ready);
+
+    /**
+     * @brief Finish all requests of a name (name can be requested again)
+     * @param name       Name of texture
+     * @param product    Loaded texture (nullptr: load failed)
+     */
+    void finish(string_ref name,
+                texture::s_ptr product);
+
+    /**
+     * @brief Check if a name is requested
+     * @param name    Name of texture
+     * @return Name is pending or not
+     */
+    bool pending(string_ref name) const {
+        return m_requests.count(name);
+    }
+
+private:
+    /// Map of ready functions by name
+    std::map<string, std::vector<ready_func>, std::less<>> m_requests;
+};
+
+/**
+ * @brief Texture stream (load textures on worker threads)
+ */
+struct texture_stream {
+    /// Pointer to texture stream
+    using ptr = texture_stream*;
+
+    /// Texture ready function (nullptr: load failed)
+    using ready_func = texture_requests::ready_func;
+
+    /// Texture load function
+    using load_func = std::function<texture::s_ptr()>;
+
+    /**
+     * @brief Destroy the texture stream
+     */
+    ~texture_stream() {
+        teardown();
+    }
+
+    /**
+     * @brief Set up the texture stream
+     * @param device          Vulkan device
+     * @param staging         Staging for uploads
+     * @param thread_count    Number of worker threads
+     * @return Setup was successful or failed
+     */
+    bool setup(device::ptr device,
+               staging::ptr staging,
+               ui32 thread_count = 2);
+
+    /**
+     * @brief Tear down the texture stream (pending requests are dropped)
+     */
+    void teardown();
+
+    /**
+     * @brief Request a texture
+     * @param tex_file           Texture file
+     * @param on_ready           Called on main thread when texture is uploaded (nullptr: failed)
+     * @param type               Type of texture
+     * @return texture::s_ptr    Placeholder texture
+     */
+    texture::s_ptr request(texture_file const& tex_file,
+                           ready_func on_ready = {},
+                           texture_type type = texture_type::tex_2d);
+
+    /**
+     * @brief Request a texture with a custom load function
+     * @param load               Called on worker thread to load the texture
+     * @param path               File path (for errors)
+     * @param on_ready           Called on main thread when texture is uploaded (nullptr: failed)
+     * @return texture::s_ptr    Placeholder texture
+     */
+    texture::s_ptr request(load_func load,
+                           string_ref path,
+                           ready_func on_ready = {});
+
+    /**
+     * @brief Hand loaded textures to staging and report uploaded and failed ones (call on main thread)
+     * @return ui32    Number of ready textures
+     */
+    ui32 update();
+
+    /**
+     * @brief Get the placeholder texture
+     * @return texture::s_ptr    Placeholder texture
+     */
+    texture::s_ptr get_placeholder() const {
+        return m_placeholder;
+    }
+
+    /**
+     * @brief Get the number of pending requests
+     * @return ui32    Number of pending requests
+     */
+    ui32 pending() const {
+        return m_pending;
+    }
+
+    /**
+     * @brief Check if the texture stream is set up
+     * @return Texture stream is ready or not
+     */
+    bool ready() const {
+        return m_pool != nullptr;
+    }
+
+private:
+    /**
+     * @brief Loaded texture
+     */
+    struct result {
+        /// List of loaded textures
+        using list = std::vector<result>;
+
+        /// Loaded texture (nullptr: load failed)
+        texture::s_ptr texture;
+
+        /// Ready function
+        ready_func on_ready;
+
+        /// File path
+        string path;
+    };
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Staging for uploads
+    staging::ptr m_staging = nullptr;
+
+    /// Placeholder texture
+    texture::s_ptr m_placeholder;
+
+    /// Worker threads
+    std::unique_ptr<thread_pool> m_pool;
+
+    /// Mutex for loaded textures
+    std::mutex m_mutex;
+
+    /// Loaded textures
+    result::list m_done;
+
+    /// Textures in staging
+    result::list m_uploading;
+
+    /// Number of pending requests
+    std::atomic<ui32> m_pending = 0;
+};
+
+} // namespace lava
@@ -6,6 +6,7 @@
  */
 
 #include "liblava/asset/write_image.hpp"
+#include "liblava/asset/convert_image.hpp"
 #include "liblava/resource/format.hpp"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -48,35 +49,30 @@ bool write_image_png(device::ptr device,
     auto const width = size.x;
     auto const height = size.y;
 
-    u_data rgb_data(height * width * img_data_block_size);
     auto const rgb_data_format = VK_FORMAT_R8G8B8_UNORM;
     auto const rgb_data_block_size = format_block_size(rgb_data_format);
+    u_data rgb_data(height * width * rgb_data_block_size);
 
-    if (swizzle) {
-        for (auto y = 0u; y < height; ++y) {
-            auto const row_rgb = y * width * rgb_data_block_size;
-            auto const row_img = y * subResourceLayout.rowPitch;
-            for (auto x = 0u; x < width; ++x) {
-                rgb_data.addr[(x * rgb_data_block_size) + row_rgb] =
-                    img_data.addr[(x * img_data_block_size) + 2 + row_img];
-                rgb_data.addr[(x * rgb_data_block_size) + 1 + row_rgb] =
-                    img_data.addr[(x * img_data_block_size) + 1 + row_img];
-                rgb_data.addr[(x * rgb_data_block_size) + 2 + row_rgb] =
-                    img_data.addr[(x * img_data_block_size) + row_img];
-            }
+    for (auto y = 0u; y < height; ++y) {
+        auto const row_rgb = y * width * rgb_data_block_size;
+        auto const row_img = y * subResourceLayout.rowPitch;
+
+        if (img_data_block_size == 4) {
+            pack_rgba_rgb(reinterpret_cast<ui8 const*>(img_data.addr + row_img),
+                          reinterpret_cast<ui8*>(rgb_data.addr + row_rgb),
+                          width,
+                          swizzle,
+                          1);
+            continue;
         }
-    } else {
-        for (auto y = 0u; y < height; ++y) {
-            auto const row_rgb = y * width * rgb_data_block_size;
-            auto const row_img = y * subResourceLayout.rowPitch;
-            for (auto x = 0u; x < width; ++x) {
-                rgb_data.addr[(x * rgb_data_block_size) + row_rgb] =
-                    img_data.addr[(x * img_data_block_size) + row_img];
-                rgb_data.addr[(x * rgb_data_block_size) + 1 + row_rgb] =
-                    img_data.addr[(x * img_data_block_size) + 1 + row_img];
-                rgb_data.addr[(x * rgb_data_block_size) + 2 + row_rgb] =
-                    img_data.addr[(x * img_data_block_size) + 2 + row_img];
-            }
+
+        for (auto x = 0u; x < width; ++x) {
+            auto const pixel_rgb = (x * rgb_data_block_size) + row_rgb;
+            auto const pixel_img = (x * img_data_block_size) + row_img;
+
+            rgb_data.addr[pixel_rgb] = img_data.addr[pixel_img + (swizzle ? 2 : 0)];
+            rgb_data.addr[pixel_rgb + 1] = img_data.addr[pixel_img + 1];
+            rgb_data.addr[pixel_rgb + 2] = img_data.addr[pixel_img + (swizzle ? 0 : 2)];
         }
     }
 
@@ -90,4 +86,21 @@ bool write_image_png(device::ptr device,
                           width * rgb_data_block_size);
 }
 
+//-----------------------------------------------------------------------------
+bool write_image_png(image_data::s_ptr image,
+                     string_ref filename) {
+    if (!image || !image->ready() || (image->channel_size != 1))
+        return false;
+
+    auto const width = to_i32(image->dimensions.x);
+    auto const channels = to_i32(image->channels);
+
+    return stbi_write_png(str(filename),
+                          width,
+                          to_i32(image->dimensions.y),
+                          channels,
+                          image->get_data(),
+                          width * channels);
+}
+
 } // namespace lava
@@ -24,4 +24,13 @@ bool write_image_png(device::ptr device,
                      string_ref filename,
                      bool swizzle);
 
+/**
+ * @brief Write 8-bit image data to png file
+ * @param image       Image data to write
+ * @param filename    File to write
+ * @return Write was successful or failed
+ */
+bool write_image_png(image_data::s_ptr image,
+                     string_ref filename);
+
 } // namespace lava
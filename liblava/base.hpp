@@ -8,6 +8,7 @@
 #pragma once
 
 #include "liblava/base/base.hpp"
+#include "liblava/base/cmd_state.hpp"
 #include "liblava/base/debug_utils.hpp"
 #include "liblava/base/device.hpp"
 #include "liblava/base/device_table.hpp"
@@ -65,6 +65,9 @@ using VkDescriptorSetLayouts = std::vector<VkDescriptorSetLayout>;
 /// List of Vulkan descriptor set layout bindings
 using VkDescriptorSetLayoutBindings = std::vector<VkDescriptorSetLayoutBinding>;
 
+/// List of Vulkan descriptor pools
+using VkDescriptorPools = std::vector<VkDescriptorPool>;
+
 /// List of Vulkan descriptor pool sizes
 using VkDescriptorPoolSizes = std::vector<VkDescriptorPoolSize>;
 
@@ -0,0 +1,399 @@
+/**
+ * @file         liblava/base/cmd_state.cpp
+ * @brief        Command buffer state tracker
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/base/cmd_state.hpp"
+#include <cstring>
+#include <utility>
+
+namespace lava {
+
+namespace {
+
+/// Active command state of this thread
+thread_local cmd_state::ptr active_state = nullptr;
+
+/// Frame transient mark of this thread
+thread_local bool transient_recorded = false;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+cmd_state::cmd_state(VkCommandBuffer cmd_buf)
+: m_cmd_buf(cmd_buf), m_previous(active_state) {
+    active_state = this;
+}
+
+//-----------------------------------------------------------------------------
+cmd_state::~cmd_state() {
+    active_state = m_previous;
+}
+
+//-----------------------------------------------------------------------------
+cmd_state::ptr cmd_state::current(VkCommandBuffer cmd_buf) {
+    for (auto state = active_state; state; state = state->m_previous)
+        if (state->m_cmd_buf == cmd_buf)
+            return state;
+
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+cmd_state::bind_point_state* cmd_state::get_bind_point(VkPipelineBindPoint bind_point) {
+    if (bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+        return &m_bind_points[0];
+
+    if (bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
+        return &m_bind_points[1];
+
+    return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::bind_pipeline(VkPipelineBindPoint bind_point,
+                              VkPipeline pipeline) {
+    auto state = get_bind_point(bind_point);
+    if (state) {
+        if (state->pipeline == pipeline) {
+            ++m_elided_count;
+            return;
+        }
+
+        state->pipeline = pipeline;
+    }
+
+    // static state of the new pipeline may overwrite dynamic state
+    if (bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) {
+        m_viewport_set = false;
+        m_scissor_set = false;
+        m_line_width = -1.f;
+    }
+
+    vkCmdBindPipeline(m_cmd_buf, bind_point, pipeline);
+    ++m_issued_count;
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::bind_descriptor_sets(VkPipelineBindPoint bind_point,
+                                     VkPipelineLayout layout,
+                                     ui32 first_set,
+                                     ui32 set_count,
+                                     VkDescriptorSet const* sets,
+                                     ui32 dynamic_offset_count,
+                                     ui32 const* dynamic_offsets) {
+    auto state = get_bind_point(bind_point);
+    if (state && (dynamic_offset_count == 0)
+        && (first_set + set_count <= max_sets)) {
+        auto redundant = true;
+        for (auto i = 0u; i < set_count; ++i) {
+            if ((state->layouts[first_set + i] != layout)
+                || (state->sets[first_set + i] != sets[i])) {
+                redundant = false;
+                break;
+            }
+        }
+
+        if (redundant) {
+            ++m_elided_count;
+            return;
+        }
+    }
+
+    vkCmdBindDescriptorSets(m_cmd_buf,
+                            bind_point,
+                            layout,
+                            first_set,
+                            set_count,
+                            sets,
+                            dynamic_offset_count,
+                            dynamic_offsets);
+    ++m_issued_count;
+
+    if (!state)
+        return;
+
+    // sets bound with another layout may be disturbed
+    for (auto i = 0u; i < max_sets; ++i) {
+        if (state->layouts[i] != layout) {
+            state->layouts[i] = VK_NULL_HANDLE;
+            state->sets[i] = VK_NULL_HANDLE;
+        }
+    }
+
+    for (auto i = 0u; i < set_count; ++i) {
+        auto const set = first_set + i;
+        if (set >= max_sets)
+            break;
+
+        state->layouts[set] = layout;
+        state->sets[set] = (dynamic_offset_count == 0) ? sets[i]
+                                                       : VK_NULL_HANDLE;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::bind_vertex_buffers(ui32 first_binding,
+                                    ui32 binding_count,
+                                    VkBuffer const* buffers,
+                                    VkDeviceSize const* offsets) {
+    if (first_binding + binding_count <= max_vertex_bindings) {
+        auto redundant = true;
+        for (auto i = 0u; i < binding_count; ++i) {
+            auto const& binding = m_vertex_bindings[first_binding + i];
+            if ((binding.buffer != buffers[i])
+                || (binding.offset != offsets[i])) {
+                redundant = false;
+                break;
+            }
+        }
+
+        if (redundant) {
+            ++m_elided_count;
+            return;
+        }
+    }
+
+    vkCmdBindVertexBuffers(m_cmd_buf,
+                           first_binding,
+                           binding_count,
+                           buffers,
+                           offsets);
+    ++m_issued_count;
+
+    for (auto i = 0u; i < binding_count; ++i) {
+        if (first_binding + i >= max_vertex_bindings)
+            break;
+
+        m_vertex_bindings[first_binding + i] = {buffers[i], offsets[i]};
+    }
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::bind_index_buffer(VkBuffer buffer,
+                                  VkDeviceSize offset,
+                                  VkIndexType index_type) {
+    if ((m_index_buffer == buffer)
+        && (m_index_offset == offset)
+        && (m_index_type == index_type)) {
+        ++m_elided_count;
+        return;
+    }
+
+    vkCmdBindIndexBuffer(m_cmd_buf, buffer, offset, index_type);
+    ++m_issued_count;
+
+    m_index_buffer = buffer;
+    m_index_offset = offset;
+    m_index_type = index_type;
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::set_viewport(VkViewport const& viewport) {
+    if (m_viewport_set
+        && (std::memcmp(&m_viewport, &viewport, sizeof(VkViewport)) == 0)) {
+        ++m_elided_count;
+        return;
+    }
+
+    vkCmdSetViewport(m_cmd_buf, 0, 1, &viewport);
+    ++m_issued_count;
+
+    m_viewport = viewport;
+    m_viewport_set = true;
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::set_scissor(VkRect2D const& scissor) {
+    if (m_scissor_set
+        && (std::memcmp(&m_scissor, &scissor, sizeof(VkRect2D)) == 0)) {
+        ++m_elided_count;
+        return;
+    }
+
+    vkCmdSetScissor(m_cmd_buf, 0, 1, &scissor);
+    ++m_issued_count;
+
+    m_scissor = scissor;
+    m_scissor_set = true;
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::set_line_width(r32 width) {
+    if (m_line_width == width) {
+        ++m_elided_count;
+        return;
+    }
+
+    vkCmdSetLineWidth(m_cmd_buf, width);
+    ++m_issued_count;
+
+    m_line_width = width;
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::push_constants(VkPipelineLayout layout,
+                               VkShaderStageFlags stages,
+                               ui32 offset,
+                               ui32 size,
+                               void const* values) {
+    auto const tracked = offset + size <= max_push_constant_size;
+    auto const bytes = static_cast<ui8 const*>(values);
+
+    if (tracked && (m_push_layout == layout)) {
+        auto redundant = true;
+        for (auto i = 0u; i < size; ++i) {
+            if (m_push_stages[offset + i] != stages) {
+                redundant = false;
+                break;
+            }
+        }
+
+        if (redundant
+            && (std::memcmp(m_push_data.data() + offset, bytes, size) == 0)) {
+            ++m_elided_count;
+            return;
+        }
+    }
+
+    vkCmdPushConstants(m_cmd_buf, layout, stages, offset, size, values);
+    ++m_issued_count;
+
+    if (m_push_layout != layout) {
+        m_push_layout = layout;
+        m_push_stages.fill(0);
+    }
+
+    if (!tracked) {
+        m_push_layout = VK_NULL_HANDLE;
+        return;
+    }
+
+    std::fill_n(m_push_stages.begin() + offset, size, stages);
+    std::memcpy(m_push_data.data() + offset, bytes, size);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_state::invalidate() {
+    m_bind_points = {};
+    m_vertex_bindings = {};
+
+    m_index_buffer = VK_NULL_HANDLE;
+    m_index_offset = 0;
+    m_index_type = VK_INDEX_TYPE_UINT32;
+
+    m_viewport_set = false;
+    m_scissor_set = false;
+    m_line_width = -1.f;
+
+    m_push_layout = VK_NULL_HANDLE;
+    m_push_stages.fill(0);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_bind_pipeline(VkCommandBuffer cmd_buf,
+                       VkPipelineBindPoint bind_point,
+                       VkPipeline pipeline) {
+    if (auto state = cmd_state::current(cmd_buf))
+        state->bind_pipeline(bind_point, pipeline);
+    else
+        vkCmdBindPipeline(cmd_buf, bind_point, pipeline);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_bind_descriptor_sets(VkCommandBuffer cmd_buf,
+                              VkPipelineBindPoint bind_point,
+                              VkPipelineLayout layout,
+                              ui32 first_set,
+                              ui32 set_count,
+                              VkDescriptorSet const* sets,
+                              ui32 dynamic_offset_count,
+                              ui32 const* dynamic_offsets) {
+    if (auto state = cmd_state::current(cmd_buf))
+        state->bind_descriptor_sets(bind_point, layout,
+                                    first_set, set_count, sets,
+                                    dynamic_offset_count, dynamic_offsets);
+    else
+        vkCmdBindDescriptorSets(cmd_buf, bind_point, layout,
+                                first_set, set_count, sets,
+                                dynamic_offset_count, dynamic_offsets);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_bind_vertex_buffers(VkCommandBuffer cmd_buf,
+                             ui32 first_binding,
+                             ui32 binding_count,
+                             VkBuffer const* buffers,
+                             VkDeviceSize const* offsets) {
+    if (auto state = cmd_state::current(cmd_buf))
+        state->bind_vertex_buffers(first_binding, binding_count,
+                                   buffers, offsets);
+    else
+        vkCmdBindVertexBuffers(cmd_buf, first_binding, binding_count,
+                               buffers, offsets);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_bind_index_buffer(VkCommandBuffer cmd_buf,
+                           VkBuffer buffer,
+                           VkDeviceSize offset,
+                           VkIndexType index_type) {
+    if (auto state = cmd_state::current(cmd_buf))
+        state->bind_index_buffer(buffer, offset, index_type);
+    else
+        vkCmdBindIndexBuffer(cmd_buf, buffer, offset, index_type);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_set_viewport(VkCommandBuffer cmd_buf,
+                      VkViewport const& viewport) {
+    if (auto state = cmd_state::current(cmd_buf))
+        state->set_viewport(viewport);
+    else
+        vkCmdSetViewport(cmd_buf, 0, 1, &viewport);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_set_scissor(VkCommandBuffer cmd_buf,
+                     VkRect2D const& scissor) {
+    if (auto state = cmd_state::current(cmd_buf))
+        state->set_scissor(scissor);
+    else
+        vkCmdSetScissor(cmd_buf, 0, 1, &scissor);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_set_line_width(VkCommandBuffer cmd_buf,
+                        r32 width) {
+    if (auto state = cmd_state::current(cmd_buf))
+        state->set_line_width(width);
+    else
+        vkCmdSetLineWidth(cmd_buf, width);
+}
+
+//-----------------------------------------------------------------------------
+void cmd_push_constants(VkCommandBuffer cmd_buf,
+                        VkPipelineLayout layout,
+                        VkShaderStageFlags stages,
+                        ui32 offset,
+                        ui32 size,
+                        void const* values) {
+    if (auto state = cmd_state::current(cmd_buf))
+        state->push_constants(layout, stages, offset, size, values);
+    else
+        vkCmdPushConstants(cmd_buf, layout, stages, offset, size, values);
+}
+
+//-----------------------------------------------------------------------------
+void mark_cmd_transient() {
+    transient_recorded = true;
+}
+
+//-----------------------------------------------------------------------------
+bool take_cmd_transient() {
+    return std::exchange(transient_recorded, false);
+}
+
+} // namespace lava
@@ -0,0 +1,365 @@
+/**
+ * @file         liblava/base/cmd_state.hpp
+ * @brief        Command buffer state tracker
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/base/base.hpp"
+#include <array>
+
+namespace lava {
+
+/**
+ * @brief Command buffer state tracker
+ * @note Active for its command buffer on the constructing thread until destroyed,
+ *       the cmd_* functions route through it and drop redundant calls.
+ *       Call invalidate after recording raw binds while it is active.
+ */
+struct cmd_state {
+    /// Pointer to command state
+    using ptr = cmd_state*;
+
+    /**
+     * @brief Construct a new command state and activate it on this thread
+     * @param cmd_buf    Command buffer
+     */
+    explicit cmd_state(VkCommandBuffer cmd_buf);
+
+    /**
+     * @brief Destroy the command state and restore the previous one
+     */
+    ~cmd_state();
+
+    /// No copy
+    cmd_state(cmd_state const&) = delete;
+
+    /// No copy assignment
+    cmd_state& operator=(cmd_state const&) = delete;
+
+    /**
+     * @brief Get the active command state of a command buffer on this thread
+     * @param cmd_buf    Command buffer
+     * @return ptr       Command state (nullptr: untracked)
+     */
+    static ptr current(VkCommandBuffer cmd_buf);
+
+    /**
+     * @brief Bind a pipeline
+     * @note A different graphics pipeline resets tracked viewport, scissor and line width
+     * @param bind_point    Pipeline bind point
+     * @param pipeline      Vulkan pipeline
+     */
+    void bind_pipeline(VkPipelineBindPoint bind_point,
+                       VkPipeline pipeline);
+
+    /**
+     * @brief Bind descriptor sets
+     * @note Binds with dynamic offsets are always issued
+     * @param bind_point              Pipeline bind point
+     * @param layout                  Pipeline layout
+     * @param first_set               First set
+     * @param set_count               Number of sets
+     * @param sets                    Descriptor sets
+     * @param dynamic_offset_count    Number of dynamic offsets
+     * @param dynamic_offsets         Dynamic offsets
+     */
+    void bind_descriptor_sets(VkPipelineBindPoint bind_point,
+                              VkPipelineLayout layout,
+                              ui32 first_set,
+                              ui32 set_count,
+                              VkDescriptorSet const* sets,
+                              ui32 dynamic_offset_count,
+                              ui32 const* dynamic_offsets);
+
+    /**
+     * @brief Bind vertex buffers
+     * @param first_binding    First binding
+     * @param binding_count    Number of bindings
+     * @param buffers          Vertex buffers
+     * @param offsets          Buffer offsets
+     */
+    void bind_vertex_buffers(ui32 first_binding,
+                             ui32 binding_count,
+                             VkBuffer const* buffers,
+                             VkDeviceSize const* offsets);
+
+    /**
+     * @brief Bind an index buffer
+     * @param buffer        Index buffer
+     * @param offset        Buffer offset
+     * @param index_type    Index type
+     */
+    void bind_index_buffer(VkBuffer buffer,
+                           VkDeviceSize offset,
+                           VkIndexType index_type);
+
+    /**
+     * @brief Set the viewport 0
+     * @param viewport    Viewport
+     */
+    void set_viewport(VkViewport const& viewport);
+
+    /**
+     * @brief Set the scissor 0
+     * @param scissor    Scissor
+     */
+    void set_scissor(VkRect2D const& scissor);
+
+    /**
+     * @brief Set the line width
+     * @param width    Line width
+     */
+    void set_line_width(r32 width);
+
+    /**
+     * @brief Push constants
+     * @note Compared byte by byte per range of the bound layout
+     * @param layout    Pipeline layout
+     * @param stages    Shader stages
+     * @param offset    Offset in bytes
+     * @param size      Size in bytes
+     * @param values    Constant data
+     */
+    void push_constants(VkPipelineLayout layout,
+                        VkShaderStageFlags stages,
+                        ui32 offset,
+                        ui32 size,
+                        void const* values);
+
+    /**
+     * @brief Forget all tracked state (next calls are issued)
+     */
+    void invalidate();
+
+    /**
+     * @brief Get the command buffer
+     * @return VkCommandBuffer    Command buffer
+     */
+    VkCommandBuffer get() const {
+        return m_cmd_buf;
+    }
+
+    /**
+     * @brief Get the number of issued calls
+     * @return ui32    Number of issued calls
+     */
+    ui32 get_issued_count() const {
+        return m_issued_count;
+    }
+
+    /**
+     * @brief Get the number of elided calls
+     * @return ui32    Number of redundant calls
+     */
+    ui32 get_elided_count() const {
+        return m_elided_count;
+    }
+
+private:
+    /// Maximum number of tracked descriptor sets per bind point
+    static constexpr ui32 max_sets = 8;
+
+    /// Maximum number of tracked vertex bindings
+    static constexpr ui32 max_vertex_bindings = 8;
+
+    /// Maximum size of tracked push constants in bytes
+    static constexpr ui32 max_push_constant_size = 256;
+
+    /**
+     * @brief Bind point state
+     */
+    struct bind_point_state {
+        /// Bound pipeline
+        VkPipeline pipeline = VK_NULL_HANDLE;
+
+        /// Layout of bound descriptor sets
+        std::array<VkPipelineLayout, max_sets> layouts{};
+
+        /// Bound descriptor sets
+        std::array<VkDescriptorSet, max_sets> sets{};
+    };
+
+    /**
+     * @brief Vertex binding state
+     */
+    struct vertex_binding {
+        /// Bound buffer
+        VkBuffer buffer = VK_NULL_HANDLE;
+
+        /// Buffer offset
+        VkDeviceSize offset = 0;
+    };
+
+    /**
+     * @brief Get the tracked state of a bind point
+     * @param bind_point             Pipeline bind point
+     * @return bind_point_state*     Bind point state (nullptr: untracked)
+     */
+    bind_point_state* get_bind_point(VkPipelineBindPoint bind_point);
+
+    /// Command buffer
+    VkCommandBuffer m_cmd_buf = VK_NULL_HANDLE;
+
+    /// Previous active command state on this thread
+    ptr m_previous = nullptr;
+
+    /// Graphics and compute bind points
+    std::array<bind_point_state, 2> m_bind_points;
+
+    /// Vertex bindings
+    std::array<vertex_binding, max_vertex_bindings> m_vertex_bindings;
+
+    /// Index buffer
+    VkBuffer m_index_buffer = VK_NULL_HANDLE;
+
+    /// Index buffer offset
+    VkDeviceSize m_index_offset = 0;
+
+    /// Index type
+    VkIndexType m_index_type = VK_INDEX_TYPE_UINT32;
+
+    /// Viewport state
+    VkViewport m_viewport{};
+
+    /// Viewport is set
+    bool m_viewport_set = false;
+
+    /// Scissor state
+    VkRect2D m_scissor{};
+
+    /// Scissor is set
+    bool m_scissor_set = false;
+
+    /// Line width (negative: not set)
+    r32 m_line_width = -1.f;
+
+    /// Layout of pushed constants
+    VkPipelineLayout m_push_layout = VK_NULL_HANDLE;
+
+    /// Stages of pushed bytes
+    std::array<VkShaderStageFlags, max_push_constant_size> m_push_stages{};
+
+    /// Pushed bytes
+    std::array<ui8, max_push_constant_size> m_push_data{};
+
+    /// Number of issued calls
+    ui32 m_issued_count = 0;
+
+    /// Number of elided calls
+    ui32 m_elided_count = 0;
+};
+
+/**
+ * @brief Bind a pipeline (tracked if active)
+ * @param cmd_buf       Command buffer
+ * @param bind_point    Pipeline bind point
+ * @param pipeline      Vulkan pipeline
+ */
+void cmd_bind_pipeline(VkCommandBuffer cmd_buf,
+                       VkPipelineBindPoint bind_point,
+                       VkPipeline pipeline);
+
+/**
+ * @brief Bind descriptor sets (tracked if active)
+ * @param cmd_buf                 Command buffer
+ * @param bind_point              Pipeline bind point
+ * @param layout                  Pipeline layout
+ * @param first_set               First set
+ * @param set_count               Number of sets
+ * @param sets                    Descriptor sets
+ * @param dynamic_offset_count    Number of dynamic offsets
+ * @param dynamic_offsets         Dynamic offsets
+ */
+void cmd_bind_descriptor_sets(VkCommandBuffer cmd_buf,
+                              VkPipelineBindPoint bind_point,
+                              VkPipelineLayout layout,
+                              ui32 first_set,
+                              ui32 set_count,
+                              VkDescriptorSet const* sets,
+                              ui32 dynamic_offset_count = 0,
+                              ui32 const* dynamic_offsets = nullptr);
+
+/**
+ * @brief Bind vertex buffers (tracked if active)
+ * @param cmd_buf          Command buffer
+ * @param first_binding    First binding
+ * @param binding_count    Number of bindings
+ * @param buffers          Vertex buffers
+ * @param offsets          Buffer offsets
+ */
+void cmd_bind_vertex_buffers(VkCommandBuffer cmd_buf,
+                             ui32 first_binding,
+                             ui32 binding_count,
+                             VkBuffer const* buffers,
+                             VkDeviceSize const* offsets);
+
+/**
+ * @brief Bind an index buffer (tracked if active)
+ * @param cmd_buf       Command buffer
+ * @param buffer        Index buffer
+ * @param offset        Buffer offset
+ * @param index_type    Index type
+ */
+void cmd_bind_index_buffer(VkCommandBuffer cmd_buf,
+                           VkBuffer buffer,
+                           VkDeviceSize offset,
+                           VkIndexType index_type);
+
+/**
+ * @brief Set the viewport 0 (tracked if active)
+ * @param cmd_buf     Command buffer
+ * @param viewport    Viewport
+ */
+void cmd_set_viewport(VkCommandBuffer cmd_buf,
+                      VkViewport const& viewport);
+
+/**
+ * @brief Set the scissor 0 (tracked if active)
+ * @param cmd_buf    Command buffer
+ * @param scissor    Scissor
+ */
+void cmd_set_scissor(VkCommandBuffer cmd_buf,
+                     VkRect2D const& scissor);
+
+/**
+ * @brief Set the line width (tracked if active)
+ * @param cmd_buf    Command buffer
+ * @param width      Line width
+ */
+void cmd_set_line_width(VkCommandBuffer cmd_buf,
+                        r32 width);
+
+/**
+ * @brief Push constants (tracked if active)
+ * @param cmd_buf    Command buffer
+ * @param layout     Pipeline layout
+ * @param stages     Shader stages
+ * @param offset     Offset in bytes
+ * @param size       Size in bytes
+ * @param values     Constant data
+ */
+void cmd_push_constants(VkCommandBuffer cmd_buf,
+                        VkPipelineLayout layout,
+                        VkShaderStageFlags stages,
+                        ui32 offset,
+                        ui32 size,
+                        void const* values);
+
+/**
+ * @brief Mark the recording on this thread as frame transient
+ * @note Called by work that is only valid in the frame it is recorded
+ *       (secondary subpasses, staging, readback, render queue),
+ *       static block commands containing it are recorded every frame
+ */
+void mark_cmd_transient();
+
+/**
+ * @brief Get and reset the frame transient mark of this thread
+ * @return Recording was marked since the last call or not
+ */
+bool take_cmd_transient();
+
+} // namespace lava
@@ -51,6 +51,57 @@ void log_verify_queues_failed(verify_queues_result result) {
     }
 }
 
+/**
+ * @brief Check if a structure is in a pNext chain
+ * @param next    Chain of structures
+ * @param type    Structure type
+ * @return Structure is chained or not
+ */
+bool chained_structure(void const* next,
+                       VkStructureType type) {
+    for (auto item = static_cast<VkBaseInStructure const*>(next);
+         item;
+         item = item->pNext)
+        if (item->sType == type)
+            return true;
+
+    return false;
+}
+
+/**
+ * @brief Check if descriptor indexing features allow bindless arrays
+ * @tparam T          Vulkan 1.2 or descriptor indexing features
+ * @param features    Device features
+ * @return Bindless arrays are supported or not
+ */
+template <typename T>
+bool bindless_features(T const& features) {
+    return features.descriptorBindingPartiallyBound
+           && features.descriptorBindingSampledImageUpdateAfterBind
+           && features.descriptorBindingStorageBufferUpdateAfterBind
+           && features.descriptorBindingUpdateUnusedWhilePending;
+}
+
+/**
+ * @brief Get the Vulkan API version usable on a physical device
+ * @param physical_device    Physical device
+ * @return ui32              Lower of instance and device API version
+ */
+ui32 effective_api_version(device::physical_device_c_ptr physical_device) {
+    return std::min(instance::singleton().get_api_version(),
+                    physical_device->get_properties().apiVersion);
+}
+
+/**
+ * @brief Check if physical device features 2 can be queried and extended
+ * @param api_version    Effective API version
+ * @return Vulkan 1.1 or VK_KHR_get_physical_device_properties2 is available
+ */
+bool physical_device_features_2(ui32 api_version) {
+    return (api_version >= VK_API_VERSION_1_1)
+           || instance::singleton().enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+}
+
 //-----------------------------------------------------------------------------
 void device::create_param::set_all_queues() {
     lava::set_all_queues(queue_family_infos,
@@ -108,15 +159,135 @@ bool device::create(create_param::ref param) {
         queue_create_info_list[i].pQueuePriorities = priorities.at(i).data();
     }
 
+    auto extensions = param.extensions;
+    auto next = param.next;
+
+    VkPhysicalDeviceDynamicRenderingFeatures const dynamic_rendering_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES,
+        .pNext = const_cast<void*>(param.next),
+        .dynamicRendering = VK_TRUE,
+    };
+
+    auto add_extension = [&](name extension) {
+        auto const requested = std::any_of(extensions.begin(), extensions.end(), [&](name item) {
+            return string(item) == extension;
+        });
+        if (!requested)
+            extensions.push_back(extension);
+    };
+
+    // all or none of the extensions are enabled
+    auto add_extensions = [&](names_ref list) {
+        for (auto extension : list)
+            if (!m_physical_device->supported(extension))
+                return false;
+
+        for (auto extension : list)
+            add_extension(extension);
+
+        return true;
+    };
+
+    auto const api_version = effective_api_version(m_physical_device);
+
+    // chained Vulkan 1.3 features must enable it themselves
+    if (param.dynamic_rendering
+        && !chained_structure(param.next, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES)
+        && !chained_structure(param.next, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES)) {
+        names dynamic_rendering_extensions{VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME};
+
+        // dependencies promoted to Vulkan 1.2 and 1.1
+        if (api_version < VK_API_VERSION_1_2) {
+            dynamic_rendering_extensions.push_back(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME);
+            dynamic_rendering_extensions.push_back(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME);
+        }
+        if (api_version < VK_API_VERSION_1_1) {
+            dynamic_rendering_extensions.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME);
+            dynamic_rendering_extensions.push_back(VK_KHR_MAINTENANCE2_EXTENSION_NAME);
+        }
+
+        if (api_version >= VK_API_VERSION_1_3) {
+            next = &dynamic_rendering_features;
+        } else if (physical_device_features_2(api_version)
+                   && add_extensions(dynamic_rendering_extensions)) {
+            next = &dynamic_rendering_features;
+        } else {
+            // render passes are used instead
+            logger()->warn("create device - dynamic rendering not supported");
+        }
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptor_indexing_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+    };
+
+    // chained Vulkan 1.2 features must enable it themselves
+    if (param.descriptor_indexing
+        && !chained_structure(param.next, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES)
+        && !chained_structure(param.next, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES)) {
+        auto const core = api_version >= VK_API_VERSION_1_2;
+
+        // core query needs Vulkan 1.1 on instance and device
+        PFN_vkGetPhysicalDeviceFeatures2 get_features_2 = nullptr;
+        if (api_version >= VK_API_VERSION_1_1)
+            get_features_2 = vkGetPhysicalDeviceFeatures2;
+        else if (physical_device_features_2(api_version))
+            get_features_2 = vkGetPhysicalDeviceFeatures2KHR;
+
+        names descriptor_indexing_extensions;
+        if (!core)
+            descriptor_indexing_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+        // dependency promoted to Vulkan 1.1
+        if (api_version < VK_API_VERSION_1_1)
+            descriptor_indexing_extensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+
+        auto const available = std::all_of(descriptor_indexing_extensions.begin(),
+                                           descriptor_indexing_extensions.end(),
+                                           [&](name extension) {
+                                               return m_physical_device->supported(extension);
+                                           });
+
+        VkPhysicalDeviceDescriptorIndexingFeatures supported{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        };
+
+        if (available && get_features_2) {
+            VkPhysicalDeviceFeatures2 features_2{
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                .pNext = &supported,
+            };
+            get_features_2(m_physical_device->get(), &features_2);
+        }
+
+        if (bindless_features(supported) && add_extensions(descriptor_indexing_extensions)) {
+            descriptor_indexing_features.pNext = const_cast<void*>(next);
+            descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing =
+                supported.shaderSampledImageArrayNonUniformIndexing;
+            descriptor_indexing_features.shaderStorageBufferArrayNonUniformIndexing =
+                supported.shaderStorageBufferArrayNonUniformIndexing;
+            descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            descriptor_indexing_features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+            descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            descriptor_indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+            descriptor_indexing_features.runtimeDescriptorArray =
+                supported.runtimeDescriptorArray;
+
+            next = &descriptor_indexing_features;
+        } else {
+            logger()->warn("create device - descriptor indexing not supported");
+        }
+    }
+
     VkDeviceCreateInfo create_info{
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .pNext = param.next,
+        .pNext = next,
         .queueCreateInfoCount = to_ui32(queue_create_info_list.size()),
         .pQueueCreateInfos = queue_create_info_list.data(),
         .enabledLayerCount = 0,
         .ppEnabledLayerNames = nullptr,
-        .enabledExtensionCount = to_ui32(param.extensions.size()),
-        .ppEnabledExtensionNames = param.extensions.data(),
+        .enabledExtensionCount = to_ui32(extensions.size()),
+        .ppEnabledExtensionNames = extensions.data(),
         .pEnabledFeatures = (param.has_features_2)
                                 ? nullptr
                                 : &param.features,
@@ -131,6 +302,51 @@ bool device::create(create_param::ref param) {
     }
 
     m_features = param.features;
+    m_synchronization2 = false;
+    m_timeline_semaphore = false;
+    m_dynamic_rendering = false;
+    m_descriptor_indexing = false;
+
+    // features enabled through the pNext chain
+    for (auto item = static_cast<VkBaseInStructure const*>(next);
+         item;
+         item = item->pNext) {
+        switch (item->sType) {
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2:
+            m_features = reinterpret_cast<VkPhysicalDeviceFeatures2 const*>(item)->features;
+            break;
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES:
+            if (reinterpret_cast<VkPhysicalDeviceVulkan12Features const*>(item)->timelineSemaphore)
+                m_timeline_semaphore = true;
+            if (bindless_features(*reinterpret_cast<VkPhysicalDeviceVulkan12Features const*>(item)))
+                m_descriptor_indexing = true;
+            break;
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES:
+            if (reinterpret_cast<VkPhysicalDeviceTimelineSemaphoreFeatures const*>(item)->timelineSemaphore)
+                m_timeline_semaphore = true;
+            break;
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES:
+            if (reinterpret_cast<VkPhysicalDeviceVulkan13Features const*>(item)->synchronization2)
+                m_synchronization2 = true;
+            if (reinterpret_cast<VkPhysicalDeviceVulkan13Features const*>(item)->dynamicRendering)
+                m_dynamic_rendering = true;
+            break;
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES:
+            if (reinterpret_cast<VkPhysicalDeviceSynchronization2Features const*>(item)->synchronization2)
+                m_synchronization2 = true;
+            break;
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES:
+            if (reinterpret_cast<VkPhysicalDeviceDynamicRenderingFeatures const*>(item)->dynamicRendering)
+                m_dynamic_rendering = true;
+            break;
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES:
+            if (bindless_features(*reinterpret_cast<VkPhysicalDeviceDescriptorIndexingFeatures const*>(item)))
+                m_descriptor_indexing = true;
+            break;
+        default:
+            break;
+        }
+    }
 
     load_table();
 
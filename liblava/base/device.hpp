@@ -59,6 +59,12 @@ struct device : device_table, entity {
         /// Create parameter next pointer (pNext)
         void const* next = nullptr;
 
+        /// Enable dynamic rendering (Vulkan 1.3 or VK_KHR_dynamic_rendering)
+        bool dynamic_rendering = false;
+
+        /// Enable descriptor indexing (Vulkan 1.2 or VK_EXT_descriptor_indexing)
+        bool descriptor_indexing = false;
+
         /// List of queue famiy infos
         queue_family_info::list queue_family_infos;
 
@@ -309,6 +315,40 @@ struct device : device_table, entity {
      */
     VkPhysicalDeviceProperties const& get_properties() const;
 
+    /**
+     * @brief Check if synchronization2 is enabled
+     * @return synchronization2 is enabled or not
+     */
+    bool has_synchronization2() const {
+        return m_synchronization2;
+    }
+
+    /**
+     * @brief Check if dynamic rendering is enabled
+     * @return Dynamic rendering is enabled or not
+     */
+    bool has_dynamic_rendering() const {
+        return m_dynamic_rendering;
+    }
+
+    /**
+     * @brief Check if descriptor indexing is enabled
+     * @note Partially bound, update after bind sampled image
+     *       and storage buffer arrays, update unused while pending
+     * @return Descriptor indexing is enabled or not
+     */
+    bool has_descriptor_indexing() const {
+        return m_descriptor_indexing;
+    }
+
+    /**
+     * @brief Check if timeline semaphores are enabled
+     * @return Timeline semaphores are enabled or not
+     */
+    bool has_timeline_semaphore() const {
+        return m_timeline_semaphore;
+    }
+
     /**
      * @brief Check if surface is supported by this device
      * @param surface    Surface to check
@@ -361,6 +401,18 @@ private:
     /// Device features
     VkPhysicalDeviceFeatures m_features{};
 
+    /// synchronization2 enabled
+    bool m_synchronization2 = false;
+
+    /// Timeline semaphores enabled
+    bool m_timeline_semaphore = false;
+
+    /// Dynamic rendering enabled
+    bool m_dynamic_rendering = false;
+
+    /// Descriptor indexing enabled
+    bool m_descriptor_indexing = false;
+
     /// Device allocator
     allocator::s_ptr m_mem_allocator;
 };
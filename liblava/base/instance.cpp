@@ -136,6 +136,9 @@ bool instance::create(create_param& param,
         application_info.apiVersion = VK_API_VERSION_1_0;
     }
 
+    m_api_version = application_info.apiVersion;
+    m_extensions = param.extensions;
+
     VkInstanceCreateInfo create_info{
         .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
         .pApplicationInfo = &application_info,
@@ -165,6 +168,11 @@ bool instance::create(create_param& param,
     return true;
 }
 
+//-----------------------------------------------------------------------------
+bool instance::enabled(name extension) const {
+    return exists(m_extensions, extension);
+}
+
 //-----------------------------------------------------------------------------
 void instance::destroy() {
     if (!m_vk_instance)
@@ -137,6 +137,21 @@ struct instance : no_copy_no_move {
         return m_info;
     }
 
+    /**
+     * @brief Get the Vulkan API version of the instance
+     * @return ui32    Vulkan API version
+     */
+    ui32 get_api_version() const {
+        return m_api_version;
+    }
+
+    /**
+     * @brief Check if an extension is enabled on the instance
+     * @param extension    Extension to check
+     * @return Extension is enabled or not
+     */
+    bool enabled(name extension) const;
+
 private:
     /**
      * @brief Construct a new instance
@@ -184,6 +199,12 @@ private:
     /// Instance information
     instance_info m_info;
 
+    /// Vulkan API version
+    ui32 m_api_version = VK_API_VERSION_1_0;
+
+    /// List of enabled extensions
+    names m_extensions;
+
     /// Debug utils messenger
     VkDebugUtilsMessengerEXT m_debug_messenger = VK_NULL_HANDLE;
 };
@@ -12,8 +12,11 @@
 #include "liblava/block/compute_pipeline.hpp"
 #include "liblava/block/def.hpp"
 #include "liblava/block/descriptor.hpp"
+#include "liblava/block/descriptor_allocator.hpp"
 #include "liblava/block/pipeline.hpp"
 #include "liblava/block/pipeline_layout.hpp"
+#include "liblava/block/render_graph.hpp"
 #include "liblava/block/render_pass.hpp"
 #include "liblava/block/render_pipeline.hpp"
+#include "liblava/block/render_queue.hpp"
 #include "liblava/block/subpass.hpp"
@@ -6,6 +6,7 @@
  */
 
 #include "liblava/block/block.hpp"
+#include "liblava/base/cmd_state.hpp"
 #include "liblava/core/misc.hpp"
 #include "liblava/util/log.hpp"
 
@@ -16,6 +17,7 @@ bool command::create(device::ptr device,
                      index frame_count,
                      VkCommandPools cmd_pools) {
     buffers.resize(frame_count);
+    dirty.assign(frame_count, true);
 
     for (auto i = 0u; i < frame_count; ++i) {
         VkCommandBufferAllocateInfo const allocate_info{
@@ -46,60 +48,149 @@ void command::destroy(device::ptr device,
 }
 
 //-----------------------------------------------------------------------------
-bool block::create(device::ptr dev,
-                   index frame_count,
-                   index queue_family) {
-    m_device = dev;
-
-    m_current_frame = 0;
+block::block() {
+    m_target_callback.on_created = [&](VkAttachmentsRef, rect::ref) {
+        set_dirty();
+        return true;
+    };
+    m_target_callback.on_destroyed = []() {};
+}
 
-    m_cmd_pools.resize(frame_count);
+//-----------------------------------------------------------------------------
+bool block::create_cmd_pools(VkCommandPools& pools,
+                             index frame_count,
+                             index queue_family,
+                             VkCommandPoolCreateFlags flags) {
+    pools.resize(frame_count);
 
     for (auto i = 0u; i < frame_count; ++i) {
         VkCommandPoolCreateInfo const create_info{
             .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-            .flags = 0,
+            .flags = flags,
             .queueFamilyIndex = queue_family,
         };
         if (failed(m_device->call().vkCreateCommandPool(m_device->get(),
                                                         &create_info,
                                                         memory::instance().alloc(),
-                                                        &m_cmd_pools.at(i)))) {
+                                                        &pools.at(i)))) {
             logger()->error("create block command pool");
             return false;
         }
     }
 
-    for (auto& [id, command] : m_commands)
-        if (!command->create(m_device, frame_count, m_cmd_pools))
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void block::destroy_cmd_pools(VkCommandPools& pools) {
+    for (auto i = 0u; i < pools.size(); ++i)
+        m_device->call().vkDestroyCommandPool(m_device->get(),
+                                              pools.at(i),
+                                              memory::instance().alloc());
+
+    pools.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool block::create(device::ptr dev,
+                   index frame_count,
+                   index queue_family,
+                   ui32 thread_count) {
+    m_device = dev;
+
+    m_current_frame = 0;
+
+    if (!create_cmd_pools(m_cmd_pools, frame_count, queue_family))
+        return false;
+
+    // static command buffers are reset one by one when recorded again
+    if (!create_cmd_pools(m_static_cmd_pools,
+                          frame_count,
+                          queue_family,
+                          VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT))
+        return false;
+
+    // each recording thread allocates from its own pools
+    m_thread_cmd_pools.resize(thread_count);
+    for (auto& pools : m_thread_cmd_pools)
+        if (!create_cmd_pools(pools, frame_count, queue_family))
+            return false;
+
+    if (thread_count > 0) {
+        m_pool = std::make_unique<thread_pool>();
+        m_pool->setup(thread_count);
+    }
+
+    m_next_thread = 0;
+
+    for (auto& command : m_cmd_order) {
+        auto& cmd = *m_commands.at(command->get_id());
+
+        assign_thread(cmd);
+
+        if (!cmd.create(m_device, frame_count, get_cmd_pools(cmd)))
             return false;
+    }
 
     return true;
 }
 
 //-----------------------------------------------------------------------------
 void block::destroy() {
+    if (m_pool) {
+        m_pool->teardown();
+        m_pool = nullptr;
+    }
+
     for (auto& [id, command] : m_commands)
-        command->destroy(m_device, m_cmd_pools);
+        command->destroy(m_device, get_cmd_pools(*command));
 
-    for (auto i = 0u; i < m_cmd_pools.size(); ++i)
-        m_device->call().vkDestroyCommandPool(m_device->get(),
-                                              m_cmd_pools.at(i),
-                                              memory::instance().alloc());
+    destroy_cmd_pools(m_cmd_pools);
+    destroy_cmd_pools(m_static_cmd_pools);
 
-    m_cmd_pools.clear();
+    for (auto& pools : m_thread_cmd_pools)
+        destroy_cmd_pools(pools);
+
+    m_thread_cmd_pools.clear();
     m_cmd_order.clear();
     m_commands.clear();
 }
 
 //-----------------------------------------------------------------------------
-id block::add_cmd(command::process_func func, bool active) {
+VkCommandPools const& block::get_cmd_pools(command const& cmd) const {
+    if (cmd.record_once)
+        return m_static_cmd_pools;
+
+    if (cmd.thread < m_thread_cmd_pools.size())
+        return m_thread_cmd_pools.at(cmd.thread);
+
+    return m_cmd_pools;
+}
+
+//-----------------------------------------------------------------------------
+void block::assign_thread(command& cmd) {
+    if (!cmd.independent || cmd.record_once || m_thread_cmd_pools.empty()) {
+        cmd.thread = no_index;
+        return;
+    }
+
+    cmd.thread = m_next_thread;
+    m_next_thread = (m_next_thread + 1) % get_thread_count();
+}
+
+//-----------------------------------------------------------------------------
+id block::add_cmd(command::process_func func,
+                  bool active,
+                  bool independent) {
     auto cmd = command::make();
     cmd->on_process = func;
     cmd->active = active;
+    cmd->independent = independent;
+
+    assign_thread(*cmd);
 
     if (m_device && !m_cmd_pools.empty())
-        if (!cmd->create(m_device, get_frame_count(), m_cmd_pools))
+        if (!cmd->create(m_device, get_frame_count(), get_cmd_pools(*cmd)))
             return undef_id;
 
     auto result = cmd->get_id();
@@ -110,19 +201,101 @@ id block::add_cmd(command::process_func func, bool active) {
     return result;
 }
 
+//-----------------------------------------------------------------------------
+id block::add_static_cmd(command::process_func func,
+                         bool active) {
+    auto cmd = command::make();
+    cmd->on_process = func;
+    cmd->active = active;
+    cmd->record_once = true;
+
+    if (m_device && !m_static_cmd_pools.empty())
+        if (!cmd->create(m_device, get_frame_count(), get_cmd_pools(*cmd)))
+            return undef_id;
+
+    auto result = cmd->get_id();
+
+    m_commands.emplace(result, cmd);
+    m_cmd_order.push_back(m_commands.at(result).get());
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+bool block::set_dirty(id::ref cmd_id) {
+    if (!m_commands.count(cmd_id))
+        return false;
+
+    auto& cmd = *m_commands.at(cmd_id);
+    cmd.dirty.assign(cmd.buffers.size(), true);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void block::set_dirty() {
+    for (auto& [id, command] : m_commands)
+        if (command->record_once)
+            command->dirty.assign(command->buffers.size(), true);
+}
+
 //-----------------------------------------------------------------------------
 void block::remove_cmd(id::ref cmd_id) {
     if (!m_commands.count(cmd_id))
         return;
 
     auto command = m_commands.at(cmd_id);
-    command->destroy(m_device, m_cmd_pools);
+    command->destroy(m_device, get_cmd_pools(*command));
 
     remove(m_cmd_order, (command::c_ptr)(command.get()));
 
     m_commands.erase(cmd_id);
 }
 
+//-----------------------------------------------------------------------------
+bool block::record(command const& cmd, index frame) {
+    auto cmd_buf = cmd.buffers.at(frame);
+
+    // static commands are submitted again
+    VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (cmd.record_once)
+        usage = 0;
+
+    VkCommandBufferBeginInfo const begin_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = usage,
+    };
+    if (failed(m_device->call().vkBeginCommandBuffer(cmd_buf, &begin_info)))
+        return false;
+
+    if (cmd.on_process)
+        cmd.on_process(cmd_buf);
+
+    if (failed(m_device->call().vkEndCommandBuffer(cmd_buf)))
+        return false;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool block::record_thread(index thread, index frame) {
+    if (failed(m_device->call().vkResetCommandPool(m_device->get(),
+                                                   m_thread_cmd_pools.at(thread).at(frame),
+                                                   0))) {
+        logger()->error("block reset thread command pool");
+        return false;
+    }
+
+    for (auto& command : m_cmd_order) {
+        if (!command->active || (command->thread != thread))
+            continue;
+
+        if (!record(*command, frame))
+            return false;
+    }
+
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 bool block::process(index frame) {
     m_current_frame = frame;
@@ -134,27 +307,41 @@ bool block::process(index frame) {
         return false;
     }
 
+    m_record_failed = false;
+
+    for (auto thread = 0u; thread < get_thread_count(); ++thread) {
+        m_pool->enqueue([&, thread](id::ref) {
+            if (!record_thread(thread, frame))
+                m_record_failed = true;
+        });
+    }
+
+    auto result = true;
+
     for (auto& command : m_cmd_order) {
-        if (!command->active)
+        if (!command->active || (command->thread != no_index))
             continue;
 
-        auto& cmd_buf = command->buffers.at(frame);
+        // static commands keep their recording until dirty
+        if (command->record_once && !command->dirty.at(frame))
+            continue;
 
-        VkCommandBufferBeginInfo const begin_info{
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        };
-        if (failed(m_device->call().vkBeginCommandBuffer(cmd_buf, &begin_info)))
-            return false;
+        take_cmd_transient();
 
-        if (command->on_process)
-            command->on_process(cmd_buf);
+        if (!record(*command, frame)) {
+            result = false;
+            break;
+        }
 
-        if (failed(m_device->call().vkEndCommandBuffer(cmd_buf)))
-            return false;
+        // frame transient contents fall back to recording every frame
+        if (command->record_once)
+            m_commands.at(command->get_id())->dirty.at(frame) = take_cmd_transient();
     }
 
-    return true;
+    if (m_pool)
+        m_pool->wait();
+
+    return result && !m_record_failed;
 }
 
 //-----------------------------------------------------------------------------
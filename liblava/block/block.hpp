@@ -8,6 +8,7 @@
 #pragma once
 
 #include "liblava/base/device.hpp"
+#include "liblava/util/thread.hpp"
 
 namespace lava {
 
@@ -39,6 +40,18 @@ struct command : entity {
     /// Active state
     bool active = true;
 
+    /// Record in parallel with other independent commands
+    bool independent = false;
+
+    /// Recording thread of independent command (no_index: caller)
+    index thread = no_index;
+
+    /// Record once per frame and reuse until dirty
+    bool record_once = false;
+
+    /// Frames to record again (record once)
+    std::vector<bool> dirty;
+
     /**
      * @brief Make a new command
      * @return s_ptr    Shared pointer to command
@@ -94,6 +107,11 @@ struct block : entity {
         return std::make_shared<block>();
     }
 
+    /**
+     * @brief Construct a new block
+     */
+    explicit block();
+
     /**
      * @brief Destroy the block
      */
@@ -106,11 +124,13 @@ struct block : entity {
      * @param device          Vulkan device
      * @param frame_count     Number of frames
      * @param queue_family    Queue family index
+     * @param thread_count    Number of threads recording independent commands (0: caller)
      * @return Create was successful or failed
      */
     bool create(device::ptr device,
                 index frame_count,
-                index queue_family);
+                index queue_family,
+                ui32 thread_count = 0);
 
     /**
      * @brief Destroy the block
@@ -128,16 +148,62 @@ struct block : entity {
     /**
      * @see add_command
      */
-    id add_cmd(command::process_func func, bool active = true);
+    id add_cmd(command::process_func func,
+               bool active = true,
+               bool independent = false);
 
     /**
      * @brief Add a command
+     * @note Independent commands must not share state with other commands while recording
+     * @param func           Command function
+     * @param active         Active state
+     * @param independent    Record in parallel with other independent commands
+     * @return id            Command id
+     */
+    id add_command(command::process_func func,
+                   bool active = true,
+                   bool independent = false) {
+        return add_cmd(func, active, independent);
+    }
+
+    /**
+     * @see add_static_command
+     */
+    id add_static_cmd(command::process_func func,
+                      bool active = true);
+
+    /**
+     * @brief Add a static command (recorded once per frame and reused)
+     * @note Mark the command dirty when its contents change.
+     *       Contents must not be frame transient (secondary subpasses, staging,
+     *       readback, render queue packets), such commands are recorded every frame
      * @param func      Command function
      * @param active    Active state
      * @return id       Command id
      */
-    id add_command(command::process_func func, bool active = true) {
-        return add_cmd(func, active);
+    id add_static_command(command::process_func func,
+                          bool active = true) {
+        return add_static_cmd(func, active);
+    }
+
+    /**
+     * @brief Mark a static command to be recorded again
+     * @param cmd_id    Command id
+     * @return Command was found or not
+     */
+    bool set_dirty(id::ref cmd_id);
+
+    /**
+     * @brief Mark all static commands to be recorded again
+     */
+    void set_dirty();
+
+    /**
+     * @brief Get the target callback (marks static commands dirty on target created)
+     * @return target_callback const&    Target callback
+     */
+    target_callback const& get_target_callback() const {
+        return m_target_callback;
     }
 
     /**
@@ -155,6 +221,7 @@ struct block : entity {
 
     /**
      * @brief Process the block
+     * @note Independent commands are recorded on threads while the others are recorded on caller
      * @param frame     Frame index
      * @return Process was successful or aborted
      */
@@ -240,7 +307,63 @@ struct block : entity {
         return m_device;
     }
 
+    /**
+     * @brief Get the number of recording threads
+     * @return ui32    Number of threads
+     */
+    ui32 get_thread_count() const {
+        return to_ui32(m_thread_cmd_pools.size());
+    }
+
 private:
+    /**
+     * @brief Create command pools for each frame
+     * @param pools           List of command pools
+     * @param frame_count     Number of frames
+     * @param queue_family    Queue family index
+     * @param flags           Command pool create flags
+     * @return Create was successful or failed
+     */
+    bool create_cmd_pools(VkCommandPools& pools,
+                          index frame_count,
+                          index queue_family,
+                          VkCommandPoolCreateFlags flags = 0);
+
+    /**
+     * @brief Destroy command pools
+     * @param pools    List of command pools
+     */
+    void destroy_cmd_pools(VkCommandPools& pools);
+
+    /**
+     * @brief Get the command pools a command allocates from
+     * @param cmd                       Command
+     * @return VkCommandPools const&    List of command pools
+     */
+    VkCommandPools const& get_cmd_pools(command const& cmd) const;
+
+    /**
+     * @brief Assign a recording thread to a command
+     * @param cmd    Command
+     */
+    void assign_thread(command& cmd);
+
+    /**
+     * @brief Record a command
+     * @param cmd      Command
+     * @param frame    Frame index
+     * @return Record was successful or failed
+     */
+    bool record(command const& cmd, index frame);
+
+    /**
+     * @brief Record independent commands of a thread
+     * @param thread    Thread index
+     * @param frame     Frame index
+     * @return Record was successful or failed
+     */
+    bool record_thread(index thread, index frame);
+
     /// Vulkan device
     device::ptr m_device = nullptr;
 
@@ -255,6 +378,24 @@ private:
 
     /// Ordered list of commands
     command::c_list m_cmd_order;
+
+    /// Command pools of each recording thread
+    std::vector<VkCommandPools> m_thread_cmd_pools;
+
+    /// Command pools of static commands (not reset)
+    VkCommandPools m_static_cmd_pools = {};
+
+    /// Target callback
+    target_callback m_target_callback;
+
+    /// Next thread for round robin assignment
+    index m_next_thread = 0;
+
+    /// Recording threads
+    std::unique_ptr<thread_pool> m_pool;
+
+    /// Recording failed on a thread
+    std::atomic<bool> m_record_failed = false;
 };
 
 } // namespace lava
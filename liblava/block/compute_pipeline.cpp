@@ -6,13 +6,14 @@
  */
 
 #include "liblava/block/compute_pipeline.hpp"
+#include "liblava/base/cmd_state.hpp"
 #include "liblava/util/log.hpp"
 
 namespace lava {
 
 //-----------------------------------------------------------------------------
 void compute_pipeline::bind(VkCommandBuffer cmd_buf) {
-    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, m_vk_pipeline);
+    cmd_bind_pipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, m_vk_pipeline);
 }
 
 //-----------------------------------------------------------------------------
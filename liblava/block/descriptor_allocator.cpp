@@ -0,0 +1,356 @@
+/**
+ * @file         liblava/block/descriptor_allocator.cpp
+ * @brief        Descriptor set allocator
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/block/descriptor_allocator.hpp"
+
+namespace lava {
+
+namespace {
+
+/// Maximum number of sets per pool
+constexpr ui32 max_sets_per_pool = 4096;
+
+/**
+ * @brief Check if descriptor type reads a buffer info
+ * @param type    Descriptor type
+ * @return Buffer descriptor or not
+ */
+bool buffer_descriptor(VkDescriptorType type) {
+    return (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+           || (type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+           || (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+           || (type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC);
+}
+
+/**
+ * @brief Check if descriptor type reads a texel buffer view
+ * @param type    Descriptor type
+ * @return Texel buffer descriptor or not
+ */
+bool texel_descriptor(VkDescriptorType type) {
+    return (type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER)
+           || (type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER);
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+size_t descriptor_cache::hash(VkDescriptorSetLayout layout,
+                              descriptor_write::list const& writes) {
+    auto result = hash_value(layout);
+
+    for (auto const& write : writes)
+        hash_value(result,
+                   write.binding,
+                   write.element,
+                   write.type,
+                   write.buffer_info.buffer,
+                   write.buffer_info.offset,
+                   write.buffer_info.range,
+                   write.image_info.sampler,
+                   write.image_info.imageView,
+                   write.image_info.imageLayout,
+                   write.texel_view);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+VkDescriptorSet descriptor_cache::find(size_t content_hash,
+                                       VkDescriptorSetLayout layout,
+                                       descriptor_write::list const& writes) const {
+    auto const it = m_entries.find(content_hash);
+    if (it == m_entries.end())
+        return VK_NULL_HANDLE;
+
+    for (auto const& entry : it->second)
+        if ((entry.layout == layout) && (entry.writes == writes))
+            return entry.descriptor_set;
+
+    return VK_NULL_HANDLE;
+}
+
+//-----------------------------------------------------------------------------
+void descriptor_cache::add(size_t content_hash,
+                           VkDescriptorSetLayout layout,
+                           descriptor_write::list const& writes,
+                           VkDescriptorSet descriptor_set) {
+    m_entries[content_hash].push_back({layout, writes, descriptor_set});
+    ++m_size;
+}
+
+//-----------------------------------------------------------------------------
+void descriptor_cache::clear() {
+    m_entries.clear();
+    m_size = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool descriptor_write::operator==(descriptor_write const& other) const {
+    return (binding == other.binding)
+           && (element == other.element)
+           && (type == other.type)
+           && (buffer_info.buffer == other.buffer_info.buffer)
+           && (buffer_info.offset == other.buffer_info.offset)
+           && (buffer_info.range == other.buffer_info.range)
+           && (image_info.sampler == other.image_info.sampler)
+           && (image_info.imageView == other.image_info.imageView)
+           && (image_info.imageLayout == other.image_info.imageLayout)
+           && (texel_view == other.texel_view);
+}
+
+//-----------------------------------------------------------------------------
+VkDescriptorPoolSizes default_descriptor_pool_sizes() {
+    return {
+        {VK_DESCRIPTOR_TYPE_SAMPLER, 1},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+        {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1},
+    };
+}
+
+//-----------------------------------------------------------------------------
+bool descriptor_allocator::create(device::ptr device,
+                                  index frame_count,
+                                  VkDescriptorPoolSizesRef sizes,
+                                  ui32 sets_per_pool) {
+    if (sizes.empty() || (sets_per_pool == 0))
+        return false;
+
+    m_device = device;
+    m_sizes = sizes;
+    m_sets_per_pool = std::min(sets_per_pool, max_sets_per_pool);
+
+    m_persistent.sets_per_pool = m_sets_per_pool;
+    m_cached.sets_per_pool = m_sets_per_pool;
+
+    m_frames.resize(frame_count);
+    for (auto& frame : m_frames)
+        frame.sets_per_pool = m_sets_per_pool;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void descriptor_allocator::destroy() {
+    if (!m_device)
+        return;
+
+    destroy(m_persistent);
+    destroy(m_cached);
+
+    for (auto& frame : m_frames)
+        destroy(frame);
+    m_frames.clear();
+
+    m_cache.clear();
+    m_cache_hit_count = 0;
+    m_cache_miss_count = 0;
+
+    m_sizes.clear();
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+VkDescriptorSet descriptor_allocator::allocate(VkDescriptorSetLayout layout) {
+    return allocate(m_persistent, layout);
+}
+
+//-----------------------------------------------------------------------------
+VkDescriptorSet descriptor_allocator::allocate_transient(VkDescriptorSetLayout layout,
+                                                         index frame) {
+    if (frame >= m_frames.size()) {
+        logger()->error("descriptor allocator frame {} out of range", frame);
+        return VK_NULL_HANDLE;
+    }
+
+    return allocate(m_frames[frame], layout);
+}
+
+//-----------------------------------------------------------------------------
+VkDescriptorSet descriptor_allocator::get(VkDescriptorSetLayout layout,
+                                          descriptor_write::list const& writes) {
+    auto const content_hash = descriptor_cache::hash(layout, writes);
+
+    if (auto cached = m_cache.find(content_hash, layout, writes)) {
+        ++m_cache_hit_count;
+        return cached;
+    }
+
+    auto descriptor_set = allocate(m_cached, layout);
+    if (!descriptor_set)
+        return VK_NULL_HANDLE;
+
+    update(descriptor_set, writes);
+
+    m_cache.add(content_hash, layout, writes, descriptor_set);
+    ++m_cache_miss_count;
+
+    return descriptor_set;
+}
+
+//-----------------------------------------------------------------------------
+void descriptor_allocator::update(VkDescriptorSet descriptor_set,
+                                  descriptor_write::list const& writes) {
+    std::vector<VkWriteDescriptorSet> write_sets;
+    write_sets.reserve(writes.size());
+
+    for (auto const& write : writes) {
+        VkWriteDescriptorSet write_set{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = descriptor_set,
+            .dstBinding = write.binding,
+            .dstArrayElement = write.element,
+            .descriptorCount = 1,
+            .descriptorType = write.type,
+        };
+
+        if (buffer_descriptor(write.type))
+            write_set.pBufferInfo = &write.buffer_info;
+        else if (texel_descriptor(write.type))
+            write_set.pTexelBufferView = &write.texel_view;
+        else
+            write_set.pImageInfo = &write.image_info;
+
+        write_sets.push_back(write_set);
+    }
+
+    if (!write_sets.empty())
+        m_device->vkUpdateDescriptorSets(to_ui32(write_sets.size()),
+                                         write_sets.data());
+}
+
+//-----------------------------------------------------------------------------
+void descriptor_allocator::reset(index frame) {
+    if (frame < m_frames.size())
+        reset(m_frames[frame]);
+}
+
+//-----------------------------------------------------------------------------
+void descriptor_allocator::clear_cache() {
+    reset(m_cached);
+    m_cache.clear();
+}
+
+//-----------------------------------------------------------------------------
+ui32 descriptor_allocator::get_pool_count() const {
+    auto result = to_ui32(m_persistent.ready.size() + m_persistent.full.size()
+                          + m_cached.ready.size() + m_cached.full.size());
+
+    for (auto const& frame : m_frames)
+        result += to_ui32(frame.ready.size() + frame.full.size());
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+VkDescriptorPool descriptor_allocator::create_pool(pool_chain& chain) {
+    auto const sets = chain.sets_per_pool;
+
+    VkDescriptorPoolSizes pool_sizes = m_sizes;
+    for (auto& pool_size : pool_sizes)
+        pool_size.descriptorCount *= sets;
+
+    VkDescriptorPoolCreateInfo const pool_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = sets,
+        .poolSizeCount = to_ui32(pool_sizes.size()),
+        .pPoolSizes = pool_sizes.data(),
+    };
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (failed(m_device->call().vkCreateDescriptorPool(m_device->get(),
+                                                       &pool_info,
+                                                       memory::instance().alloc(),
+                                                       &pool)))
+        return VK_NULL_HANDLE;
+
+    // next pool of chain grows
+    chain.sets_per_pool = std::min(sets * 2, max_sets_per_pool);
+    chain.ready.push_back(pool);
+
+    return pool;
+}
+
+//-----------------------------------------------------------------------------
+VkDescriptorSet descriptor_allocator::allocate(pool_chain& chain,
+                                               VkDescriptorSetLayout layout) {
+    if (!m_device)
+        return VK_NULL_HANDLE;
+
+    VkDescriptorSetAllocateInfo alloc_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &layout,
+    };
+
+    VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+
+    // retry once with a fresh pool
+    for (auto attempt = 0u; attempt < 2; ++attempt) {
+        auto pool = chain.ready.empty() ? create_pool(chain)
+                                        : chain.ready.back();
+        if (!pool)
+            return VK_NULL_HANDLE;
+
+        alloc_info.descriptorPool = pool;
+
+        auto const result = m_device->call().vkAllocateDescriptorSets(m_device->get(),
+                                                                      &alloc_info,
+                                                                      &descriptor_set);
+        if (result == VK_SUCCESS)
+            return descriptor_set;
+
+        if ((result != VK_ERROR_OUT_OF_POOL_MEMORY)
+            && (result != VK_ERROR_FRAGMENTED_POOL)) {
+            check(result);
+            return VK_NULL_HANDLE;
+        }
+
+        chain.full.push_back(pool);
+        chain.ready.pop_back();
+    }
+
+    logger()->error("descriptor allocator failed to allocate set from new pool");
+    return VK_NULL_HANDLE;
+}
+
+//-----------------------------------------------------------------------------
+void descriptor_allocator::reset(pool_chain& chain) {
+    for (auto& pool : chain.ready)
+        m_device->call().vkResetDescriptorPool(m_device->get(), pool, 0);
+
+    for (auto& pool : chain.full) {
+        m_device->call().vkResetDescriptorPool(m_device->get(), pool, 0);
+        chain.ready.push_back(pool);
+    }
+
+    chain.full.clear();
+}
+
+//-----------------------------------------------------------------------------
+void descriptor_allocator::destroy(pool_chain& chain) {
+    for (auto& pool : chain.ready)
+        m_device->call().vkDestroyDescriptorPool(m_device->get(),
+                                                 pool,
+                                                 memory::instance().alloc());
+
+    for (auto& pool : chain.full)
+        m_device->call().vkDestroyDescriptorPool(m_device->get(),
+                                                 pool,
+                                                 memory::instance().alloc());
+
+    chain.ready.clear();
+    chain.full.clear();
+    chain.sets_per_pool = m_sets_per_pool;
+}
+
+} // namespace lava
@@ -0,0 +1,322 @@
+/**
+ * @file         liblava/block/descriptor_allocator.hpp
+ * @brief        Descriptor set allocator
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/block/descriptor.hpp"
+#include <unordered_map>
+
+namespace lava {
+
+/**
+ * @brief Descriptor write of a set
+ */
+struct descriptor_write {
+    /// List of descriptor writes
+    using list = std::vector<descriptor_write>;
+
+    /// Binding index
+    index binding = 0;
+
+    /// Array element
+    index element = 0;
+
+    /// Descriptor type
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+    /// Buffer of buffer descriptors
+    VkDescriptorBufferInfo buffer_info{};
+
+    /// Image and sampler of image and sampler descriptors
+    VkDescriptorImageInfo image_info{};
+
+    /// Buffer view of texel buffer descriptors
+    VkBufferView texel_view = VK_NULL_HANDLE;
+
+    /**
+     * @brief Compare descriptor writes
+     * @param other    Other descriptor write
+     * @return Writes are equal or not
+     */
+    bool operator==(descriptor_write const& other) const;
+};
+
+/**
+ * @brief Cache of descriptor sets by layout and writes
+ * @note Keyed on raw handles, a destroyed resource whose handle is reused
+ *       hits the stale set (clear when written resources are destroyed).
+ *       Contents with equal hashes are told apart by their writes
+ */
+struct descriptor_cache {
+    /**
+     * @brief Hash a set content
+     * @param layout    Descriptor set layout
+     * @param writes    List of descriptor writes
+     * @return size_t   Content hash
+     */
+    static size_t hash(VkDescriptorSetLayout layout,
+                       descriptor_write::list const& writes);
+
+    /**
+     * @brief Find a cached set
+     * @param content_hash        Content hash
+     * @param layout              Descriptor set layout
+     * @param writes              List of descriptor writes
+     * @return VkDescriptorSet    Descriptor set (none: not cached)
+     */
+    VkDescriptorSet find(size_t content_hash,
+                         VkDescriptorSetLayout layout,
+                         descriptor_write::list const& writes) const;
+
+    /**
+     * @brief Add a set to the cache
+     * @param content_hash      Content hash
+     * @param layout            Descriptor set layout
+     * @param writes            List of descriptor writes
+     * @param descriptor_set    Descriptor set
+     */
+    void add(size_t content_hash,
+             VkDescriptorSetLayout layout,
+             descriptor_write::list const& writes,
+             VkDescriptorSet descriptor_set);
+
+    /**
+     * @brief Remove all sets
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of cached sets
+     * @return size_t    Number of sets
+     */
+    size_t size() const {
+        return m_size;
+    }
+
+private:
+    /// Cached sets by content hash
+    std::unordered_map<size_t, std::vector<cache_entry>> m_entries;
+
+    /// Number of cached sets
+    size_t m_size = 0;
+};
+
+/**
+ * @brief Default pool sizes of descriptor allocator (descriptors per set)
+ * @return VkDescriptorPoolSizes    Descriptor pool sizes
+ */
+VkDescriptorPoolSizes default_descriptor_pool_sizes();
+
+/**
+ * @brief Descriptor set allocator
+ * @note Persistent, cached and per-frame transient sets come from chains
+ *       of pools which grow when a pool runs out of memory (not thread safe)
+ */
+struct descriptor_allocator : entity {
+    /// Shared pointer to descriptor allocator
+    using s_ptr = std::shared_ptr<descriptor_allocator>;
+
+    /**
+     * @brief Make a new descriptor allocator
+     * @return s_ptr    Shared pointer to descriptor allocator
+     */
+    static s_ptr make() {
+        return std::make_shared<descriptor_allocator>();
+    }
+
+    /**
+     * @brief Destroy the descriptor allocator
+     */
+    ~descriptor_allocator() {
+        destroy();
+    }
+
+    /**
+     * @brief Create a new descriptor allocator
+     * @param device           Vulkan device
+     * @param frame_count      Number of frames with transient pools
+     * @param sizes            Pool sizes in descriptors per set
+     * @param sets_per_pool    Number of sets of first pool (doubled on growth)
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                index frame_count,
+                VkDescriptorPoolSizesRef sizes = default_descriptor_pool_sizes(),
+                ui32 sets_per_pool = 64);
+
+    /**
+     * @brief Destroy the descriptor allocator
+     */
+    void destroy();
+
+    /**
+     * @brief Allocate a persistent descriptor set
+     * @note Freed when the allocator is destroyed
+     * @param layout              Descriptor set layout
+     * @return VkDescriptorSet    Descriptor set (none: failed)
+     */
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+    /**
+     * @brief Allocate a transient descriptor set
+     * @note Valid until the frame is reset
+     * @param layout              Descriptor set layout
+     * @param frame               Frame index
+     * @return VkDescriptorSet    Descriptor set (none: failed)
+     */
+    VkDescriptorSet allocate_transient(VkDescriptorSetLayout layout,
+                                       index frame);
+
+    /**
+     * @brief Get a descriptor set with contents
+     * @note Identical layout and writes return the cached set.
+     *       Writes are compared by raw handle: call clear_cache when a written
+     *       buffer, image view, sampler or buffer view is destroyed
+     * @param layout              Descriptor set layout
+     * @param writes              List of descriptor writes
+     * @return VkDescriptorSet    Descriptor set (none: failed)
+     */
+    VkDescriptorSet get(VkDescriptorSetLayout layout,
+                        descriptor_write::list const& writes);
+
+    /**
+     * @brief Write descriptors of a set
+     * @param descriptor_set    Descriptor set
+     * @param writes            List of descriptor writes
+     */
+    void update(VkDescriptorSet descriptor_set,
+                descriptor_write::list const& writes);
+
+    /**
+     * @brief Reset all transient sets of a frame
+     * @note Call when the frame is no longer in use by the device
+     * @param frame    Frame index
+     */
+    void reset(index frame);
+
+    /**
+     * @brief Free all cached sets
+     * @note Required when resources of cached writes are destroyed
+     */
+    void clear_cache();
+
+    /**
+     * @brief Get the number of pools
+     * @return ui32    Number of pools of all chains
+     */
+    ui32 get_pool_count() const;
+
+    /**
+     * @brief Get the number of cache hits
+     * @return ui32    Number of reused sets
+     */
+    ui32 get_cache_hit_count() const {
+        return m_cache_hit_count;
+    }
+
+    /**
+     * @brief Get the number of cache misses
+     * @return ui32    Number of allocated cached sets
+     */
+    ui32 get_cache_miss_count() const {
+        return m_cache_miss_count;
+    }
+
+    /**
+     * @brief Get the device
+     * @return device::ptr    Vulkan device
+     */
+    device::ptr get_device() {
+        return m_device;
+    }
+
+private:
+    /**
+     * @brief Chain of descriptor pools
+     */
+    struct pool_chain {
+        /// Pools with free space
+        VkDescriptorPools ready;
+
+        /// Exhausted pools
+        VkDescriptorPools full;
+
+        /// Number of sets of next pool
+        ui32 sets_per_pool = 0;
+    };
+
+    /**
+     * @brief Cached descriptor set
+     */
+    struct cache_entry {
+        /// Descriptor set layout
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+
+        /// List of descriptor writes
+        descriptor_write::list writes;
+
+        /// Descriptor set
+        VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+    };
+
+    /**
+     * @brief Create a pool of a chain
+     * @param chain                Pool chain
+     * @return VkDescriptorPool    Descriptor pool (none: failed)
+     */
+    VkDescriptorPool create_pool(pool_chain& chain);
+
+    /**
+     * @brief Allocate a set from a chain
+     * @param chain               Pool chain
+     * @param layout              Descriptor set layout
+     * @return VkDescriptorSet    Descriptor set (none: failed)
+     */
+    VkDescriptorSet allocate(pool_chain& chain,
+                             VkDescriptorSetLayout layout);
+
+    /**
+     * @brief Reset all pools of a chain
+     * @param chain    Pool chain
+     */
+    void reset(pool_chain& chain);
+
+    /**
+     * @brief Destroy all pools of a chain
+     * @param chain    Pool chain
+     */
+    void destroy(pool_chain& chain);
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Pool sizes in descriptors per set
+    VkDescriptorPoolSizes m_sizes;
+
+    /// Number of sets of first pool
+    ui32 m_sets_per_pool = 0;
+
+    /// Pools of persistent sets
+    pool_chain m_persistent;
+
+    /// Pools of cached sets
+    pool_chain m_cached;
+
+    /// Pools of transient sets by frame
+    std::vector<pool_chain> m_frames;
+
+    /// Cached sets
+    descriptor_cache m_cache;
+
+    /// Number of cache hits
+    ui32 m_cache_hit_count = 0;
+
+    /// Number of cache misses
+    ui32 m_cache_miss_count = 0;
+};
+
+} // namespace lava
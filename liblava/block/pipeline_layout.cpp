@@ -6,6 +6,7 @@
  */
 
 #include "liblava/block/pipeline_layout.hpp"
+#include "liblava/base/cmd_state.hpp"
 #include <array>
 
 namespace lava {
@@ -53,14 +54,14 @@ void pipeline_layout::bind_descriptor_set(VkCommandBuffer cmd_buf,
                                           VkPipelineBindPoint bind_point) {
     std::array<VkDescriptorSet, 1> const descriptor_sets = {descriptor_set};
 
-    m_device->call().vkCmdBindDescriptorSets(cmd_buf,
-                                             bind_point,
-                                             m_layout,
-                                             first_set,
-                                             to_ui32(descriptor_sets.size()),
-                                             descriptor_sets.data(),
-                                             to_ui32(offsets.size()),
-                                             offsets.data());
+    cmd_bind_descriptor_sets(cmd_buf,
+                             bind_point,
+                             m_layout,
+                             first_set,
+                             to_ui32(descriptor_sets.size()),
+                             descriptor_sets.data(),
+                             to_ui32(offsets.size()),
+                             offsets.data());
 }
 
 } // namespace lava
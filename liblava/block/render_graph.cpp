@@ -0,0 +1,724 @@
+/**
+ * @file         liblava/block/render_graph.cpp
+ * @brief        Render graph
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/block/render_graph.hpp"
+#include "liblava/resource/format.hpp"
+#include "liblava/util/log.hpp"
+#include <numeric>
+
+namespace lava {
+
+namespace {
+
+/**
+ * @brief Synchronization of an image usage
+ */
+struct usage_info {
+    /// Image layout
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    /// Pipeline stages
+    VkPipelineStageFlags2 stage = 0;
+
+    /// Accesses
+    VkAccessFlags2 access = 0;
+
+    /// Write accesses (0: read only)
+    VkAccessFlags2 write_access = 0;
+
+    /// Image usage flags
+    VkImageUsageFlags image_usage = 0;
+};
+
+/**
+ * @brief Get the synchronization of an image usage
+ * @param usage          Image usage
+ * @return usage_info    Layout, stages and accesses
+ */
+usage_info get_usage_info(graph_usage usage) {
+    switch (usage) {
+    case graph_usage::color_attachment:
+        return {
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT
+                | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+        };
+
+    case graph_usage::depth_attachment:
+        return {
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT
+                | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+        };
+
+    case graph_usage::depth_read:
+        return {
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT
+                | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT
+                | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                | VK_ACCESS_2_SHADER_READ_BIT,
+            0,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                | VK_IMAGE_USAGE_SAMPLED_BIT,
+        };
+
+    case graph_usage::sampled:
+        return {
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT
+                | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            VK_ACCESS_2_SHADER_READ_BIT,
+            0,
+            VK_IMAGE_USAGE_SAMPLED_BIT,
+        };
+
+    case graph_usage::input_attachment:
+        return {
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT,
+            0,
+            VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+        };
+
+    case graph_usage::storage_read:
+        return {
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT
+                | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            VK_ACCESS_2_SHADER_READ_BIT,
+            0,
+            VK_IMAGE_USAGE_STORAGE_BIT,
+        };
+
+    case graph_usage::storage_write:
+        return {
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT
+                | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            VK_ACCESS_2_SHADER_READ_BIT
+                | VK_ACCESS_2_SHADER_WRITE_BIT,
+            VK_ACCESS_2_SHADER_WRITE_BIT,
+            VK_IMAGE_USAGE_STORAGE_BIT,
+        };
+
+    case graph_usage::transfer_src:
+        return {
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            VK_ACCESS_2_TRANSFER_READ_BIT,
+            0,
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        };
+
+    case graph_usage::transfer_dst:
+        return {
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        };
+    }
+
+    return {};
+}
+
+/**
+ * @brief Make an image memory barrier over all aspects
+ * @param img                       Target image
+ * @param src_stage                 Source stages (0: top of pipe)
+ * @param src_access                Source accesses
+ * @param dst_stage                 Destination stages
+ * @param dst_access                Destination accesses
+ * @param old_layout                Old image layout
+ * @param new_layout                New image layout
+ * @return VkImageMemoryBarrier2    Image memory barrier
+ */
+VkImageMemoryBarrier2 make_barrier(image::s_ptr const& img,
+                                   VkPipelineStageFlags2 src_stage,
+                                   VkAccessFlags2 src_access,
+                                   VkPipelineStageFlags2 dst_stage,
+                                   VkAccessFlags2 dst_access,
+                                   VkImageLayout old_layout,
+                                   VkImageLayout new_layout) {
+    auto range = img->get_subresource_range();
+    range.aspectMask = format_aspect_mask(img->get_format());
+
+    return {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .srcStageMask = src_stage ? src_stage
+                                  : VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+        .srcAccessMask = src_access,
+        .dstStageMask = dst_stage,
+        .dstAccessMask = dst_access,
+        .oldLayout = old_layout,
+        .newLayout = new_layout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = img->get(),
+        .subresourceRange = range,
+    };
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+index_list assign_alias_blocks(std::vector<alias_range> const& ranges) {
+    index_list order(ranges.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::stable_sort(order.begin(), order.end(), [&](index a, index b) {
+        return ranges[a].requirements.size > ranges[b].requirements.size;
+    });
+
+    /// Memory types and ranges of a block
+    struct alias_block {
+        ui32 memory_type_bits = 0;
+        index_list ranges;
+    };
+    std::vector<alias_block> blocks;
+
+    index_list result(ranges.size(), no_index);
+
+    for (auto r : order) {
+        auto const& range = ranges[r];
+
+        for (auto b = 0u; b < blocks.size(); ++b) {
+            auto& block = blocks[b];
+            if (!(block.memory_type_bits & range.requirements.memoryTypeBits))
+                continue;
+
+            auto const overlap = std::any_of(block.ranges.begin(), block.ranges.end(), [&](index other) {
+                return (range.first <= ranges[other].last) && (ranges[other].first <= range.last);
+            });
+            if (overlap)
+                continue;
+
+            block.memory_type_bits &= range.requirements.memoryTypeBits;
+            block.ranges.push_back(r);
+
+            result[r] = b;
+            break;
+        }
+
+        if (result[r] == no_index) {
+            result[r] = to_index(blocks.size());
+            blocks.push_back({range.requirements.memoryTypeBits, {r}});
+        }
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+render_graph::resource render_graph::add_image(string_ref name,
+                                               VkFormat format,
+                                               uv2 size,
+                                               VkImageUsageFlags usage) {
+    graph_image img;
+    img.name = name;
+    img.format = format;
+    img.size = size;
+    img.usage = usage;
+
+    m_images.push_back(std::move(img));
+    return to_index(m_images.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+render_graph::resource render_graph::import_image(string_ref name,
+                                                  image::s_ptr image,
+                                                  VkImageLayout initial_layout,
+                                                  VkImageLayout final_layout) {
+    graph_image img;
+    img.name = name;
+    img.imported = true;
+    img.initial_layout = initial_layout;
+    img.final_layout = final_layout;
+
+    m_images.push_back(std::move(img));
+
+    auto const res = to_index(m_images.size() - 1);
+    set_image(res, image);
+    return res;
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::set_image(resource res,
+                             image::s_ptr image) {
+    auto& img = m_images.at(res);
+    if (!img.imported) {
+        logger()->error("render graph image not imported: {}", img.name);
+        return;
+    }
+
+    img.img = image;
+
+    if (image) {
+        img.format = image->get_format();
+        img.size = image->get_size();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::set_size(resource res,
+                            uv2 size) {
+    m_images.at(res).size = size;
+}
+
+//-----------------------------------------------------------------------------
+index render_graph::add_pass(string_ref name,
+                             process_func func,
+                             bool side_effect) {
+    graph_pass pass;
+    pass.name = name;
+    pass.on_process = std::move(func);
+    pass.side_effect = side_effect;
+
+    m_passes.push_back(std::move(pass));
+    return to_index(m_passes.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::read(index pass,
+                        resource res,
+                        graph_usage usage) {
+    m_passes.at(pass).reads.push_back({res, usage, false});
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::write(index pass,
+                         resource res,
+                         graph_usage usage,
+                         bool preserve) {
+    m_passes.at(pass).writes.push_back({res, usage, preserve});
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::cull() {
+    std::vector<bool> needed(m_images.size(), false);
+
+    for (auto i = m_passes.size(); i-- > 0;) {
+        auto& pass = m_passes[i];
+
+        auto alive = pass.side_effect;
+        for (auto const& output : pass.writes)
+            if (m_images[output.res].imported || needed[output.res])
+                alive = true;
+
+        pass.culled = !alive;
+        if (pass.culled)
+            continue;
+
+        // overwritten content is not needed from earlier writers
+        for (auto const& output : pass.writes)
+            needed[output.res] = output.preserve;
+
+        for (auto const& input : pass.reads)
+            needed[input.res] = true;
+    }
+
+    m_order.clear();
+    for (auto i = 0u; i < m_passes.size(); ++i)
+        if (!m_passes[i].culled)
+            m_order.push_back(i);
+}
+
+//-----------------------------------------------------------------------------
+bool render_graph::schedule() {
+    cull();
+
+    for (auto& img : m_images) {
+        img.first = no_index;
+        img.last = no_index;
+        img.access_usage = 0;
+        img.stages = 0;
+        img.write_accesses = 0;
+        img.alias_stages = 0;
+        img.alias_accesses = 0;
+    }
+
+    std::vector<bool> written(m_images.size(), false);
+
+    for (auto position = 0u; position < m_order.size(); ++position) {
+        auto const& pass = m_passes[m_order[position]];
+
+        auto const use = [&](graph_access const& access) {
+            auto& img = m_images[access.res];
+            if (img.first == no_index)
+                img.first = position;
+            img.last = position;
+
+            auto const info = get_usage_info(access.usage);
+            img.access_usage |= info.image_usage;
+            img.stages |= info.stage;
+            img.write_accesses |= info.write_access;
+        };
+
+        for (auto const& input : pass.reads) {
+            auto const& img = m_images[input.res];
+            if (!img.imported && !written[input.res]) {
+                logger()->error("render graph pass {} reads image {} before it is written",
+                                pass.name, img.name);
+                return false;
+            }
+
+            use(input);
+        }
+
+        for (auto const& output : pass.writes) {
+            use(output);
+            written[output.res] = true;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool render_graph::compile(device::ptr device) {
+    destroy_images();
+
+    m_device = device;
+
+    if (!schedule())
+        return false;
+
+    for (auto const& img : m_images) {
+        if (img.imported && (img.first != no_index) && !img.img) {
+            logger()->error("render graph image not set: {}", img.name);
+            return false;
+        }
+    }
+
+    if (!create_images()) {
+        destroy_images();
+        return false;
+    }
+
+    logger()->trace("render graph: {}/{} passes, {} images in {} blocks ({} KB, unaliased {} KB)",
+                    m_order.size(), m_passes.size(),
+                    std::count_if(m_images.begin(), m_images.end(), [](auto const& img) {
+                        return !img.imported && img.img;
+                    }),
+                    m_blocks.size(),
+                    m_memory_size / 1024, m_unaliased_memory_size / 1024);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool render_graph::create_images() {
+    index_list transients;
+
+    for (auto i = 0u; i < m_images.size(); ++i) {
+        auto& img = m_images[i];
+        if (img.imported || (img.first == no_index))
+            continue;
+
+        VkImageCreateInfo const info{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = img.format,
+            .extent = {img.size.x, img.size.y, 1},
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = img.usage | img.access_usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        };
+
+        VkImage vk_image = VK_NULL_HANDLE;
+        if (failed(m_device->call().vkCreateImage(m_device->get(),
+                                                  &info,
+                                                  memory::instance().alloc(),
+                                                  &vk_image))) {
+            logger()->error("create render graph image: {}", img.name);
+            return false;
+        }
+
+        img.img = image::make(img.format, vk_image);
+
+        m_device->call().vkGetImageMemoryRequirements(m_device->get(),
+                                                      vk_image,
+                                                      &img.requirements);
+
+        m_unaliased_memory_size += img.requirements.size;
+        transients.push_back(i);
+    }
+
+    std::vector<alias_range> ranges;
+    ranges.reserve(transients.size());
+    for (auto i : transients)
+        ranges.push_back({m_images[i].first, m_images[i].last, m_images[i].requirements});
+
+    auto const blocks = assign_alias_blocks(ranges);
+
+    for (auto k = 0u; k < transients.size(); ++k) {
+        auto& img = m_images[transients[k]];
+        img.block = blocks[k];
+
+        if (img.block >= m_blocks.size())
+            m_blocks.resize(img.block + 1);
+
+        auto& block = m_blocks[img.block];
+        if (block.images.empty()) {
+            block.requirements = img.requirements;
+        } else {
+            block.requirements.size = std::max(block.requirements.size,
+                                               img.requirements.size);
+            block.requirements.alignment = std::max(block.requirements.alignment,
+                                                    img.requirements.alignment);
+            block.requirements.memoryTypeBits &= img.requirements.memoryTypeBits;
+        }
+
+        block.images.push_back(transients[k]);
+    }
+
+    for (auto& block : m_blocks) {
+        std::sort(block.images.begin(), block.images.end(), [&](index a, index b) {
+            return m_images[a].first < m_images[b].first;
+        });
+
+        // first use waits for the previous owner, the last one wraps to the previous frame
+        for (auto k = 0u; k < block.images.size(); ++k) {
+            auto const& previous = m_images[block.images[(k + block.images.size() - 1) % block.images.size()]];
+
+            auto& img = m_images[block.images[k]];
+            img.alias_stages = previous.stages;
+            img.alias_accesses = previous.write_accesses;
+        }
+
+        VmaAllocationCreateInfo const create_info{
+            .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+        };
+
+        if (failed(vmaAllocateMemory(m_device->alloc(),
+                                     &block.requirements,
+                                     &create_info,
+                                     &block.allocation,
+                                     nullptr))) {
+            logger()->error("create render graph memory: {} KB",
+                            block.requirements.size / 1024);
+            return false;
+        }
+
+        m_memory_size += block.requirements.size;
+
+        for (auto i : block.images) {
+            auto& img = m_images[i];
+
+            if (failed(vmaBindImageMemory(m_device->alloc(),
+                                          block.allocation,
+                                          img.img->get()))) {
+                logger()->error("bind render graph image: {}", img.name);
+                return false;
+            }
+
+            // views of depth stencil images are sampled as depth
+            if (format_aspect_mask(img.format) & VK_IMAGE_ASPECT_DEPTH_BIT)
+                img.img->set_aspect_mask(VK_IMAGE_ASPECT_DEPTH_BIT);
+
+            if (!img.img->create(m_device, img.size)) {
+                logger()->error("create render graph image view: {}", img.name);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::destroy_images() {
+    for (auto& img : m_images) {
+        img.block = no_index;
+
+        if (img.imported || !img.img)
+            continue;
+
+        if (img.img->get_view())
+            img.img->destroy();
+        else
+            m_device->call().vkDestroyImage(m_device->get(),
+                                            img.img->get(),
+                                            memory::instance().alloc());
+
+        img.img = nullptr;
+    }
+
+    for (auto& block : m_blocks)
+        if (block.allocation)
+            vmaFreeMemory(m_device->alloc(), block.allocation);
+
+    m_blocks.clear();
+
+    m_memory_size = 0;
+    m_unaliased_memory_size = 0;
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::add_barrier(graph_image& target,
+                               graph_usage usage,
+                               bool preserve,
+                               std::vector<VkImageMemoryBarrier2>& barriers) {
+    auto const info = get_usage_info(usage);
+    auto const layout_change = target.layout != info.layout;
+
+    if (info.write_access) {
+        auto const src_stage = target.write_stage | target.read_stage;
+
+        if (src_stage || layout_change) {
+            // content is discarded if not preserved
+            auto const old_layout = (preserve || !layout_change)
+                                        ? target.layout
+                                        : VK_IMAGE_LAYOUT_UNDEFINED;
+
+            barriers.push_back(make_barrier(target.img,
+                                            src_stage, target.write_access,
+                                            info.stage, info.access,
+                                            old_layout, info.layout));
+        }
+
+        target.write_stage = info.stage;
+        target.write_access = info.write_access;
+        target.visible_stage = 0;
+        target.read_stage = 0;
+    } else if (layout_change) {
+        barriers.push_back(make_barrier(target.img,
+                                        target.write_stage | target.read_stage,
+                                        target.write_access,
+                                        info.stage, info.access,
+                                        target.layout, info.layout));
+
+        target.visible_stage = info.stage;
+        target.read_stage = info.stage;
+    } else {
+        // read after read needs no barrier
+        if (target.write_access && (info.stage & ~target.visible_stage)) {
+            barriers.push_back(make_barrier(target.img,
+                                            target.write_stage, target.write_access,
+                                            info.stage, info.access,
+                                            target.layout, info.layout));
+
+            target.visible_stage |= info.stage;
+        }
+
+        target.read_stage |= info.stage;
+    }
+
+    target.layout = info.layout;
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::process(VkCommandBuffer cmd_buf) {
+    m_barrier_count = 0;
+
+    for (auto& img : m_images) {
+        if (img.imported) {
+            img.layout = img.initial_layout;
+            img.write_stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            img.write_access = VK_ACCESS_2_MEMORY_WRITE_BIT;
+        } else {
+            img.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            img.write_stage = img.alias_stages;
+            img.write_access = img.alias_accesses;
+        }
+
+        img.visible_stage = 0;
+        img.read_stage = 0;
+    }
+
+    std::vector<VkImageMemoryBarrier2> barriers;
+
+    for (auto pass_index : m_order) {
+        auto const& pass = m_passes[pass_index];
+
+        barriers.clear();
+
+        for (auto const& input : pass.reads)
+            add_barrier(m_images[input.res], input.usage, true, barriers);
+
+        for (auto const& output : pass.writes)
+            add_barrier(m_images[output.res], output.usage, output.preserve, barriers);
+
+        insert_image_memory_barriers(m_device, cmd_buf, barriers);
+        m_barrier_count += to_ui32(barriers.size());
+
+        if (pass.on_process)
+            pass.on_process(cmd_buf);
+    }
+
+    barriers.clear();
+
+    for (auto const& img : m_images) {
+        if (!img.imported || (img.first == no_index))
+            continue;
+
+        if ((img.final_layout == VK_IMAGE_LAYOUT_UNDEFINED)
+            || (img.layout == img.final_layout)) {
+            img.img->set_state({
+                .layout = img.layout,
+                .write_stage = img.write_stage,
+                .write_access = img.write_access,
+                .visible_stage = img.visible_stage,
+                .read_stage = img.read_stage,
+            });
+            continue;
+        }
+
+        barriers.push_back(make_barrier(img.img,
+                                        img.write_stage | img.read_stage,
+                                        img.write_access,
+                                        VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, 0,
+                                        img.layout, img.final_layout));
+
+        img.img->set_state({
+            .layout = img.final_layout,
+            .write_stage = VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
+        });
+    }
+
+    insert_image_memory_barriers(m_device, cmd_buf, barriers);
+    m_barrier_count += to_ui32(barriers.size());
+}
+
+//-----------------------------------------------------------------------------
+void render_graph::destroy() {
+    if (m_device)
+        destroy_images();
+
+    m_passes.clear();
+    m_images.clear();
+    m_order.clear();
+
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+image::s_ptr render_graph::get_image(resource res) const {
+    return m_images.at(res).img;
+}
+
+//-----------------------------------------------------------------------------
+bool render_graph::culled(index pass) const {
+    return m_passes.at(pass).culled;
+}
+
+} // namespace lava
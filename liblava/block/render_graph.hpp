@@ -0,0 +1,407 @@
+/**
+ * @file         liblava/block/render_graph.hpp
+ * @brief        Render graph
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/base/device.hpp"
+#include "liblava/resource/image.hpp"
+
+namespace lava {
+
+/**
+ * @brief Image usages of render graph passes
+ */
+enum class graph_usage : index {
+    color_attachment = 0,
+    depth_attachment,
+    depth_read,
+    sampled,
+    input_attachment,
+    storage_read,
+    storage_write,
+    transfer_src,
+    transfer_dst
+};
+
+/**
+ * @brief Lifetime and memory of an aliased image
+ */
+struct alias_range {
+    /// First pass in execution order
+    index first = no_index;
+
+    /// Last pass in execution order
+    index last = no_index;
+
+    /// Memory requirements
+    VkMemoryRequirements requirements = {};
+};
+
+/**
+ * @brief Assign ranges with disjoint lifetimes to shared memory blocks
+ * @note Largest first, each range goes to the first block with
+ *       a common memory type and without lifetime overlap
+ * @param ranges         List of ranges
+ * @return index_list    Memory block of each range
+ */
+index_list assign_alias_blocks(std::vector<alias_range> const& ranges);
+
+/**
+ * @brief Render graph
+ * @note Passes run in declaration order, a read of a transient image needs
+ *       an earlier writer (compile fails otherwise), barriers are derived from
+ *       the declared reads and writes of each pass, imported images
+ *       leave with their tracked state updated
+ */
+struct render_graph : entity {
+    /// Shared pointer to render graph
+    using s_ptr = std::shared_ptr<render_graph>;
+
+    /// Graph resource handle
+    using resource = index;
+
+    /// Pass process function
+    using process_func = std::function<void(VkCommandBuffer)>;
+
+    /**
+     * @brief Make a new render graph
+     * @return s_ptr    Shared pointer to render graph
+     */
+    static s_ptr make() {
+        return std::make_shared<render_graph>();
+    }
+
+    /**
+     * @brief Destroy the render graph
+     */
+    ~render_graph() {
+        destroy();
+    }
+
+    /**
+     * @brief Add a transient image (created by compile)
+     * @param name        Name of image
+     * @param format      Image format
+     * @param size        Image size
+     * @param usage       Additional image usage flags
+     * @return resource   Graph resource
+     */
+    resource add_image(string_ref name,
+                       VkFormat format,
+                       uv2 size,
+                       VkImageUsageFlags usage = 0);
+
+    /**
+     * @brief Import an external image (e.g. backbuffer)
+     * @param name              Name of image
+     * @param image             External image
+     * @param initial_layout    Image layout before graph
+     * @param final_layout      Image layout after graph
+     * @return resource         Graph resource
+     */
+    resource import_image(string_ref name,
+                          image::s_ptr image,
+                          VkImageLayout initial_layout,
+                          VkImageLayout final_layout);
+
+    /**
+     * @brief Set the external image of an imported resource
+     * @param res      Graph resource
+     * @param image    External image
+     */
+    void set_image(resource res,
+                   image::s_ptr image);
+
+    /**
+     * @brief Set the size of a transient image (requires compile)
+     * @param res     Graph resource
+     * @param size    Image size
+     */
+    void set_size(resource res,
+                  uv2 size);
+
+    /**
+     * @brief Add a pass
+     * @param name           Name of pass
+     * @param func           Pass process function
+     * @param side_effect    Pass is never culled
+     * @return index         Pass index
+     */
+    index add_pass(string_ref name,
+                   process_func func,
+                   bool side_effect = false);
+
+    /**
+     * @brief Declare a read of a pass
+     * @param pass     Pass index
+     * @param res      Graph resource
+     * @param usage    Image usage
+     */
+    void read(index pass,
+              resource res,
+              graph_usage usage);
+
+    /**
+     * @brief Declare a write of a pass
+     * @param pass        Pass index
+     * @param res         Graph resource
+     * @param usage       Image usage
+     * @param preserve    Previous content is loaded (keeps earlier writers)
+     */
+    void write(index pass,
+               resource res,
+               graph_usage usage,
+               bool preserve = false);
+
+    /**
+     * @brief Cull unused passes and compute image lifetimes (called by compile)
+     * @return Schedule was successful or failed (read before write)
+     */
+    bool schedule();
+
+    /**
+     * @brief Compile the render graph
+     * @note Culls unused passes and creates transient images with aliased memory
+     * @param device    Vulkan device
+     * @return Compile was successful or failed
+     */
+    bool compile(device::ptr device);
+
+    /**
+     * @brief Process the render graph
+     * @param cmd_buf    Command buffer
+     */
+    void process(VkCommandBuffer cmd_buf);
+
+    /**
+     * @brief Destroy transient images, passes and resources
+     */
+    void destroy();
+
+    /**
+     * @brief Get the image of a resource
+     * @param res              Graph resource
+     * @return image::s_ptr    Image (transient images after compile)
+     */
+    image::s_ptr get_image(resource res) const;
+
+    /**
+     * @brief Check if a pass is culled
+     * @param pass    Pass index
+     * @return Pass is culled or not
+     */
+    bool culled(index pass) const;
+
+    /**
+     * @brief Get the execution order of passes
+     * @return index_list const&    Pass indices (culled passes skipped)
+     */
+    index_list const& get_order() const {
+        return m_order;
+    }
+
+    /**
+     * @brief Get the memory size of transient images
+     * @return VkDeviceSize    Allocated memory size
+     */
+    VkDeviceSize get_memory_size() const {
+        return m_memory_size;
+    }
+
+    /**
+     * @brief Get the memory size of transient images without aliasing
+     * @return VkDeviceSize    Memory size without aliasing
+     */
+    VkDeviceSize get_unaliased_memory_size() const {
+        return m_unaliased_memory_size;
+    }
+
+    /**
+     * @brief Get the number of barriers of the last process
+     * @return ui32    Number of image barriers
+     */
+    ui32 get_barrier_count() const {
+        return m_barrier_count;
+    }
+
+private:
+    /**
+     * @brief Image access of a pass
+     */
+    struct graph_access {
+        /// Graph resource
+        resource res = no_index;
+
+        /// Image usage
+        graph_usage usage = graph_usage::sampled;
+
+        /// Previous content is loaded
+        bool preserve = false;
+    };
+
+    /**
+     * @brief Render graph pass
+     */
+    struct graph_pass {
+        /// Name of pass
+        string name;
+
+        /// Pass process function
+        process_func on_process;
+
+        /// Pass is never culled
+        bool side_effect = false;
+
+        /// Pass is culled
+        bool culled = false;
+
+        /// List of reads
+        std::vector<graph_access> reads;
+
+        /// List of writes
+        std::vector<graph_access> writes;
+    };
+
+    /**
+     * @brief Render graph image
+     */
+    struct graph_image {
+        /// Name of image
+        string name;
+
+        /// Image format
+        VkFormat format = VK_FORMAT_UNDEFINED;
+
+        /// Image size
+        uv2 size = {};
+
+        /// Image usage flags
+        VkImageUsageFlags usage = 0;
+
+        /// Image (transient or imported)
+        image::s_ptr img;
+
+        /// Image is imported
+        bool imported = false;
+
+        /// Image layout before graph
+        VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        /// Image layout after graph
+        VkImageLayout final_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        /// First pass in execution order
+        index first = no_index;
+
+        /// Last pass in execution order
+        index last = no_index;
+
+        /// Memory block index
+        index block = no_index;
+
+        /// Memory requirements
+        VkMemoryRequirements requirements = {};
+
+        /// Usage flags of all accesses
+        VkImageUsageFlags access_usage = 0;
+
+        /// Stages of all accesses
+        VkPipelineStageFlags2 stages = 0;
+
+        /// Accesses of all writes
+        VkAccessFlags2 write_accesses = 0;
+
+        /// Stages of the previous owner of the memory
+        VkPipelineStageFlags2 alias_stages = 0;
+
+        /// Write accesses of the previous owner of the memory
+        VkAccessFlags2 alias_accesses = 0;
+
+        /// Current layout
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        /// Stages of last write
+        VkPipelineStageFlags2 write_stage = 0;
+
+        /// Accesses of last write
+        VkAccessFlags2 write_access = 0;
+
+        /// Stages the last write is visible to
+        VkPipelineStageFlags2 visible_stage = 0;
+
+        /// Stages of reads since last write
+        VkPipelineStageFlags2 read_stage = 0;
+    };
+
+    /**
+     * @brief Memory block shared by aliased images
+     */
+    struct memory_block {
+        /// Merged memory requirements
+        VkMemoryRequirements requirements = {};
+
+        /// Allocation
+        VmaAllocation allocation = nullptr;
+
+        /// List of images in execution order
+        index_list images;
+    };
+
+    /**
+     * @brief Cull passes which do not contribute to imported images
+     */
+    void cull();
+
+    /**
+     * @brief Create transient images and assign aliased memory
+     * @return Create was successful or failed
+     */
+    bool create_images();
+
+    /**
+     * @brief Destroy transient images and memory blocks
+     */
+    void destroy_images();
+
+    /**
+     * @brief Add barrier for an access (if required)
+     * @param target      Render graph image
+     * @param usage       Image usage
+     * @param preserve    Previous content is loaded
+     * @param barriers    List of barriers
+     */
+    void add_barrier(graph_image& target,
+                     graph_usage usage,
+                     bool preserve,
+                     std::vector<VkImageMemoryBarrier2>& barriers);
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// List of passes
+    std::vector<graph_pass> m_passes;
+
+    /// List of images
+    std::vector<graph_image> m_images;
+
+    /// Execution order of passes
+    index_list m_order;
+
+    /// List of memory blocks
+    std::vector<memory_block> m_blocks;
+
+    /// Allocated memory size
+    VkDeviceSize m_memory_size = 0;
+
+    /// Memory size without aliasing
+    VkDeviceSize m_unaliased_memory_size = 0;
+
+    /// Number of barriers of last process
+    ui32 m_barrier_count = 0;
+};
+
+} // namespace lava
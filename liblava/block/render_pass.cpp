@@ -6,6 +6,7 @@
  */
 
 #include "liblava/block/render_pass.hpp"
+#include "liblava/resource/format.hpp"
 #include "liblava/util/log.hpp"
 
 namespace lava {
@@ -22,37 +23,60 @@ render_pass::render_pass(device::ptr dev)
 //-----------------------------------------------------------------------------
 bool render_pass::create(VkAttachmentsRef target_attachments,
                          rect::ref area) {
-    std::vector<VkAttachmentDescription> attachment_descriptions;
+    m_dynamic_rendering = false;
 
-    for (auto& attachment : m_attachments)
-        attachment_descriptions.push_back(attachment->get_description());
+    if (m_dynamic_rendering_request && m_device->has_dynamic_rendering()) {
+        m_dynamic_rendering = (m_subpasses.size() == 1)
+                              && (m_subpasses.front()->get_description().inputAttachmentCount == 0)
+                              && !m_subpasses.front()->get_description().pResolveAttachments;
 
-    std::vector<VkSubpassDescription> subpass_descriptions;
+        if (!m_dynamic_rendering)
+            logger()->warn("render pass - dynamic rendering not applicable");
+    }
 
-    for (auto& subpass : m_subpasses)
-        subpass_descriptions.push_back(subpass->get_description());
+    if (!m_dynamic_rendering) {
+        std::vector<VkAttachmentDescription> attachment_descriptions;
 
-    std::vector<VkSubpassDependency> subpass_dependencies;
+        for (auto& attachment : m_attachments)
+            attachment_descriptions.push_back(attachment->get_description());
 
-    for (auto& dependency : m_dependencies)
-        subpass_dependencies.push_back(dependency->get_dependency());
+        std::vector<VkSubpassDescription> subpass_descriptions;
 
-    VkRenderPassCreateInfo const create_info{
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-        .attachmentCount = to_ui32(attachment_descriptions.size()),
-        .pAttachments = attachment_descriptions.data(),
-        .subpassCount = to_ui32(subpass_descriptions.size()),
-        .pSubpasses = subpass_descriptions.data(),
-        .dependencyCount = to_ui32(subpass_dependencies.size()),
-        .pDependencies = subpass_dependencies.data(),
-    };
+        for (auto& subpass : m_subpasses)
+            subpass_descriptions.push_back(subpass->get_description());
+
+        std::vector<VkSubpassDependency> subpass_dependencies;
+
+        for (auto& dependency : m_dependencies)
+            subpass_dependencies.push_back(dependency->get_dependency());
+
+        VkRenderPassCreateInfo const create_info{
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+            .attachmentCount = to_ui32(attachment_descriptions.size()),
+            .pAttachments = attachment_descriptions.data(),
+            .subpassCount = to_ui32(subpass_descriptions.size()),
+            .pSubpasses = subpass_descriptions.data(),
+            .dependencyCount = to_ui32(subpass_dependencies.size()),
+            .pDependencies = subpass_dependencies.data(),
+        };
+
+        if (!check(m_device->call().vkCreateRenderPass(m_device->get(),
+                                                       &create_info,
+                                                       memory::instance().alloc(),
+                                                       &m_vk_render_pass))) {
+            logger()->error("create render pass");
+            return false;
+        }
+    }
 
-    if (!check(m_device->call().vkCreateRenderPass(m_device->get(),
-                                                   &create_info,
-                                                   memory::instance().alloc(),
-                                                   &m_vk_render_pass))) {
-        logger()->error("create render pass");
-        return false;
+    for (auto& subpass : m_subpasses) {
+        if (!subpass->secondary())
+            continue;
+
+        if (!subpass->create_secondary(m_device, to_index(target_attachments.size()))) {
+            logger()->error("create render pass secondary command buffers");
+            return false;
+        }
     }
 
     return on_target_created(target_attachments, area);
@@ -77,12 +101,16 @@ void render_pass::destroy() {
         m_vk_render_pass = VK_NULL_HANDLE;
     }
 
+    m_dynamic_rendering = false;
+    m_attachment_images.clear();
+
     m_device = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 void render_pass::begin(VkCommandBuffer cmd_buf,
-                        index frame) {
+                        index frame,
+                        VkSubpassContents contents) {
     auto origin = m_area.get_origin();
     auto size = m_area.get_size();
 
@@ -97,7 +125,7 @@ void render_pass::begin(VkCommandBuffer cmd_buf,
 
     m_device->call().vkCmdBeginRenderPass(cmd_buf,
                                           &info,
-                                          VK_SUBPASS_CONTENTS_INLINE);
+                                          contents);
 }
 
 //-----------------------------------------------------------------------------
@@ -108,19 +136,45 @@ void render_pass::end(VkCommandBuffer cmd_buf) {
 //-----------------------------------------------------------------------------
 void render_pass::process(VkCommandBuffer cmd_buf,
                           index frame) {
-    begin(cmd_buf, frame);
+    if (m_dynamic_rendering) {
+        process_rendering(cmd_buf, frame);
+        return;
+    }
+
+    auto const get_contents = [](subpass const& pass) {
+        return pass.secondary() ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                                : VK_SUBPASS_CONTENTS_INLINE;
+    };
+
+    begin(cmd_buf,
+          frame,
+          m_subpasses.empty() ? VK_SUBPASS_CONTENTS_INLINE
+                              : get_contents(*m_subpasses.front()));
 
     ui32 count = 0;
 
-    for (auto& subpass : m_subpasses) {
+    for (auto i = 0u; i < m_subpasses.size(); ++i) {
+        auto& subpass = m_subpasses.at(i);
+
         if (count > 0)
             m_device->call().vkCmdNextSubpass(cmd_buf,
-                                              VK_SUBPASS_CONTENTS_INLINE);
+                                              get_contents(*subpass));
 
         if (!subpass->activated())
             continue;
 
-        subpass->process(cmd_buf, m_area.get_size());
+        if (subpass->secondary()) {
+            VkCommandBufferInheritanceInfo const inheritance{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+                .renderPass = m_vk_render_pass,
+                .subpass = i,
+                .framebuffer = m_framebuffers[frame],
+            };
+
+            subpass->process_secondary(cmd_buf, m_area.get_size(), frame, inheritance);
+        } else {
+            subpass->process(cmd_buf, m_area.get_size());
+        }
 
         ++count;
     }
@@ -128,6 +182,226 @@ void render_pass::process(VkCommandBuffer cmd_buf,
     end(cmd_buf);
 }
 
+//-----------------------------------------------------------------------------
+void render_pass::process_rendering(VkCommandBuffer cmd_buf,
+                                    index frame) {
+    auto& pass = *m_subpasses.front();
+    auto const& description = pass.get_description();
+    auto const formats = get_rendering_formats();
+
+    transition_attachments(cmd_buf, frame, true);
+
+    std::vector<VkRenderingAttachmentInfo> color_attachments;
+    for (auto i = 0u; i < description.colorAttachmentCount; ++i)
+        color_attachments.push_back(get_rendering_attachment(description.pColorAttachments[i],
+                                                             frame,
+                                                             false));
+
+    VkRenderingAttachmentInfo depth_attachment{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+    };
+    if (formats.depth)
+        depth_attachment = get_rendering_attachment(*description.pDepthStencilAttachment,
+                                                    frame,
+                                                    false);
+
+    VkRenderingAttachmentInfo stencil_attachment{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+    };
+    if (formats.stencil)
+        stencil_attachment = get_rendering_attachment(*description.pDepthStencilAttachment,
+                                                      frame,
+                                                      true);
+
+    VkRenderingFlags flags = 0;
+    if (pass.secondary())
+        flags |= VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+
+    auto origin = m_area.get_origin();
+    auto size = m_area.get_size();
+
+    VkRenderingInfo const info{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+        .flags = flags,
+        .renderArea = {{origin.x, origin.y}, {size.x, size.y}},
+        .layerCount = 1,
+        .colorAttachmentCount = to_ui32(color_attachments.size()),
+        .pColorAttachments = color_attachments.data(),
+        .pDepthAttachment = formats.depth ? &depth_attachment : nullptr,
+        .pStencilAttachment = formats.stencil ? &stencil_attachment : nullptr,
+    };
+
+    auto begin_rendering = m_device->call().vkCmdBeginRendering
+                               ? m_device->call().vkCmdBeginRendering
+                               : m_device->call().vkCmdBeginRenderingKHR;
+    auto end_rendering = m_device->call().vkCmdEndRendering
+                             ? m_device->call().vkCmdEndRendering
+                             : m_device->call().vkCmdEndRenderingKHR;
+
+    begin_rendering(cmd_buf, &info);
+
+    if (pass.activated()) {
+        if (pass.secondary()) {
+            auto samples = VK_SAMPLE_COUNT_1_BIT;
+            if ((description.colorAttachmentCount > 0)
+                && (description.pColorAttachments[0].attachment != VK_ATTACHMENT_UNUSED))
+                samples = m_attachments.at(description.pColorAttachments[0].attachment)
+                              ->get_description()
+                              .samples;
+
+            VkCommandBufferInheritanceRenderingInfo const rendering_inheritance{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+                .colorAttachmentCount = to_ui32(formats.color.size()),
+                .pColorAttachmentFormats = formats.color.data(),
+                .depthAttachmentFormat = formats.depth,
+                .stencilAttachmentFormat = formats.stencil,
+                .rasterizationSamples = samples,
+            };
+
+            VkCommandBufferInheritanceInfo const inheritance{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+                .pNext = &rendering_inheritance,
+            };
+
+            pass.process_secondary(cmd_buf, size, frame, inheritance);
+        } else {
+            pass.process(cmd_buf, size);
+        }
+    }
+
+    end_rendering(cmd_buf);
+
+    transition_attachments(cmd_buf, frame, false);
+}
+
+//-----------------------------------------------------------------------------
+VkRenderingAttachmentInfo render_pass::get_rendering_attachment(VkAttachmentReference const& reference,
+                                                                index frame,
+                                                                bool stencil) const {
+    VkRenderingAttachmentInfo result{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+    };
+
+    if (reference.attachment == VK_ATTACHMENT_UNUSED)
+        return result;
+
+    auto const& description = m_attachments.at(reference.attachment)->get_description();
+
+    result.imageView = m_frame_attachments.at(frame).at(reference.attachment);
+    result.imageLayout = reference.layout;
+    result.loadOp = stencil ? description.stencilLoadOp : description.loadOp;
+    result.storeOp = stencil ? description.stencilStoreOp : description.storeOp;
+
+    if (reference.attachment < m_clear_values.size())
+        result.clearValue = m_clear_values.at(reference.attachment);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+void render_pass::transition_attachments(VkCommandBuffer cmd_buf,
+                                         index frame,
+                                         bool begin) {
+    auto const& description = m_subpasses.front()->get_description();
+    auto const& images = m_attachment_images.at(frame);
+
+    std::vector<VkImageMemoryBarrier2> barriers;
+
+    auto const add_barrier = [&](VkAttachmentReference const& reference) {
+        if (reference.attachment == VK_ATTACHMENT_UNUSED)
+            return;
+
+        auto const& attachment = m_attachments.at(reference.attachment)->get_description();
+        auto const aspect = format_aspect_mask(attachment.format);
+        auto const depth_stencil = (aspect & (VK_IMAGE_ASPECT_DEPTH_BIT
+                                              | VK_IMAGE_ASPECT_STENCIL_BIT))
+                                   != 0;
+
+        VkPipelineStageFlags2 const stage = depth_stencil
+                                                ? VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT
+                                                      | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT
+                                                : VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        VkAccessFlags2 const write = depth_stencil
+                                         ? VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                                         : VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+        VkAccessFlags2 const access = depth_stencil
+                                          ? VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                                                | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                                          : VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT
+                                                | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+
+        // writes of the previous use like the external subpass dependencies
+        VkImageMemoryBarrier2 barrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = stage,
+            .srcAccessMask = write,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = images.at(reference.attachment),
+            .subresourceRange = {aspect, 0, 1, 0, 1},
+        };
+
+        if (begin) {
+            barrier.dstStageMask = stage;
+            barrier.dstAccessMask = access;
+            barrier.oldLayout = attachment.initialLayout;
+            barrier.newLayout = reference.layout;
+        } else {
+            if ((attachment.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+                || (attachment.finalLayout == reference.layout))
+                return;
+
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT
+                                    | VK_ACCESS_2_MEMORY_WRITE_BIT;
+            barrier.oldLayout = reference.layout;
+            barrier.newLayout = attachment.finalLayout;
+        }
+
+        barriers.push_back(barrier);
+    };
+
+    for (auto i = 0u; i < description.colorAttachmentCount; ++i)
+        add_barrier(description.pColorAttachments[i]);
+
+    if (description.pDepthStencilAttachment)
+        add_barrier(*description.pDepthStencilAttachment);
+
+    insert_image_memory_barriers(m_device, cmd_buf, barriers);
+}
+
+//-----------------------------------------------------------------------------
+rendering_formats render_pass::get_rendering_formats(index subpass) const {
+    rendering_formats result;
+
+    auto const& description = m_subpasses.at(subpass)->get_description();
+
+    for (auto i = 0u; i < description.colorAttachmentCount; ++i) {
+        auto const attachment = description.pColorAttachments[i].attachment;
+
+        result.color.push_back(attachment == VK_ATTACHMENT_UNUSED
+                                   ? VK_FORMAT_UNDEFINED
+                                   : m_attachments.at(attachment)->get_description().format);
+    }
+
+    if (!description.pDepthStencilAttachment
+        || (description.pDepthStencilAttachment->attachment == VK_ATTACHMENT_UNUSED))
+        return result;
+
+    auto const format = m_attachments.at(description.pDepthStencilAttachment->attachment)
+                            ->get_description()
+                            .format;
+    auto const aspect = format_aspect_mask(format);
+
+    if (aspect & VK_IMAGE_ASPECT_DEPTH_BIT)
+        result.depth = format;
+
+    if (aspect & VK_IMAGE_ASPECT_STENCIL_BIT)
+        result.stencil = format;
+
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 void render_pass::set_clear_color(v3 value) {
     m_clear_values.resize(2);
@@ -153,6 +427,18 @@ v3 render_pass::get_clear_color() const {
 bool render_pass::on_target_created(VkAttachmentsRef target_attachments,
                                     rect::ref a) {
     m_area = a;
+
+    if (m_dynamic_rendering) {
+        if (m_attachment_images.size() != target_attachments.size()) {
+            logger()->error("create render pass target - attachment images");
+            return false;
+        }
+
+        // views are referenced at begin, nothing to create
+        m_frame_attachments = target_attachments;
+        return true;
+    }
+
     m_framebuffers.resize(target_attachments.size());
 
     auto size = m_area.get_size();
@@ -197,6 +483,7 @@ void render_pass::on_target_destroyed() {
     }
 
     m_framebuffers.clear();
+    m_frame_attachments.clear();
 }
 
 } // namespace lava
@@ -70,12 +70,47 @@ struct render_pass : entity {
 
     /**
      * @brief Get the render pass
-     * @return VkRenderPass    Vulkan render pass
+     * @return VkRenderPass    Vulkan render pass (none with dynamic rendering)
      */
     VkRenderPass get() const {
         return m_vk_render_pass;
     }
 
+    /**
+     * @brief Use dynamic rendering instead of render pass and framebuffers
+     * @note Set before the render pass is created. Applies to a single subpass
+     *       without input and resolve attachments if the device enabled it
+     * @param value    Request state
+     */
+    void set_dynamic_rendering(bool value = true) {
+        m_dynamic_rendering_request = value;
+    }
+
+    /**
+     * @brief Check if render pass uses dynamic rendering
+     * @return Dynamic rendering is used or not
+     */
+    bool dynamic_rendering() const {
+        return m_dynamic_rendering;
+    }
+
+    /**
+     * @brief Set the images of target attachments
+     * @note Required with dynamic rendering for layout transitions,
+     *       set before the target is created
+     * @param images    List of images by frame in attachment order
+     */
+    void set_attachment_images(std::vector<VkImages> const& images) {
+        m_attachment_images = images;
+    }
+
+    /**
+     * @brief Get the attachment formats of a subpass
+     * @param subpass               Index of subpass
+     * @return rendering_formats    Attachment formats
+     */
+    rendering_formats get_rendering_formats(index subpass = 0) const;
+
     /**
      * @brief Get the subpass count
      * @return ui32    Number of subpasses
@@ -210,6 +245,18 @@ private:
     /// List of frame buffers
     VkFramebuffers m_framebuffers = {};
 
+    /// Dynamic rendering requested
+    bool m_dynamic_rendering_request = false;
+
+    /// Dynamic rendering used
+    bool m_dynamic_rendering = false;
+
+    /// Target attachment views by frame (dynamic rendering)
+    VkAttachments m_frame_attachments;
+
+    /// Target attachment images by frame (dynamic rendering)
+    std::vector<VkImages> m_attachment_images;
+
     /// List of attachments
     attachment::s_list m_attachments;
 
@@ -230,11 +277,13 @@ private:
 
     /**
      * @brief Begin the render pass
-     * @param cmd_buf    Command buffer
-     * @param frame      Frame index
+     * @param cmd_buf     Command buffer
+     * @param frame       Frame index
+     * @param contents    Contents of first subpass
      */
     void begin(VkCommandBuffer cmd_buf,
-               index frame);
+               index frame,
+               VkSubpassContents contents);
 
     /**
      * @brief End the render pass
@@ -242,6 +291,35 @@ private:
      */
     void end(VkCommandBuffer cmd_buf);
 
+    /**
+     * @brief Process the subpass with dynamic rendering
+     * @param cmd_buf    Command buffer
+     * @param frame      Frame index
+     */
+    void process_rendering(VkCommandBuffer cmd_buf,
+                           index frame);
+
+    /**
+     * @brief Get the rendering attachment of a reference
+     * @param reference                     Attachment reference
+     * @param frame                         Frame index
+     * @param stencil                       Stencil or color and depth operations
+     * @return VkRenderingAttachmentInfo    Rendering attachment
+     */
+    VkRenderingAttachmentInfo get_rendering_attachment(VkAttachmentReference const& reference,
+                                                       index frame,
+                                                       bool stencil) const;
+
+    /**
+     * @brief Transition attachments around dynamic rendering
+     * @param cmd_buf    Command buffer
+     * @param frame      Frame index
+     * @param begin      Into subpass layouts or into final layouts
+     */
+    void transition_attachments(VkCommandBuffer cmd_buf,
+                                index frame,
+                                bool begin);
+
     /**
      * @brief Called on target created
      * @param target_attachments    List of target attachments
@@ -6,6 +6,7 @@
  */
 
 #include "liblava/block/render_pipeline.hpp"
+#include "liblava/block/render_pass.hpp"
 #include "liblava/util/log.hpp"
 
 namespace lava {
@@ -267,8 +268,17 @@ bool render_pipeline::setup() {
     for (auto& shader_stage : m_shader_stages)
         stages.push_back(shader_stage->get_create_info());
 
+    VkPipelineRenderingCreateInfo const rendering_info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .colorAttachmentCount = to_ui32(m_rendering_formats.color.size()),
+        .pColorAttachmentFormats = m_rendering_formats.color.data(),
+        .depthAttachmentFormat = m_rendering_formats.depth,
+        .stencilAttachmentFormat = m_rendering_formats.stencil,
+    };
+
     VkGraphicsPipelineCreateInfo const vk_create_info{
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = m_render_pass ? nullptr : &rendering_info,
         .stageCount = to_ui32(stages.size()),
         .pStages = stages.data(),
         .pVertexInputState = &m_info.vertex_input_state,
@@ -297,6 +307,16 @@ bool render_pipeline::setup() {
                                                             &m_vk_pipeline));
 }
 
+//-----------------------------------------------------------------------------
+bool render_pipeline::create(render_pass const& pass) {
+    set(pass.get());
+
+    if (pass.dynamic_rendering())
+        set_rendering_formats(pass.get_rendering_formats(m_subpass));
+
+    return pipeline::create();
+}
+
 //-----------------------------------------------------------------------------
 void render_pipeline::teardown() {
     clear();
@@ -304,7 +324,7 @@ void render_pipeline::teardown() {
 
 //-----------------------------------------------------------------------------
 void render_pipeline::bind(VkCommandBuffer cmd_buf) {
-    vkCmdBindPipeline(cmd_buf,
+    cmd_bind_pipeline(cmd_buf,
                       VK_PIPELINE_BIND_POINT_GRAPHICS,
                       m_vk_pipeline);
 }
@@ -342,17 +362,8 @@ void render_pipeline::set_viewport_and_scissor(VkCommandBuffer cmd_buf,
         m_scissor = scissorParam;
     }
 
-    std::array<VkViewport, 1> const viewports = {viewportParam};
-    vkCmdSetViewport(cmd_buf,
-                     0,
-                     to_ui32(viewports.size()),
-                     viewports.data());
-
-    std::array<VkRect2D, 1> const scissors = {scissorParam};
-    vkCmdSetScissor(cmd_buf,
-                    0,
-                    to_ui32(scissors.size()),
-                    scissors.data());
+    cmd_set_viewport(cmd_buf, viewportParam);
+    cmd_set_scissor(cmd_buf, scissorParam);
 }
 
 //-----------------------------------------------------------------------------
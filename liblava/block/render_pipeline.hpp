@@ -7,10 +7,25 @@
 
 #pragma once
 
+#include "liblava/base/cmd_state.hpp"
 #include "liblava/block/pipeline.hpp"
 
 namespace lava {
 
+/**
+ * @brief Attachment formats of dynamic rendering
+ */
+struct rendering_formats {
+    /// Color attachment formats
+    VkFormats color;
+
+    /// Depth attachment format
+    VkFormat depth = VK_FORMAT_UNDEFINED;
+
+    /// Stencil attachment format
+    VkFormat stencil = VK_FORMAT_UNDEFINED;
+};
+
 /**
  * @brief Render pipeline (Graphics)
  */
@@ -128,6 +143,23 @@ struct render_pipeline : pipeline {
         m_subpass = value;
     }
 
+    /**
+     * @brief Set the attachment formats of dynamic rendering
+     * @note Used if no render pass is set
+     * @param formats    Attachment formats
+     */
+    void set_rendering_formats(rendering_formats const& formats) {
+        m_rendering_formats = formats;
+    }
+
+    /**
+     * @brief Get the attachment formats of dynamic rendering
+     * @return rendering_formats const&    Attachment formats
+     */
+    rendering_formats const& get_rendering_formats() const {
+        return m_rendering_formats;
+    }
+
     /**
      * @brief Create a new render pipeline
      * @param pass      Vulkan render pass
@@ -139,6 +171,14 @@ struct render_pipeline : pipeline {
         return pipeline::create();
     }
 
+    /**
+     * @brief Create a new render pipeline for a render pass
+     * @note Uses the attachment formats of the subpass with dynamic rendering
+     * @param pass    Render pass
+     * @return Create was successful or failed
+     */
+    bool create(render_pass const& pass);
+
     /**
      * @brief Set the vertex input binding
      * @param description    Vertex input binding description
@@ -400,7 +440,7 @@ struct render_pipeline : pipeline {
      * @param cmd_buf    Command buffer
      */
     void set_line_width(VkCommandBuffer cmd_buf) {
-        vkCmdSetLineWidth(cmd_buf, m_line_width);
+        cmd_set_line_width(cmd_buf, m_line_width);
     }
 
     /// Create function
@@ -427,6 +467,9 @@ private:
     /// Subpass index
     index m_subpass = 0;
 
+    /// Attachment formats of dynamic rendering
+    rendering_formats m_rendering_formats;
+
     /// Create information
     create_info m_info;
 
@@ -0,0 +1,212 @@
+/**
+ * @file         liblava/block/render_queue.cpp
+ * @brief        Sorted draw submission
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/block/render_queue.hpp"
+#include <array>
+#include <optional>
+
+namespace lava {
+
+namespace {
+
+/// Minimum number of packets per sort thread
+constexpr size_t queue_min_chunk = 1 << 14;
+
+/// Minimum number of packets for radix sort
+constexpr size_t radix_min_count = 256;
+
+/// Number of buckets per digit
+constexpr size_t radix_size = 256;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+render_queue::~render_queue() {
+    if (m_pool)
+        m_pool->teardown();
+}
+
+//-----------------------------------------------------------------------------
+void render_queue::push(draw_packet const& packet) {
+    m_items.push_back({packet.key, to_index(m_packets.size())});
+    m_packets.push_back(packet);
+}
+
+//-----------------------------------------------------------------------------
+void render_queue::clear() {
+    m_packets.clear();
+    m_items.clear();
+}
+
+//-----------------------------------------------------------------------------
+void render_queue::run_chunks(ui32 chunk_count,
+                              std::function<void(ui32)> const& func) {
+    if (chunk_count == 1) {
+        func(0);
+        return;
+    }
+
+    for (auto chunk = 0u; chunk < chunk_count; ++chunk)
+        m_pool->enqueue([&func, chunk](id::ref) {
+            func(chunk);
+        });
+
+    m_pool->wait();
+}
+
+//-----------------------------------------------------------------------------
+void render_queue::sort(ui32 thread_count) {
+    auto const count = m_items.size();
+
+    if (count < radix_min_count) {
+        std::stable_sort(m_items.begin(), m_items.end(), [](sort_item const& a, sort_item const& b) {
+            return a.key < b.key;
+        });
+        return;
+    }
+
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    auto const chunk_count = to_ui32(std::clamp(count / queue_min_chunk,
+                                                size_t(1),
+                                                size_t(thread_count)));
+
+    if ((chunk_count > 1) && (m_pool_thread_count != chunk_count)) {
+        if (m_pool)
+            m_pool->teardown();
+
+        m_pool = std::make_unique<thread_pool>();
+        m_pool->setup(chunk_count);
+        m_pool_thread_count = chunk_count;
+    }
+
+    auto const chunk_size = (count + chunk_count - 1) / chunk_count;
+
+    std::vector<std::array<size_t, radix_size>> histograms(chunk_count);
+
+    m_scratch.resize(count);
+
+    auto source = m_items.data();
+    auto target = m_scratch.data();
+
+    // least significant digit first, each pass is stable
+    for (auto shift = 0u; shift < 64; shift += 8) {
+        run_chunks(chunk_count, [&](ui32 chunk) {
+            auto& histogram = histograms[chunk];
+            histogram.fill(0);
+
+            auto const last = std::min((chunk + 1) * chunk_size, count);
+            for (auto i = chunk * chunk_size; i < last; ++i)
+                ++histogram[(source[i].key >> shift) & 0xff];
+        });
+
+        // digit shared by all keys keeps the order
+        auto const first_digit = (source[0].key >> shift) & 0xff;
+
+        size_t first_digit_count = 0;
+        for (auto const& histogram : histograms)
+            first_digit_count += histogram[first_digit];
+
+        if (first_digit_count == count)
+            continue;
+
+        size_t offset = 0;
+        for (auto digit = 0u; digit < radix_size; ++digit) {
+            for (auto& histogram : histograms) {
+                auto const digit_count = histogram[digit];
+                histogram[digit] = offset;
+                offset += digit_count;
+            }
+        }
+
+        run_chunks(chunk_count, [&](ui32 chunk) {
+            auto& histogram = histograms[chunk];
+
+            auto const last = std::min((chunk + 1) * chunk_size, count);
+            for (auto i = chunk * chunk_size; i < last; ++i)
+                target[histogram[(source[i].key >> shift) & 0xff]++] = source[i];
+        });
+
+        std::swap(source, target);
+    }
+
+    if (source != m_items.data())
+        m_items.swap(m_scratch);
+}
+
+//-----------------------------------------------------------------------------
+void render_queue::submit(VkCommandBuffer cmd_buf,
+                          uv2 size) {
+    mark_cmd_transient();
+
+    // redundant binds are elided by the command state of the buffer
+    std::optional<cmd_state> local_state;
+    auto state = cmd_state::current(cmd_buf);
+    if (!state) {
+        local_state.emplace(cmd_buf);
+        state = &*local_state;
+    }
+
+    auto const issued_count = state->get_issued_count();
+    auto const elided_count = state->get_elided_count();
+
+    for (auto const& item : m_items) {
+        auto const& packet = m_packets[item.packet];
+
+        auto pipeline = packet.pipeline;
+        if (!pipeline || !pipeline->activated() || (packet.count == 0))
+            continue;
+
+        pipeline->bind(cmd_buf);
+
+        if (pipeline->auto_sizing())
+            pipeline->set_viewport_and_scissor(cmd_buf, size);
+
+        if (pipeline->auto_line_width())
+            pipeline->set_line_width(cmd_buf);
+
+        auto layout = pipeline->get_layout();
+
+        if (packet.descriptor_set && layout)
+            layout->bind(cmd_buf, packet.descriptor_set);
+
+        if (packet.vertex_buffer) {
+            VkDeviceSize const offset = 0;
+            cmd_bind_vertex_buffers(cmd_buf, 0, 1, &packet.vertex_buffer, &offset);
+        }
+
+        if (packet.index_buffer)
+            cmd_bind_index_buffer(cmd_buf, packet.index_buffer, 0, VK_INDEX_TYPE_UINT32);
+
+        if (packet.push_constant && layout)
+            cmd_push_constants(cmd_buf,
+                               layout->get(),
+                               packet.push_constant_stages,
+                               0,
+                               packet.push_constant_size,
+                               packet.push_constant);
+
+        if (packet.index_buffer)
+            vkCmdDrawIndexed(cmd_buf,
+                             packet.count,
+                             packet.instance_count,
+                             0, 0,
+                             packet.first_instance);
+        else
+            vkCmdDraw(cmd_buf,
+                      packet.count,
+                      packet.instance_count,
+                      0,
+                      packet.first_instance);
+    }
+
+    m_bind_count = state->get_issued_count() - issued_count;
+    m_elided_count = state->get_elided_count() - elided_count;
+}
+
+} // namespace lava
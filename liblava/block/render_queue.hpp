@@ -0,0 +1,197 @@
+/**
+ * @file         liblava/block/render_queue.hpp
+ * @brief        Sorted draw submission
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/block/render_pipeline.hpp"
+#include "liblava/util/thread.hpp"
+
+namespace lava {
+
+/**
+ * @brief Draw packet of a render queue
+ */
+struct draw_packet {
+    /// Sort key (see make_sort_key)
+    ui64 key = 0;
+
+    /// Render pipeline
+    render_pipeline* pipeline = nullptr;
+
+    /// Descriptor set of set 0 (none: not bound)
+    VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+
+    /// Vertex buffer of binding 0
+    VkBuffer vertex_buffer = VK_NULL_HANDLE;
+
+    /// Index buffer with 32-bit indices (none: non-indexed draw)
+    VkBuffer index_buffer = VK_NULL_HANDLE;
+
+    /// Number of indices or vertices
+    ui32 count = 0;
+
+    /// Number of instances
+    ui32 instance_count = 1;
+
+    /// First instance
+    ui32 first_instance = 0;
+
+    /// Push constant data (must stay valid until submit)
+    void const* push_constant = nullptr;
+
+    /// Size of push constant data
+    ui32 push_constant_size = 0;
+
+    /// Shader stages of push constant
+    VkShaderStageFlags push_constant_stages = VK_SHADER_STAGE_VERTEX_BIT;
+};
+
+/**
+ * @brief Make a sort key of a draw packet
+ * @note Packets are grouped by pipeline, descriptor set and mesh, then front to back
+ * @param pipeline          Pipeline id (12 bits)
+ * @param descriptor_set    Descriptor set id (16 bits)
+ * @param mesh              Mesh id (16 bits)
+ * @param depth             View depth (0 - 1, 20 bits)
+ * @return ui64             Sort key
+ */
+inline ui64 make_sort_key(ui32 pipeline,
+                          ui32 descriptor_set,
+                          ui32 mesh,
+                          r32 depth) {
+    auto const depth_bits = ui64(std::clamp(depth, 0.f, 1.f) * 0xfffff);
+
+    return (ui64(pipeline & 0xfff) << 52)
+           | (ui64(descriptor_set & 0xffff) << 36)
+           | (ui64(mesh & 0xffff) << 20)
+           | depth_bits;
+}
+
+/**
+ * @brief Render queue
+ * @note Packets are radix sorted by key and submitted with redundant binds elided
+ */
+struct render_queue {
+    /// Pointer to render queue
+    using ptr = render_queue*;
+
+    /**
+     * @brief Destroy the render queue
+     */
+    ~render_queue();
+
+    /**
+     * @brief Push a draw packet
+     * @param packet    Draw packet
+     */
+    void push(draw_packet const& packet);
+
+    /**
+     * @brief Remove all packets
+     */
+    void clear();
+
+    /**
+     * @brief Sort packets by key (stable)
+     * @note Large queues are split over threads
+     * @param thread_count    Number of threads (0: hardware concurrency)
+     */
+    void sort(ui32 thread_count = 0);
+
+    /**
+     * @brief Submit packets in current order
+     * @note Binds go through the active cmd_state of the buffer (a local one if none)
+     * @param cmd_buf    Command buffer
+     * @param size       Size of render pass
+     */
+    void submit(VkCommandBuffer cmd_buf,
+                uv2 size);
+
+    /**
+     * @brief Get a packet in current order
+     * @param position               Position in queue
+     * @return draw_packet const&    Draw packet
+     */
+    draw_packet const& get_packet(index position) const {
+        return m_packets.at(m_items.at(position).packet);
+    }
+
+    /**
+     * @brief Get the number of packets
+     * @return size_t    Number of packets
+     */
+    size_t size() const {
+        return m_items.size();
+    }
+
+    /**
+     * @brief Check if the queue is empty
+     * @return Queue is empty or not
+     */
+    bool empty() const {
+        return m_items.empty();
+    }
+
+    /**
+     * @brief Get the number of binds of last submit
+     * @return ui32    Number of issued state calls
+     */
+    ui32 get_bind_count() const {
+        return m_bind_count;
+    }
+
+    /**
+     * @brief Get the number of elided binds of last submit
+     * @return ui32    Number of redundant state calls
+     */
+    ui32 get_elided_count() const {
+        return m_elided_count;
+    }
+
+private:
+    /**
+     * @brief Sort item
+     */
+    struct sort_item {
+        /// Sort key
+        ui64 key = 0;
+
+        /// Packet index
+        index packet = 0;
+    };
+
+    /**
+     * @brief Run a function for each chunk (on threads if more than one)
+     * @param chunk_count    Number of chunks
+     * @param func           Function with chunk index
+     */
+    void run_chunks(ui32 chunk_count,
+                    std::function<void(ui32)> const& func);
+
+    /// List of packets in push order
+    std::vector<draw_packet> m_packets;
+
+    /// Sort items in current order
+    std::vector<sort_item> m_items;
+
+    /// Sort items of previous digit
+    std::vector<sort_item> m_scratch;
+
+    /// Sort threads
+    std::unique_ptr<thread_pool> m_pool;
+
+    /// Number of sort threads
+    ui32 m_pool_thread_count = 0;
+
+    /// Number of binds of last submit
+    ui32 m_bind_count = 0;
+
+    /// Number of elided binds of last submit
+    ui32 m_elided_count = 0;
+};
+
+} // namespace lava
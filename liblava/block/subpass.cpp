@@ -7,6 +7,8 @@
 
 #include "liblava/block/subpass.hpp"
 #include "liblava/core/misc.hpp"
+#include "liblava/util/log.hpp"
+#include <numeric>
 
 namespace lava {
 
@@ -27,6 +29,10 @@ subpass::subpass() {
 //-----------------------------------------------------------------------------
 void subpass::destroy() {
     clear_pipelines();
+
+    m_queue.clear();
+
+    destroy_secondary();
 }
 
 //-----------------------------------------------------------------------------
@@ -151,9 +157,27 @@ void subpass::set_preserve_attachments(index_list const& attachments) {
     m_description.pPreserveAttachments = m_preserve_attachments.data();
 }
 
+//-----------------------------------------------------------------------------
+void subpass::process_pipeline(VkCommandBuffer cmd_buf,
+                               render_pipeline& pipeline,
+                               uv2 size) {
+    if (pipeline.auto_bind())
+        pipeline.bind(cmd_buf);
+
+    if (pipeline.auto_sizing())
+        pipeline.set_viewport_and_scissor(cmd_buf, size);
+
+    if (pipeline.auto_line_width())
+        pipeline.set_line_width(cmd_buf);
+
+    pipeline.on_process(cmd_buf);
+}
+
 //-----------------------------------------------------------------------------
 void subpass::process(VkCommandBuffer cmd_buf,
                       uv2 size) {
+    cmd_state state(cmd_buf);
+
     for (auto& pipeline : m_pipelines) {
         if (!pipeline->activated())
             continue;
@@ -161,17 +185,194 @@ void subpass::process(VkCommandBuffer cmd_buf,
         if (!pipeline->on_process)
             continue;
 
-        if (pipeline->auto_bind())
-            pipeline->bind(cmd_buf);
+        process_pipeline(cmd_buf, *pipeline, size);
+    }
 
-        if (pipeline->auto_sizing())
-            pipeline->set_viewport_and_scissor(cmd_buf, size);
+    if (!m_queue.empty()) {
+        m_queue.sort();
+        m_queue.submit(cmd_buf, size);
+        m_queue.clear();
+    }
 
-        if (pipeline->auto_line_width())
-            pipeline->set_line_width(cmd_buf);
+    m_issued_count = state.get_issued_count();
+    m_elided_count = state.get_elided_count();
+}
 
-        pipeline->on_process(cmd_buf);
+//-----------------------------------------------------------------------------
+bool subpass::create_secondary(device::ptr device,
+                               index frame_count) {
+    destroy_secondary();
+
+    if (!secondary())
+        return true;
+
+    m_device = device;
+
+    m_secondary_pools.resize(m_secondary_thread_count);
+    m_secondary_buffers.resize(m_secondary_thread_count);
+
+    for (auto thread = 0u; thread < m_secondary_thread_count; ++thread) {
+        auto& pools = m_secondary_pools.at(thread);
+        auto& buffers = m_secondary_buffers.at(thread);
+
+        pools.resize(frame_count, VK_NULL_HANDLE);
+        buffers.resize(frame_count, VK_NULL_HANDLE);
+
+        for (auto i = 0u; i < frame_count; ++i) {
+            VkCommandPoolCreateInfo const create_info{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .flags = 0,
+                .queueFamilyIndex = m_device->graphics_queue().family,
+            };
+            if (failed(m_device->call().vkCreateCommandPool(m_device->get(),
+                                                            &create_info,
+                                                            memory::instance().alloc(),
+                                                            &pools.at(i)))) {
+                logger()->error("create subpass command pool");
+                return false;
+            }
+
+            VkCommandBufferAllocateInfo const allocate_info{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = pools.at(i),
+                .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                .commandBufferCount = 1,
+            };
+            if (failed(m_device->call().vkAllocateCommandBuffers(m_device->get(),
+                                                                 &allocate_info,
+                                                                 &buffers.at(i)))) {
+                logger()->error("create subpass secondary command buffer");
+                return false;
+            }
+        }
     }
+
+    m_pool = std::make_unique<thread_pool>();
+    m_pool->setup(m_secondary_thread_count);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void subpass::destroy_secondary() {
+    if (m_pool) {
+        m_pool->teardown();
+        m_pool = nullptr;
+    }
+
+    // buffers are freed with their pools
+    for (auto& pools : m_secondary_pools)
+        for (auto& pool : pools)
+            if (pool)
+                m_device->call().vkDestroyCommandPool(m_device->get(),
+                                                      pool,
+                                                      memory::instance().alloc());
+
+    m_secondary_pools.clear();
+    m_secondary_buffers.clear();
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void subpass::process_secondary(VkCommandBuffer cmd_buf,
+                                uv2 size,
+                                index frame,
+                                VkCommandBufferInheritanceInfo const& inheritance) {
+    m_issued_count = 0;
+    m_elided_count = 0;
+
+    if (!m_pool)
+        return;
+
+    std::vector<render_pipeline*> pipelines;
+    for (auto& pipeline : m_pipelines)
+        if (pipeline->activated() && pipeline->on_process)
+            pipelines.push_back(pipeline.get());
+
+    auto const queued = !m_queue.empty();
+    if (pipelines.empty() && !queued)
+        return;
+
+    // secondaries are reset every frame, the primary must be recorded again
+    mark_cmd_transient();
+
+    if (queued)
+        m_queue.sort();
+
+    auto const pipeline_count = to_ui32(pipelines.size());
+    auto const chunk_size = std::max((pipeline_count + m_secondary_thread_count - 1)
+                                         / m_secondary_thread_count,
+                                     1u);
+    auto const thread_count = std::max((pipeline_count + chunk_size - 1) / chunk_size,
+                                       1u);
+
+    VkCommandBuffers buffers(thread_count, VK_NULL_HANDLE);
+    std::atomic<bool> recorded = true;
+
+    std::vector<ui32> issued_counts(thread_count, 0);
+    std::vector<ui32> elided_counts(thread_count, 0);
+
+    for (auto thread = 0u; thread < thread_count; ++thread) {
+        m_pool->enqueue([&, thread](id::ref) {
+            auto const pool = m_secondary_pools.at(thread).at(frame);
+            auto const buffer = m_secondary_buffers.at(thread).at(frame);
+
+            if (failed(m_device->call().vkResetCommandPool(m_device->get(), pool, 0))) {
+                recorded = false;
+                return;
+            }
+
+            VkCommandBufferBeginInfo const begin_info{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+                .pInheritanceInfo = &inheritance,
+            };
+            if (failed(m_device->call().vkBeginCommandBuffer(buffer, &begin_info))) {
+                recorded = false;
+                return;
+            }
+
+            auto const first = thread * chunk_size;
+            auto const last = std::min(first + chunk_size, pipeline_count);
+
+            {
+                // secondary command buffers start without state
+                cmd_state state(buffer);
+
+                for (auto i = first; i < last; ++i)
+                    process_pipeline(buffer, *pipelines.at(i), size);
+
+                if (queued && (thread == thread_count - 1))
+                    m_queue.submit(buffer, size);
+
+                issued_counts.at(thread) = state.get_issued_count();
+                elided_counts.at(thread) = state.get_elided_count();
+            }
+
+            if (failed(m_device->call().vkEndCommandBuffer(buffer))) {
+                recorded = false;
+                return;
+            }
+
+            buffers.at(thread) = buffer;
+        });
+    }
+
+    m_pool->wait();
+
+    m_queue.clear();
+
+    m_issued_count = std::accumulate(issued_counts.begin(), issued_counts.end(), 0u);
+    m_elided_count = std::accumulate(elided_counts.begin(), elided_counts.end(), 0u);
+
+    if (!recorded) {
+        logger()->error("record subpass secondary command buffers");
+        return;
+    }
+
+    m_device->call().vkCmdExecuteCommands(cmd_buf,
+                                          to_ui32(buffers.size()),
+                                          buffers.data());
 }
 
 //-----------------------------------------------------------------------------
@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include "liblava/block/render_pipeline.hpp"
+#include "liblava/block/render_queue.hpp"
 
 namespace lava {
 
@@ -70,14 +70,88 @@ struct subpass : entity {
      */
     void clear_pipelines();
 
+    /**
+     * @brief Get the render queue
+     * @note Packets are submitted after the pipelines and cleared on each process
+     * @return render_queue&    Render queue
+     */
+    render_queue& get_queue() {
+        return m_queue;
+    }
+
+    /**
+     * @brief Get the number of issued state calls of last process
+     * @return ui32    Number of issued binds and dynamic states
+     */
+    ui32 get_issued_count() const {
+        return m_issued_count;
+    }
+
+    /**
+     * @brief Get the number of elided state calls of last process
+     * @return ui32    Number of redundant binds and dynamic states
+     */
+    ui32 get_elided_count() const {
+        return m_elided_count;
+    }
+
     /**
      * @brief Process the subpass
+     * @note State calls are tracked per command buffer (see cmd_state),
+     *       raw binds in on_process need cmd_state::invalidate
      * @param cmd_buf    Command buffer
      * @param size       Size of render pass
      */
     void process(VkCommandBuffer cmd_buf,
                  uv2 size);
 
+    /**
+     * @brief Process the subpass with secondary command buffers
+     * @note Pipelines are split into ranges in order, on_process is called on threads,
+     *       the render queue is recorded after the last range.
+     *       Secondaries are recorded again every frame, a static block command
+     *       containing this subpass is recorded every frame (see mark_cmd_transient)
+     * @param cmd_buf        Command buffer (subpass contents: secondary)
+     * @param size           Size of render pass
+     * @param frame          Frame index
+     * @param inheritance    Render pass, subpass and framebuffer to inherit
+     */
+    void process_secondary(VkCommandBuffer cmd_buf,
+                           uv2 size,
+                           index frame,
+                           VkCommandBufferInheritanceInfo const& inheritance);
+
+    /**
+     * @brief Record pipelines into secondary command buffers
+     * @note Set before the render pass is created
+     * @param thread_count    Number of recording threads (0: inline)
+     */
+    void set_secondary(ui32 thread_count) {
+        m_secondary_thread_count = thread_count;
+    }
+
+    /**
+     * @brief Check if subpass records secondary command buffers
+     * @return Subpass contents are secondary or inline
+     */
+    bool secondary() const {
+        return m_secondary_thread_count > 0;
+    }
+
+    /**
+     * @brief Create secondary command pools and buffers
+     * @param device         Vulkan device
+     * @param frame_count    Number of frames
+     * @return Create was successful or failed
+     */
+    bool create_secondary(device::ptr device,
+                          index frame_count);
+
+    /**
+     * @brief Destroy secondary command pools and buffers
+     */
+    void destroy_secondary();
+
     /**
      * @brief Get the description
      * @return VkSubpassDescription const&    Subpass description
@@ -196,6 +270,16 @@ struct subpass : entity {
     }
 
 private:
+    /**
+     * @brief Process a render pipeline
+     * @param cmd_buf     Command buffer
+     * @param pipeline    Render pipeline
+     * @param size        Size of render pass
+     */
+    void process_pipeline(VkCommandBuffer cmd_buf,
+                          render_pipeline& pipeline,
+                          uv2 size);
+
     /// Vulkan subpass description
     VkSubpassDescription m_description;
 
@@ -219,6 +303,30 @@ private:
 
     /// List of render pipelines
     render_pipeline::s_list m_pipelines;
+
+    /// Sorted draw packets
+    render_queue m_queue;
+
+    /// Number of issued state calls of last process
+    ui32 m_issued_count = 0;
+
+    /// Number of elided state calls of last process
+    ui32 m_elided_count = 0;
+
+    /// Number of secondary recording threads (0: inline)
+    ui32 m_secondary_thread_count = 0;
+
+    /// Vulkan device of secondary command buffers
+    device::ptr m_device = nullptr;
+
+    /// Secondary command pools of each thread by frame
+    std::vector<VkCommandPools> m_secondary_pools;
+
+    /// Secondary command buffers of each thread by frame
+    std::vector<VkCommandBuffers> m_secondary_buffers;
+
+    /// Secondary recording threads
+    std::unique_ptr<thread_pool> m_pool;
 };
 
 /**
@@ -0,0 +1,114 @@
+/**
+ * @file         liblava/block/test/descriptor_allocator.cpp
+ * @brief        Descriptor allocator unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+namespace {
+
+/**
+ * @brief Make a fake Vulkan handle (never passed to Vulkan)
+ * @tparam T       Handle type
+ * @param value    Handle value
+ * @return T       Vulkan handle
+ */
+template<typename T>
+T make_handle(ui64 value) {
+    if constexpr (std::is_pointer_v<T>)
+        return reinterpret_cast<T>(static_cast<uintptr_t>(value));
+    else
+        return T(value);
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("descriptor write equality", "[descriptor]") {
+    descriptor_write const write{
+        .binding = 1,
+        .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        .buffer_info = {make_handle<VkBuffer>(1), 0, 256},
+    };
+
+    auto other = write;
+    REQUIRE(other == write);
+
+    auto const layout = make_handle<VkDescriptorSetLayout>(1);
+    REQUIRE(descriptor_cache::hash(layout, {write})
+            == descriptor_cache::hash(layout, {other}));
+
+    other.buffer_info.offset = 256;
+    REQUIRE_FALSE(other == write);
+
+    other = write;
+    other.buffer_info.buffer = make_handle<VkBuffer>(2);
+    REQUIRE_FALSE(other == write);
+
+    other = write;
+    other.element = 1;
+    REQUIRE_FALSE(other == write);
+
+    other = write;
+    other.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    REQUIRE_FALSE(other == write);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("descriptor cache", "[descriptor]") {
+    auto const layout = make_handle<VkDescriptorSetLayout>(1);
+
+    descriptor_write const texture{
+        .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .image_info = {make_handle<VkSampler>(1),
+                       make_handle<VkImageView>(1),
+                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+    };
+
+    auto other_texture = texture;
+    other_texture.image_info.imageView = make_handle<VkImageView>(2);
+
+    auto const set = make_handle<VkDescriptorSet>(1);
+    auto const other_set = make_handle<VkDescriptorSet>(2);
+
+    descriptor_cache cache;
+
+    SECTION("hit and miss") {
+        auto const hash = descriptor_cache::hash(layout, {texture});
+        cache.add(hash, layout, {texture}, set);
+
+        REQUIRE(cache.find(hash, layout, {texture}) == set);
+        REQUIRE(cache.find(descriptor_cache::hash(layout, {other_texture}),
+                           layout, {other_texture})
+                == VK_NULL_HANDLE);
+
+        // same writes with another layout
+        auto const other_layout = make_handle<VkDescriptorSetLayout>(2);
+        REQUIRE(cache.find(descriptor_cache::hash(other_layout, {texture}),
+                           other_layout, {texture})
+                == VK_NULL_HANDLE);
+    }
+
+    SECTION("hash collision") {
+        // contents forced into one bucket are told apart by their writes
+        size_t const hash = 42;
+        cache.add(hash, layout, {texture}, set);
+        cache.add(hash, layout, {other_texture}, other_set);
+
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.find(hash, layout, {texture}) == set);
+        REQUIRE(cache.find(hash, layout, {other_texture}) == other_set);
+        REQUIRE(cache.find(hash, layout, {texture, other_texture}) == VK_NULL_HANDLE);
+    }
+
+    SECTION("clear") {
+        auto const hash = descriptor_cache::hash(layout, {texture});
+        cache.add(hash, layout, {texture}, set);
+        cache.clear();
+
+        REQUIRE(cache.size() == 0);
+        REQUIRE(cache.find(hash, layout, {texture}) == VK_NULL_HANDLE);
+    }
+}
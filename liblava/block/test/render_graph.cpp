@@ -0,0 +1,114 @@
+/**
+ * @file         liblava/block/test/render_graph.cpp
+ * @brief        Render graph unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("render graph schedule", "[graph]") {
+    render_graph graph;
+
+    auto const backbuffer = graph.import_image("backbuffer", nullptr,
+                                               VK_IMAGE_LAYOUT_UNDEFINED,
+                                               VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    auto const color = graph.add_image("color", VK_FORMAT_R8G8B8A8_UNORM, {64, 64});
+
+    SECTION("cull unused passes") {
+        auto const unused = graph.add_image("unused", VK_FORMAT_R8G8B8A8_UNORM, {64, 64});
+
+        auto const scene = graph.add_pass("scene", {});
+        graph.write(scene, color, graph_usage::color_attachment);
+
+        auto const debug = graph.add_pass("debug", {});
+        graph.write(debug, unused, graph_usage::color_attachment);
+
+        auto const present = graph.add_pass("present", {});
+        graph.read(present, color, graph_usage::sampled);
+        graph.write(present, backbuffer, graph_usage::color_attachment);
+
+        auto const readback = graph.add_pass("readback", {}, true);
+
+        REQUIRE(graph.schedule());
+
+        REQUIRE_FALSE(graph.culled(scene));
+        REQUIRE(graph.culled(debug));
+        REQUIRE_FALSE(graph.culled(present));
+        REQUIRE_FALSE(graph.culled(readback));
+
+        REQUIRE(graph.get_order() == index_list{scene, present, readback});
+    }
+
+    SECTION("overwrite culls earlier writer") {
+        auto const clear = graph.add_pass("clear", {});
+        graph.write(clear, color, graph_usage::transfer_dst);
+
+        auto const scene = graph.add_pass("scene", {});
+        graph.write(scene, color, graph_usage::color_attachment);
+
+        auto const present = graph.add_pass("present", {});
+        graph.read(present, color, graph_usage::sampled);
+        graph.write(present, backbuffer, graph_usage::color_attachment);
+
+        REQUIRE(graph.schedule());
+        REQUIRE(graph.culled(clear));
+
+        // preserved content keeps the earlier writer
+        graph.write(scene, color, graph_usage::color_attachment, true);
+
+        REQUIRE(graph.schedule());
+        REQUIRE_FALSE(graph.culled(clear));
+        REQUIRE(graph.get_order() == index_list{clear, scene, present});
+    }
+
+    SECTION("read before write") {
+        auto const present = graph.add_pass("present", {});
+        graph.read(present, color, graph_usage::sampled);
+        graph.write(present, backbuffer, graph_usage::color_attachment);
+
+        auto const scene = graph.add_pass("scene", {});
+        graph.write(scene, color, graph_usage::color_attachment);
+
+        REQUIRE_FALSE(graph.schedule());
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("render graph aliasing", "[graph]") {
+    auto const range = [](index first, index last, VkDeviceSize size, ui32 memory_type_bits = 1) {
+        return alias_range{first, last, {size, 256, memory_type_bits}};
+    };
+
+    SECTION("disjoint lifetimes share memory") {
+        auto const blocks = assign_alias_blocks({
+            range(0, 1, 4096),
+            range(1, 2, 2048),
+            range(2, 3, 1024),
+        });
+
+        // touching lifetimes overlap, the last image reuses the first block
+        REQUIRE(blocks == index_list{0, 1, 0});
+    }
+
+    SECTION("largest image opens the block") {
+        auto const blocks = assign_alias_blocks({
+            range(0, 0, 1024),
+            range(1, 1, 4096),
+            range(0, 1, 2048),
+        });
+
+        REQUIRE(blocks == index_list{0, 0, 1});
+    }
+
+    SECTION("memory types must match") {
+        auto const blocks = assign_alias_blocks({
+            range(0, 0, 1024, 0b01),
+            range(1, 1, 1024, 0b10),
+            range(2, 2, 1024, 0b11),
+        });
+
+        REQUIRE(blocks == index_list{0, 1, 0});
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file         liblava/block/test/render_queue.cpp
+ * @brief        Render queue unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("render queue sort", "[queue]") {
+    SECTION("sort key") {
+        auto const front = make_sort_key(1, 2, 3, 0.f);
+        auto const back = make_sort_key(1, 2, 3, 1.f);
+        REQUIRE(front < back);
+
+        // pipeline outranks depth
+        REQUIRE(make_sort_key(0, 0, 0, 1.f) < make_sort_key(1, 0, 0, 0.f));
+        REQUIRE(make_sort_key(0, 1, 0, 0.f) < make_sort_key(0, 1, 1, 0.f));
+    }
+
+    // small queue and radix sort over threads
+    for (auto const count : {100u, 70000u}) {
+        render_queue queue;
+
+        for (auto i = 0u; i < count; ++i)
+            queue.push({.key = ui64((i * 7919u) % 1000u),
+                        .count = i});
+
+        queue.sort(4);
+
+        REQUIRE(queue.size() == count);
+
+        for (auto i = 1u; i < count; ++i) {
+            auto const& previous = queue.get_packet(i - 1);
+            auto const& current = queue.get_packet(i);
+
+            REQUIRE(previous.key <= current.key);
+
+            // equal keys stay in push order
+            if (previous.key == current.key)
+                REQUIRE(previous.count < current.count);
+        }
+
+        queue.clear();
+        REQUIRE(queue.empty());
+    }
+}
@@ -35,6 +35,12 @@ bool engine::setup() {
         return run_continue;
     });
 
+    add_run([&](id::ref) {
+        producer.update();
+
+        return run_continue;
+    });
+
     add_run_end([&]() {
         producer.destroy();
     });
@@ -18,8 +18,12 @@ namespace lava {
 
 //-----------------------------------------------------------------------------
 mesh::s_ptr producer::create_mesh(mesh_type mesh_type) {
-    auto product = lava::create_mesh(app->device,
-                                     mesh_type);
+    auto product = mesh::make();
+    product->set_data(create_mesh_data(mesh_type));
+
+    if (!product->create(app->device, &app->staging))
+        return nullptr;
+
     if (!add_mesh(product))
         return nullptr;
 
@@ -38,7 +42,8 @@ mesh::s_ptr producer::get_mesh(string_ref name) {
 
     auto product = load_mesh(app->device,
                              app->props.get_filename(name),
-                             app->fs.get_pref_dir() + _cache_path_ + _temp_path_);
+                             app->fs.get_pref_dir() + _cache_path_ + _temp_path_,
+                             &app->staging);
     if (!product)
         return nullptr;
 
@@ -78,7 +83,7 @@ texture::s_ptr producer::get_texture(string_ref name) {
     }
 
     auto product = load_texture(app->device,
-                                app->props.get_filename(name));
+                                get_texture_file(name));
     if (!product)
         return nullptr;
 
@@ -88,6 +93,123 @@ texture::s_ptr producer::get_texture(string_ref name) {
     return product;
 }
 
+//-----------------------------------------------------------------------------
+texture::s_ptr producer::get_texture_async(string_ref name,
+                                           texture_stream::ready_func on_ready) {
+    for (auto& [id, meta] : textures.get_all_meta()) {
+        if (meta == name) {
+            auto product = textures.get(id);
+            if (on_ready)
+                on_ready(product);
+
+            return product;
+        }
+    }
+
+    if (!m_texture_stream.ready()
+        && !m_texture_stream.setup(app->device, &app->staging))
+        return nullptr;
+
+    // already requested
+    if (!m_texture_requests.add(name, on_ready))
+        return m_texture_stream.get_placeholder();
+
+    auto const path = app->props.get_filename(name);
+
+    auto result = m_texture_stream.request(
+        [&, prop = string(name), path]() {
+            // cooked on texture stream workers: compress on this thread
+            return load_texture(app->device, cook_texture(prop, path, 1));
+        },
+        path,
+        [&, prop = string(name)](texture::s_ptr product) {
+            // failed loads are not cached, the name can be requested again
+            if (product)
+                textures.add(product, prop);
+
+            m_texture_requests.finish(prop, product);
+        });
+
+    if (!result)
+        m_texture_requests.finish(name, nullptr);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+texture_file producer::get_texture_file(string_ref name) {
+    return cook_texture(name, app->props.get_filename(name));
+}
+
+//-----------------------------------------------------------------------------
+texture_file producer::cook_texture(string_ref name,
+                                    string_ref path,
+                                    ui32 thread_count) {
+    texture_file result{path, VK_FORMAT_R8G8B8A8_SRGB};
+
+    if (texture_compression == block_format::none
+        || extension(path, {"DDS", "KTX", "KMG"}))
+        return result;
+
+    auto cache_name = name + "." + std::to_string(to_ui32(texture_compression));
+    std::replace_if(
+        cache_name.begin(), cache_name.end(),
+        [](char c) {
+            return c == '/' || c == '\\' || c == ':';
+        },
+        '_');
+
+    texture_file const cached{
+        app->fs.get_pref_dir() + _cache_path_ + _texture_path_ + cache_name + ".ktx",
+        get_block_format(texture_compression),
+    };
+
+    std::shared_ptr<std::mutex> cook_mutex;
+    {
+        std::unique_lock<std::mutex> lock(m_texture_cache_mutex);
+
+        auto& item = m_texture_cooks[cache_name];
+        if (!item)
+            item = std::make_shared<std::mutex>();
+
+        cook_mutex = item;
+    }
+
+    // same name waits for the running cook, then finds it cached
+    std::unique_lock<std::mutex> cook_lock(*cook_mutex);
+
+    {
+        std::unique_lock<std::mutex> lock(m_texture_cache_mutex);
+
+        if (valid_hash(_texture_path_, cache_name)
+            && std::filesystem::exists(cached.path))
+            return cached;
+
+        if (!app->fs.create_folder(string(_cache_path_) + _texture_path_))
+            return result;
+    }
+
+    auto image = load_image(path);
+    if (!image)
+        return result;
+
+    if (!write_compressed_texture(cached.path, image, texture_compression,
+                                  true, thread_count))
+        return result;
+
+    u_data source;
+    if (load_file_data(path, source)) {
+        auto const hash = hash256({source.addr, source.size});
+
+        std::unique_lock<std::mutex> lock(m_texture_cache_mutex);
+        update_hash(_texture_path_, cache_name, {{path, hash}});
+    }
+
+    logger()->info("texture cached: {} - {}", name, cached.path);
+
+    return cached;
+}
+
 //-----------------------------------------------------------------------------
 bool producer::add_texture(texture::s_ptr product) {
     if (!product)
@@ -117,7 +239,7 @@ c_data producer::get_shader(string_ref name,
                     + name + ".spirv";
 
     if (!reload) {
-        if (valid_shader(name)) {
+        if (valid_hash(_shader_path_, name)) {
             data module_data;
             if (load_file_data(filename, module_data)) {
                 m_shaders.emplace(name, module_data);
@@ -348,7 +470,7 @@ data producer::compile_shader(c_data product,
     }
 
     file_hash_map.emplace(filename, hash256(product_str));
-    update_hash(name, file_hash_map);
+    update_hash(_shader_path_, name, file_hash_map);
 
     std::vector<ui32> const module_result = {module.cbegin(),
                                              module.cend()};
@@ -367,6 +489,9 @@ data producer::compile_shader(c_data product,
 
 //-----------------------------------------------------------------------------
 void producer::destroy() {
+    m_texture_stream.teardown();
+    m_texture_requests.clear();
+
     for (auto& [id, mesh] : meshes.get_all())
         mesh->destroy();
 
@@ -387,12 +512,13 @@ void producer::clear() {
 }
 
 //-----------------------------------------------------------------------------
-void producer::update_hash(string_ref name,
+void producer::update_hash(string_ref path,
+                           string_ref name,
                            string_map_ref file_hash_map) const {
-    if (!app->fs.create_folder(string(_cache_path_) + _shader_path_))
+    if (!app->fs.create_folder(string(_cache_path_) + path))
         return;
 
-    auto filename = app->fs.get_pref_dir() + _cache_path_ + _shader_path_ + _hash_json_;
+    auto filename = app->fs.get_pref_dir() + _cache_path_ + path + _hash_json_;
     json_file hash_file(filename);
 
     json_file::callback callback;
@@ -408,10 +534,11 @@ void producer::update_hash(string_ref name,
 }
 
 //-----------------------------------------------------------------------------
-bool producer::valid_shader(string_ref name) const {
+bool producer::valid_hash(string_ref path,
+                          string_ref name) const {
     auto valid = true;
 
-    auto filename = app->fs.get_pref_dir() + _cache_path_ + _shader_path_ + _hash_json_;
+    auto filename = app->fs.get_pref_dir() + _cache_path_ + path + _hash_json_;
     json_file hash_file(filename);
 
     json_file::callback callback;
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include "liblava/asset/compress_texture.hpp"
+#include "liblava/asset/texture_stream.hpp"
 #include "liblava/fwd.hpp"
 #include "liblava/resource.hpp"
 
@@ -18,6 +20,9 @@ constexpr name _shader_path_ = "shader/";
 /// temp folder
 constexpr name _temp_path_ = "temp/";
 
+/// texture folder
+constexpr name _texture_path_ = "texture/";
+
 /// hash file
 constexpr name _hash_json_ = "hash.json";
 
@@ -66,6 +71,23 @@ struct producer {
      */
     texture::s_ptr get_texture(string_ref name);
 
+    /**
+     * @brief Get texture by prop name, load it on worker threads
+     * @param name               Name of prop
+     * @param on_ready           Called when texture is uploaded (nullptr: failed, can be requested again)
+     * @return texture::s_ptr    Texture if already loaded, otherwise placeholder
+     */
+    texture::s_ptr get_texture_async(string_ref name,
+                                     texture_stream::ready_func on_ready = {});
+
+    /**
+     * @brief Get the texture file of a prop
+     * @note Compresses and caches the texture if texture compression is set
+     * @param name             Name of prop
+     * @return texture_file    Cached compressed file or prop file
+     */
+    texture_file get_texture_file(string_ref name);
+
     /**
      * @brief Add texture to products
      * @param product    Texture
@@ -102,6 +124,13 @@ struct producer {
                         string_ref name,
                         string_ref filename) const;
 
+    /**
+     * @brief Update streamed products (call on main thread)
+     */
+    void update() {
+        m_texture_stream.update();
+    }
+
     /**
      * @brief Destroy all products
      */
@@ -144,27 +173,61 @@ struct producer {
     /// Shader debug information
     bool shader_debug = false;
 
+    /// Block compression of textures (none: upload decoded texels)
+    block_format texture_compression = block_format::none;
+
 private:
     /**
      * @brief Update file hash
+     * @param path             Cache folder
      * @param name             Target file
      * @param file_hash_map    Map of used files with hash
      */
-    void update_hash(string_ref name,
+    void update_hash(string_ref path,
+                     string_ref name,
                      string_map_ref file_hash_map) const;
 
     /**
-     * @brief Check if shader file(s) changed
-     * @param name      Name of shader
-     * @return Shader is valid or has changed
+     * @brief Check if cached file(s) changed
+     * @param path      Cache folder
+     * @param name      Name of cached product
+     * @return Cache is valid or has changed
+     */
+    bool valid_hash(string_ref path,
+                    string_ref name) const;
+
+    /**
+     * @brief Compress texture file and cache the result
+     * @note Textures of different names are cooked in parallel
+     * @param name             Name of prop
+     * @param path             File path of prop
+     * @param thread_count     Number of compression threads (0: hardware concurrency)
+     * @return texture_file    Cached compressed file or prop file
      */
-    bool valid_shader(string_ref name) const;
+    texture_file cook_texture(string_ref name,
+                              string_ref path,
+                              ui32 thread_count = 0);
 
     /// Map of shader products
     using shader_map = std::map<string, data>;
 
     /// Shader products
     shader_map m_shaders;
+
+    /// Texture stream
+    texture_stream m_texture_stream;
+
+    /// Streamed texture requests
+    texture_requests m_texture_requests;
+
+    /// Mutex for texture cache hashes and cook mutexes (cooked on worker threads)
+    std::mutex m_texture_cache_mutex;
+
+    /// Map of cook mutexes by cache name
+    using cook_mutex_map = std::map<string, std::shared_ptr<std::mutex>>;
+
+    /// Cook mutexes (one cook per cache name at a time)
+    cook_mutex_map m_texture_cooks;
 };
 
 } // namespace lava
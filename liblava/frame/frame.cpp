@@ -151,6 +151,20 @@ bool frame::setup() {
     m_env.param.extensions.push_back("VK_KHR_get_physical_device_properties2");
 #endif
 
+    // feature queries of device extensions (e.g. descriptor indexing) on Vulkan 1.0
+    if ((m_env.info.req_api_version == api_version::v1_0)
+        && !exists(m_env.param.extensions, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
+        auto const properties = enumerate_extension_properties();
+        auto const available = std::any_of(properties.begin(), properties.end(),
+                                           [](VkExtensionProperties const& property) {
+                                               return strcmp(property.extensionName,
+                                                             VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)
+                                                      == 0;
+                                           });
+        if (available)
+            m_env.param.extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    }
+
     if (!instance::singleton().create(m_env.param, m_env.debug, m_env.info)) {
         logger()->error("create instance");
         return false;
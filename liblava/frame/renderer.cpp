@@ -164,6 +164,21 @@ bool renderer::end_frame(VkCommandBuffers const& cmd_buffers) {
     if (!user_frame_wait_stages.empty())
         append(wait_stages, user_frame_wait_stages);
 
+    // binary semaphores ignore their wait value
+    std::vector<ui64> wait_values(wait_semaphores.size(), 0);
+
+    if (!m_timeline_wait_semaphores.empty()) {
+        append(wait_semaphores, m_timeline_wait_semaphores);
+        append(wait_stages, m_timeline_wait_stages);
+        append(wait_values, m_timeline_wait_values);
+    }
+
+    VkTimelineSemaphoreSubmitInfo const timeline_info{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = to_ui32(wait_values.size()),
+        .pWaitSemaphoreValues = wait_values.data(),
+    };
+
     std::array<VkSemaphore, 1> const sync_present_semaphores = {
         m_render_complete_semaphores[m_current_sync]};
 
@@ -176,6 +191,7 @@ bool renderer::end_frame(VkCommandBuffers const& cmd_buffers) {
 
     VkSubmitInfo const submit_info{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = m_timeline_wait_semaphores.empty() ? nullptr : &timeline_info,
         .waitSemaphoreCount = to_ui32(wait_semaphores.size()),
         .pWaitSemaphores = wait_semaphores.data(),
         .pWaitDstStageMask = wait_stages.data(),
@@ -187,10 +203,16 @@ bool renderer::end_frame(VkCommandBuffers const& cmd_buffers) {
 
     std::array<VkSubmitInfo, 1> const submit_infos = {submit_info};
     VkFence current_fence = m_fences[m_current_sync];
-    if (!m_device->vkQueueSubmit(m_graphics_queue.vk_queue,
-                                 to_ui32(submit_infos.size()),
-                                 submit_infos.data(),
-                                 current_fence))
+    auto submitted = m_device->vkQueueSubmit(m_graphics_queue.vk_queue,
+                                             to_ui32(submit_infos.size()),
+                                             submit_infos.data(),
+                                             current_fence);
+
+    m_timeline_wait_semaphores.clear();
+    m_timeline_wait_values.clear();
+    m_timeline_wait_stages.clear();
+
+    if (!submitted)
         return false;
 
     std::array<VkSwapchainKHR, 1> const swapchains = {m_target->get()};
@@ -59,6 +59,20 @@ struct renderer : entity {
         return end_frame(cmd_buffers);
     }
 
+    /**
+     * @brief Wait for a timeline semaphore value in the next frame submit
+     * @param semaphore    Timeline semaphore
+     * @param value        Value to wait for
+     * @param stage        Pipeline wait stage
+     */
+    void add_timeline_wait(VkSemaphore semaphore,
+                           ui64 value,
+                           VkPipelineStageFlags stage) {
+        m_timeline_wait_semaphores.push_back(semaphore);
+        m_timeline_wait_values.push_back(value);
+        m_timeline_wait_stages.push_back(stage);
+    }
+
     /**
      * @brief Get the current frame index
      * @return index    Frame index
@@ -123,6 +137,15 @@ private:
 
     /// List of render complete semaphores
     VkSemaphores m_render_complete_semaphores = {};
+
+    /// Timeline semaphores to wait for in next frame
+    VkSemaphores m_timeline_wait_semaphores;
+
+    /// Timeline semaphore values to wait for in next frame
+    std::vector<ui64> m_timeline_wait_values;
+
+    /// Pipeline wait stages of timeline semaphores
+    VkPipelineStageFlagsList m_timeline_wait_stages;
 };
 
 } // namespace lava
@@ -7,8 +7,14 @@
 
 #pragma once
 
+#include "liblava/resource/barrier_batch.hpp"
+#include "liblava/resource/bindless_table.hpp"
 #include "liblava/resource/buffer.hpp"
 #include "liblava/resource/format.hpp"
+#include "liblava/resource/geometry_arena.hpp"
 #include "liblava/resource/image.hpp"
+#include "liblava/resource/instance_buffer.hpp"
 #include "liblava/resource/mesh.hpp"
+#include "liblava/resource/staging.hpp"
 #include "liblava/resource/texture.hpp"
+#include "liblava/resource/upload_scheduler.hpp"
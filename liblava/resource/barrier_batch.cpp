@@ -0,0 +1,114 @@
+/**
+ * @file         liblava/resource/barrier_batch.cpp
+ * @brief        Image barrier batch
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/barrier_batch.hpp"
+#include "liblava/resource/format.hpp"
+
+namespace lava {
+
+namespace {
+
+/// Accesses which write memory
+constexpr VkAccessFlags2 write_access_mask = VK_ACCESS_2_SHADER_WRITE_BIT
+                                             | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+                                             | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                                             | VK_ACCESS_2_TRANSFER_WRITE_BIT
+                                             | VK_ACCESS_2_HOST_WRITE_BIT
+                                             | VK_ACCESS_2_MEMORY_WRITE_BIT
+                                             | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool barrier_batch::transition(image::s_ptr const& img,
+                               VkImageLayout layout,
+                               VkPipelineStageFlags2 stage,
+                               VkAccessFlags2 access,
+                               bool discard) {
+    auto const current = img->get_state();
+    auto const layout_change = current.layout != layout;
+    auto const write_access = access & write_access_mask;
+
+    auto next = current;
+    next.layout = layout;
+
+    auto src_stage = current.write_stage | current.read_stage;
+
+    if (write_access) {
+        next.write_stage = stage;
+        next.write_access = write_access;
+        next.visible_stage = VK_PIPELINE_STAGE_2_NONE;
+        next.read_stage = VK_PIPELINE_STAGE_2_NONE;
+    } else if (layout_change) {
+        // transition is ordered before the stages, reads chain on them
+        next.write_stage = stage;
+        next.write_access = VK_ACCESS_2_NONE;
+        next.visible_stage = stage;
+        next.read_stage = stage;
+    } else {
+        next.read_stage |= stage;
+
+        // read after read or last write already visible to the stages
+        if (!current.write_stage || !(stage & ~current.visible_stage)) {
+            img->set_state(next);
+
+            ++m_skipped_count;
+            return false;
+        }
+
+        next.visible_stage |= stage;
+
+        // read after read needs no execution dependency
+        src_stage = current.write_stage;
+    }
+
+    img->set_state(next);
+
+    // barriers of one command are unordered, the last transition wins
+    for (auto& barrier : m_barriers) {
+        if (barrier.image != img->get())
+            continue;
+
+        barrier.dstStageMask |= stage;
+        barrier.dstAccessMask |= access;
+        barrier.newLayout = layout;
+        return true;
+    }
+
+    auto range = img->get_subresource_range();
+    range.aspectMask = format_aspect_mask(img->get_format());
+
+    m_barriers.push_back({
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .srcStageMask = src_stage ? src_stage
+                                  : VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+        .srcAccessMask = current.write_access,
+        .dstStageMask = stage,
+        .dstAccessMask = access,
+        .oldLayout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : current.layout,
+        .newLayout = layout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = img->get(),
+        .subresourceRange = range,
+    });
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void barrier_batch::add(VkImageMemoryBarrier2 const& barrier) {
+    m_barriers.push_back(barrier);
+}
+
+//-----------------------------------------------------------------------------
+void barrier_batch::flush(VkCommandBuffer cmd_buf) {
+    insert_image_memory_barriers(m_device, cmd_buf, m_barriers);
+    m_barriers.clear();
+}
+
+} // namespace lava
@@ -0,0 +1,90 @@
+/**
+ * @file         liblava/resource/barrier_batch.hpp
+ * @brief        Image barrier batch
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/image.hpp"
+
+namespace lava {
+
+/**
+ * @brief Image barrier batch
+ * @note Accumulates transitions of tracked images and inserts them with one command
+ */
+struct barrier_batch {
+    /**
+     * @brief Construct a new barrier batch
+     * @param device    Vulkan device
+     */
+    explicit barrier_batch(device::ptr device)
+    : m_device(device) {}
+
+    /**
+     * @brief Transition a tracked image
+     * @note Skipped for reads in the current layout when the last write
+     *       is already visible to the stages, the image state is updated at once
+     * @param img         Target image
+     * @param layout      New image layout
+     * @param stage       Destination pipeline stages
+     * @param access      Destination accesses
+     * @param discard     Previous content is not needed
+     * @return Barrier was added or skipped
+     */
+    bool transition(image::s_ptr const& img,
+                    VkImageLayout layout,
+                    VkPipelineStageFlags2 stage,
+                    VkAccessFlags2 access,
+                    bool discard = false);
+
+    /**
+     * @brief Add an untracked image barrier
+     * @param barrier    Image memory barrier
+     */
+    void add(VkImageMemoryBarrier2 const& barrier);
+
+    /**
+     * @brief Insert all barriers with one command and clear the batch
+     * @param cmd_buf    Command buffer
+     */
+    void flush(VkCommandBuffer cmd_buf);
+
+    /**
+     * @brief Check if the batch is empty
+     * @return Batch is empty or not
+     */
+    bool empty() const {
+        return m_barriers.empty();
+    }
+
+    /**
+     * @brief Get the number of barriers in batch
+     * @return size_t    Number of barriers
+     */
+    size_t size() const {
+        return m_barriers.size();
+    }
+
+    /**
+     * @brief Get the number of skipped transitions
+     * @return ui32    Number of skipped transitions
+     */
+    ui32 get_skipped_count() const {
+        return m_skipped_count;
+    }
+
+private:
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// List of image memory barriers
+    std::vector<VkImageMemoryBarrier2> m_barriers;
+
+    /// Number of skipped transitions
+    ui32 m_skipped_count = 0;
+};
+
+} // namespace lava
@@ -0,0 +1,296 @@
+/**
+ * @file         liblava/resource/bindless_table.cpp
+ * @brief        Bindless descriptor table
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/bindless_table.hpp"
+#include "liblava/base/cmd_state.hpp"
+#include "liblava/util/log.hpp"
+#include <array>
+#include <unordered_map>
+
+namespace lava {
+
+namespace {
+
+/// Bindless table registry mutex
+std::mutex registry_mutex;
+
+/// Bindless tables by device
+std::unordered_map<device::ptr, bindless_table::ptr> registry;
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+void slot_allocator::reset(ui32 capacity) {
+    m_free.clear();
+    m_allocated.assign(capacity, false);
+    m_next = 0;
+    m_capacity = capacity;
+    m_used = 0;
+}
+
+//-----------------------------------------------------------------------------
+ui32 slot_allocator::alloc() {
+    ui32 result = no_index;
+
+    // fresh slots first to delay reuse of freed ones
+    if (m_next < m_capacity) {
+        result = m_next++;
+    } else if (!m_free.empty()) {
+        result = m_free.front();
+        m_free.pop_front();
+    } else {
+        return no_index;
+    }
+
+    m_allocated[result] = true;
+    ++m_used;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+bool slot_allocator::free(ui32 slot) {
+    if ((slot >= m_next) || !m_allocated[slot])
+        return false;
+
+    m_allocated[slot] = false;
+    m_free.push_back(slot);
+    --m_used;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bindless_table::ptr bindless_table::find(device::ptr device) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    auto const item = registry.find(device);
+    return item != registry.end() ? item->second : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+bool bindless_table::create(device::ptr device,
+                            ui32 max_textures,
+                            ui32 max_buffers) {
+    if (!device->has_descriptor_indexing()) {
+        logger()->error("create bindless table - descriptor indexing not enabled");
+        return false;
+    }
+
+    if (find(device)) {
+        logger()->error("create bindless table - device has a table");
+        return false;
+    }
+
+    m_device = device;
+
+    // slots are written while frames using other slots are pending
+    VkDescriptorBindingFlags const binding_flags =
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+        | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT
+        | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+
+    std::array<VkDescriptorBindingFlags, 2> const flags = {binding_flags,
+                                                           binding_flags};
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo const flags_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = to_ui32(flags.size()),
+        .pBindingFlags = flags.data(),
+    };
+
+    std::array<VkDescriptorSetLayoutBinding, 2> const bindings = {{
+        {
+            .binding = texture_binding,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = max_textures,
+            .stageFlags = VK_SHADER_STAGE_ALL,
+        },
+        {
+            .binding = buffer_binding,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = max_buffers,
+            .stageFlags = VK_SHADER_STAGE_ALL,
+        },
+    }};
+
+    VkDescriptorSetLayoutCreateInfo const layout_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &flags_info,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = to_ui32(bindings.size()),
+        .pBindings = bindings.data(),
+    };
+
+    if (failed(m_device->call().vkCreateDescriptorSetLayout(m_device->get(),
+                                                            &layout_info,
+                                                            memory::instance().alloc(),
+                                                            &m_layout))) {
+        logger()->error("create bindless table layout");
+        destroy();
+        return false;
+    }
+
+    std::array<VkDescriptorPoolSize, 2> const sizes = {{
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, max_textures},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, max_buffers},
+    }};
+
+    VkDescriptorPoolCreateInfo const pool_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = to_ui32(sizes.size()),
+        .pPoolSizes = sizes.data(),
+    };
+
+    if (failed(m_device->call().vkCreateDescriptorPool(m_device->get(),
+                                                       &pool_info,
+                                                       memory::instance().alloc(),
+                                                       &m_pool))) {
+        logger()->error("create bindless table pool");
+        destroy();
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo const alloc_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = m_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &m_layout,
+    };
+
+    if (failed(m_device->call().vkAllocateDescriptorSets(m_device->get(),
+                                                         &alloc_info,
+                                                         &m_descriptor_set))) {
+        logger()->error("allocate bindless table set");
+        destroy();
+        return false;
+    }
+
+    m_textures.reset(max_textures);
+    m_buffers.reset(max_buffers);
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry[m_device] = this;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void bindless_table::destroy() {
+    if (!m_device)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+
+        auto const item = registry.find(m_device);
+        if ((item != registry.end()) && (item->second == this))
+            registry.erase(item);
+    }
+
+    if (m_pool) {
+        m_device->call().vkDestroyDescriptorPool(m_device->get(),
+                                                 m_pool,
+                                                 memory::instance().alloc());
+        m_pool = VK_NULL_HANDLE;
+    }
+
+    if (m_layout) {
+        m_device->call().vkDestroyDescriptorSetLayout(m_device->get(),
+                                                      m_layout,
+                                                      memory::instance().alloc());
+        m_layout = VK_NULL_HANDLE;
+    }
+
+    m_descriptor_set = VK_NULL_HANDLE;
+
+    m_textures.reset(0);
+    m_buffers.reset(0);
+
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+index bindless_table::add_texture(VkDescriptorImageInfo const& info) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto const slot = m_textures.alloc();
+    if (slot == no_index) {
+        logger()->error("bindless table - texture array is full");
+        return no_index;
+    }
+
+    write(texture_binding, slot, &info, nullptr);
+    return slot;
+}
+
+//-----------------------------------------------------------------------------
+void bindless_table::remove_texture(index slot) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // partially bound: stale descriptor stays until slot is reused
+    if (!m_textures.free(slot))
+        logger()->warn("bindless table - texture slot {} not in use", slot);
+}
+
+//-----------------------------------------------------------------------------
+index bindless_table::add_buffer(VkDescriptorBufferInfo const& info) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto const slot = m_buffers.alloc();
+    if (slot == no_index) {
+        logger()->error("bindless table - buffer array is full");
+        return no_index;
+    }
+
+    write(buffer_binding, slot, nullptr, &info);
+    return slot;
+}
+
+//-----------------------------------------------------------------------------
+void bindless_table::remove_buffer(index slot) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_buffers.free(slot))
+        logger()->warn("bindless table - buffer slot {} not in use", slot);
+}
+
+//-----------------------------------------------------------------------------
+void bindless_table::bind(VkCommandBuffer cmd_buf,
+                          VkPipelineLayout layout,
+                          ui32 set,
+                          VkPipelineBindPoint bind_point) {
+    cmd_bind_descriptor_sets(cmd_buf,
+                             bind_point,
+                             layout,
+                             set,
+                             1,
+                             &m_descriptor_set);
+}
+
+//-----------------------------------------------------------------------------
+void bindless_table::write(ui32 binding,
+                           index slot,
+                           VkDescriptorImageInfo const* image_info,
+                           VkDescriptorBufferInfo const* buffer_info) {
+    VkWriteDescriptorSet const write_set{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = m_descriptor_set,
+        .dstBinding = binding,
+        .dstArrayElement = slot,
+        .descriptorCount = 1,
+        .descriptorType = (binding == texture_binding)
+                              ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+                              : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pImageInfo = image_info,
+        .pBufferInfo = buffer_info,
+    };
+
+    m_device->vkUpdateDescriptorSets(1, &write_set);
+}
+
+} // namespace lava
@@ -0,0 +1,243 @@
+/**
+ * @file         liblava/resource/bindless_table.hpp
+ * @brief        Bindless descriptor table
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/base/device.hpp"
+#include <deque>
+#include <mutex>
+
+namespace lava {
+
+/**
+ * @brief Slot allocator (fresh slots first, freed slots recycled oldest first)
+ */
+struct slot_allocator {
+    /**
+     * @brief Reset the allocator
+     * @param capacity    Number of slots
+     */
+    void reset(ui32 capacity);
+
+    /**
+     * @brief Allocate a slot
+     * @return ui32    Slot (no_index: full)
+     */
+    ui32 alloc();
+
+    /**
+     * @brief Free a slot
+     * @param slot    Slot
+     * @return Slot was in use or not (ignored)
+     */
+    bool free(ui32 slot);
+
+    /**
+     * @brief Get the capacity
+     * @return ui32    Number of slots
+     */
+    ui32 get_capacity() const {
+        return m_capacity;
+    }
+
+    /**
+     * @brief Get the number of used slots
+     * @return ui32    Number of used slots
+     */
+    ui32 get_used() const {
+        return m_used;
+    }
+
+private:
+    /// Freed slots (oldest first)
+    std::deque<ui32> m_free;
+
+    /// Slots in use
+    std::vector<bool> m_allocated;
+
+    /// Next fresh slot
+    ui32 m_next = 0;
+
+    /// Capacity
+    ui32 m_capacity = 0;
+
+    /// Used slots
+    ui32 m_used = 0;
+};
+
+/**
+ * @brief Bindless descriptor table
+ * @note One update after bind, partially bound descriptor set per device.
+ *       Textures and storage buffers created on the device get a stable
+ *       index, shaders address them through push constants.
+ */
+struct bindless_table : entity {
+    /// Shared pointer to bindless table
+    using s_ptr = std::shared_ptr<bindless_table>;
+
+    /// Pointer to bindless table
+    using ptr = bindless_table*;
+
+    /// Binding of combined image sampler array
+    static constexpr ui32 texture_binding = 0;
+
+    /// Binding of storage buffer array
+    static constexpr ui32 buffer_binding = 1;
+
+    /**
+     * @brief Make a new bindless table
+     * @return s_ptr    Shared pointer to bindless table
+     */
+    static s_ptr make() {
+        return std::make_shared<bindless_table>();
+    }
+
+    /**
+     * @brief Destroy the bindless table
+     */
+    ~bindless_table() {
+        destroy();
+    }
+
+    /**
+     * @brief Find the bindless table of a device
+     * @param device    Vulkan device
+     * @return ptr      Bindless table (nullptr: none)
+     */
+    static ptr find(device::ptr device);
+
+    /**
+     * @brief Create a new bindless table
+     * @note Needs device::has_descriptor_indexing, create before the resources
+     * @param device          Vulkan device
+     * @param max_textures    Size of texture array
+     * @param max_buffers     Size of buffer array
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                ui32 max_textures = 4096,
+                ui32 max_buffers = 4096);
+
+    /**
+     * @brief Destroy the bindless table
+     */
+    void destroy();
+
+    /**
+     * @brief Add a texture
+     * @param info     Descriptor image information
+     * @return index   Texture index (no_index: table is full)
+     */
+    index add_texture(VkDescriptorImageInfo const& info);
+
+    /**
+     * @brief Remove a texture
+     * @param slot    Texture index
+     */
+    void remove_texture(index slot);
+
+    /**
+     * @brief Add a storage buffer
+     * @param info     Descriptor buffer information
+     * @return index   Buffer index (no_index: table is full)
+     */
+    index add_buffer(VkDescriptorBufferInfo const& info);
+
+    /**
+     * @brief Remove a storage buffer
+     * @param slot    Buffer index
+     */
+    void remove_buffer(index slot);
+
+    /**
+     * @brief Bind the table
+     * @param cmd_buf       Command buffer
+     * @param layout        Pipeline layout (with get_layout at set)
+     * @param set           Set number
+     * @param bind_point    Pipeline bind point
+     */
+    void bind(VkCommandBuffer cmd_buf,
+              VkPipelineLayout layout,
+              ui32 set = 0,
+              VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+    /**
+     * @brief Get the descriptor set layout
+     * @return VkDescriptorSetLayout    Descriptor set layout
+     */
+    VkDescriptorSetLayout get_layout() const {
+        return m_layout;
+    }
+
+    /**
+     * @brief Get the descriptor set
+     * @return VkDescriptorSet    Descriptor set
+     */
+    VkDescriptorSet get_descriptor_set() const {
+        return m_descriptor_set;
+    }
+
+    /**
+     * @brief Get the number of textures
+     * @return ui32    Number of textures
+     */
+    ui32 get_texture_count() const {
+        return m_textures.get_used();
+    }
+
+    /**
+     * @brief Get the number of storage buffers
+     * @return ui32    Number of buffers
+     */
+    ui32 get_buffer_count() const {
+        return m_buffers.get_used();
+    }
+
+    /**
+     * @brief Get the device
+     * @return device::ptr    Vulkan device
+     */
+    device::ptr get_device() {
+        return m_device;
+    }
+
+private:
+    /**
+     * @brief Write a descriptor of the set
+     * @param binding        Binding
+     * @param slot           Array element
+     * @param image_info     Descriptor image information (texture binding)
+     * @param buffer_info    Descriptor buffer information (buffer binding)
+     */
+    void write(ui32 binding,
+               index slot,
+               VkDescriptorImageInfo const* image_info,
+               VkDescriptorBufferInfo const* buffer_info);
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Descriptor set layout
+    VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+
+    /// Descriptor pool
+    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+
+    /// Descriptor set
+    VkDescriptorSet m_descriptor_set = VK_NULL_HANDLE;
+
+    /// Texture slots
+    slot_allocator m_textures;
+
+    /// Buffer slots
+    slot_allocator m_buffers;
+
+    /// Slot and write mutex
+    std::mutex m_mutex;
+};
+
+} // namespace lava
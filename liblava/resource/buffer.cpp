@@ -6,6 +6,7 @@
  */
 
 #include "liblava/resource/buffer.hpp"
+#include "liblava/resource/bindless_table.hpp"
 #include "liblava/util/log.hpp"
 
 namespace lava {
@@ -22,10 +23,15 @@ bool buffer::create(device::ptr dev,
                     i32 alignment) {
     m_device = dev;
 
+    // initial data may need a transfer if memory is not host visible
+    m_usage = usage;
+    if (data && !mapped)
+        m_usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
     VkBufferCreateInfo buffer_info{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = size,
-        .usage = usage,
+        .usage = m_usage,
         .sharingMode = sharing_mode,
         .queueFamilyIndexCount = to_ui32(shared_queue_family_indices.size()),
         .pQueueFamilyIndices = shared_queue_family_indices.data()};
@@ -62,13 +68,36 @@ bool buffer::create(device::ptr dev,
         }
     }
 
+    m_descriptor.buffer = m_vk_buffer;
+    m_descriptor.offset = 0;
+    m_descriptor.range = size;
+
+    if (m_usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+        if (auto table = bindless_table::find(m_device))
+            m_bindless_index = table->add_buffer(m_descriptor);
+
     if (!mapped) {
         if (data) {
+            VkMemoryPropertyFlags memory_flags = 0;
+            vmaGetAllocationMemoryProperties(m_device->alloc(),
+                                             m_allocation,
+                                             &memory_flags);
+
+            if (!(memory_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+                if (!upload(data, size)) {
+                    destroy();
+                    return false;
+                }
+
+                return true;
+            }
+
             data::ptr map = nullptr;
             if (failed(vmaMapMemory(m_device->alloc(),
                                     m_allocation,
                                     (void**)(&map)))) {
                 logger()->error("map buffer memory");
+                destroy();
                 return false;
             }
 
@@ -76,6 +105,8 @@ bool buffer::create(device::ptr dev,
 
             vmaUnmapMemory(m_device->alloc(),
                            m_allocation);
+
+            flush();
         }
     } else if (data && m_allocation_info.pMappedData) {
         memcpy(m_allocation_info.pMappedData,
@@ -85,10 +116,6 @@ bool buffer::create(device::ptr dev,
         flush();
     }
 
-    m_descriptor.buffer = m_vk_buffer;
-    m_descriptor.offset = 0;
-    m_descriptor.range = size;
-
     return true;
 }
 
@@ -117,16 +144,68 @@ void buffer::destroy() {
     if (!m_vk_buffer)
         return;
 
+    if (m_bindless_index != no_index) {
+        if (auto table = bindless_table::find(m_device))
+            table->remove_buffer(m_bindless_index);
+
+        m_bindless_index = no_index;
+    }
+
     vmaDestroyBuffer(m_device->alloc(),
                      m_vk_buffer,
                      m_allocation);
 
     m_vk_buffer = VK_NULL_HANDLE;
     m_allocation = nullptr;
+    m_usage = 0;
 
     m_device = nullptr;
 }
 
+//-----------------------------------------------------------------------------
+bool buffer::upload(void const* data,
+                    size_t size,
+                    VkDeviceSize offset) {
+    if (!valid() || !data || size == 0)
+        return false;
+
+    if (!(m_usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT)) {
+        logger()->error("upload buffer without transfer dst usage");
+        return false;
+    }
+
+    buffer staging_buffer;
+    if (!staging_buffer.create(m_device,
+                               data,
+                               size,
+                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                               false,
+                               VMA_MEMORY_USAGE_CPU_ONLY)) {
+        logger()->error("create buffer upload staging");
+        return false;
+    }
+
+    auto const result = one_time_submit(m_device,
+                                        m_device->get_graphics_queue(),
+                                        [&](VkCommandBuffer cmd_buf) {
+                                            VkBufferCopy const region{
+                                                .srcOffset = 0,
+                                                .dstOffset = offset,
+                                                .size = size,
+                                            };
+
+                                            m_device->call().vkCmdCopyBuffer(cmd_buf,
+                                                                             staging_buffer.get(),
+                                                                             m_vk_buffer,
+                                                                             1,
+                                                                             &region);
+                                        });
+    if (!result)
+        logger()->error("upload buffer");
+
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 VkDeviceAddress buffer::get_address() const {
     if (m_device->call().vkGetBufferDeviceAddressKHR) {
@@ -148,6 +227,14 @@ void buffer::flush(VkDeviceSize offset, VkDeviceSize size) {
                        size);
 }
 
+//-----------------------------------------------------------------------------
+void buffer::invalidate(VkDeviceSize offset, VkDeviceSize size) {
+    vmaInvalidateAllocation(m_device->alloc(),
+                            m_allocation,
+                            offset,
+                            size);
+}
+
 //-----------------------------------------------------------------------------
 VkPipelineStageFlags buffer_usage_to_possible_stages(VkBufferUsageFlags usage) {
     VkPipelineStageFlags flags = 0;
@@ -39,7 +39,7 @@ struct buffer : entity {
     /**
      * @brief Create a new buffer
      * @param device                         Vulkan device
-     * @param data                           Buffer data
+     * @param data                           Buffer data (uploaded if memory is not host visible)
      * @param size                           Data size
      * @param usage                          Buffer usage flags
      * @param mapped                         Map the buffer
@@ -85,6 +85,18 @@ struct buffer : entity {
      */
     void destroy();
 
+    /**
+     * @brief Upload data through a temporary staging buffer (blocking)
+     * @note Buffer needs VK_BUFFER_USAGE_TRANSFER_DST_BIT, prefer staging for batched uploads
+     * @param data      Data to upload
+     * @param size      Size of data
+     * @param offset    Offset in buffer
+     * @return Upload was successful or failed
+     */
+    bool upload(void const* data,
+                size_t size,
+                VkDeviceSize offset = 0);
+
     /**
      * @brief Get the device
      * @return device::ptr    Vulkan device
@@ -117,6 +129,14 @@ struct buffer : entity {
         return &m_descriptor;
     }
 
+    /**
+     * @brief Get the index in the bindless table of the device
+     * @return index    Buffer index (no_index: not a storage buffer or no table)
+     */
+    index get_bindless_index() const {
+        return m_bindless_index;
+    }
+
     /**
      * @brief Get the address of the buffer
      * @return VkDeviceAddress    Device address
@@ -131,6 +151,14 @@ struct buffer : entity {
         return m_allocation_info.size;
     }
 
+    /**
+     * @brief Get the buffer usage flags
+     * @return VkBufferUsageFlags    Buffer usage flags
+     */
+    VkBufferUsageFlags get_usage() const {
+        return m_usage;
+    }
+
     /**
      * @brief Get the mapped data
      * @return void*    Pointer to data
@@ -155,6 +183,14 @@ struct buffer : entity {
     void flush(VkDeviceSize offset = 0,
                VkDeviceSize size = VK_WHOLE_SIZE);
 
+    /**
+     * @brief Invalidate the buffer data (before host reads)
+     * @param offset    Offset device size
+     * @param size      Data device size
+     */
+    void invalidate(VkDeviceSize offset = 0,
+                    VkDeviceSize size = VK_WHOLE_SIZE);
+
     /**
      * @brief Get the allocation
      * @return VmaAllocation const&    Allocation
@@ -186,6 +222,12 @@ private:
 
     /// Descriptor buffer information
     VkDescriptorBufferInfo m_descriptor = {};
+
+    /// Buffer usage flags
+    VkBufferUsageFlags m_usage = 0;
+
+    /// Index in bindless table
+    index m_bindless_index = no_index;
 };
 
 /**
@@ -691,6 +691,69 @@ void insert_image_memory_barrier(device::ptr device,
                                         &barrier);
 }
 
+//-----------------------------------------------------------------------------
+void insert_image_memory_barriers(device::ptr device,
+                                  VkCommandBuffer cmd_buffer,
+                                  std::vector<VkImageMemoryBarrier2> const& barriers) {
+    if (barriers.empty())
+        return;
+
+    if (device->has_synchronization2()) {
+        auto pipeline_barrier2 = device->call().vkCmdPipelineBarrier2
+                                     ? device->call().vkCmdPipelineBarrier2
+                                     : device->call().vkCmdPipelineBarrier2KHR;
+
+        if (pipeline_barrier2) {
+            VkDependencyInfo const dependency_info{
+                .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .imageMemoryBarrierCount = to_ui32(barriers.size()),
+                .pImageMemoryBarriers = barriers.data(),
+            };
+
+            pipeline_barrier2(cmd_buffer, &dependency_info);
+            return;
+        }
+    }
+
+    VkPipelineStageFlags src_stage_mask = 0;
+    VkPipelineStageFlags dst_stage_mask = 0;
+
+    std::vector<VkImageMemoryBarrier> image_barriers;
+    image_barriers.reserve(barriers.size());
+
+    for (auto const& barrier : barriers) {
+        src_stage_mask |= VkPipelineStageFlags(barrier.srcStageMask);
+        dst_stage_mask |= VkPipelineStageFlags(barrier.dstStageMask);
+
+        image_barriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VkAccessFlags(barrier.srcAccessMask),
+            .dstAccessMask = VkAccessFlags(barrier.dstAccessMask),
+            .oldLayout = barrier.oldLayout,
+            .newLayout = barrier.newLayout,
+            .srcQueueFamilyIndex = barrier.srcQueueFamilyIndex,
+            .dstQueueFamilyIndex = barrier.dstQueueFamilyIndex,
+            .image = barrier.image,
+            .subresourceRange = barrier.subresourceRange,
+        });
+    }
+
+    device->call().vkCmdPipelineBarrier(cmd_buffer,
+                                        src_stage_mask
+                                            ? src_stage_mask
+                                            : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                        dst_stage_mask
+                                            ? dst_stage_mask
+                                            : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                        0,
+                                        0,
+                                        nullptr,
+                                        0,
+                                        nullptr,
+                                        to_ui32(image_barriers.size()),
+                                        image_barriers.data());
+}
+
 //-----------------------------------------------------------------------------
 VkSurfaceFormatKHR find_surface_format(VkPhysicalDevice device,
                                        VkSurfaceKHR surface,
@@ -742,6 +805,26 @@ bool support_blit(VkPhysicalDevice pyhsical_device,
     return (format_props.linearTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
 }
 
+//-----------------------------------------------------------------------------
+bool support_mip_blit(VkPhysicalDevice pyhsical_device,
+                      VkFormat format,
+                      VkFilter& filter) {
+    VkFormatProperties format_props;
+    vkGetPhysicalDeviceFormatProperties(pyhsical_device,
+                                        format,
+                                        &format_props);
+
+    auto const features = format_props.optimalTilingFeatures;
+    if (!(features & VK_FORMAT_FEATURE_BLIT_SRC_BIT)
+        || !(features & VK_FORMAT_FEATURE_BLIT_DST_BIT))
+        return false;
+
+    filter = (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+                 ? VK_FILTER_LINEAR
+                 : VK_FILTER_NEAREST;
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 bool support_vertex_buffer_format(VkPhysicalDevice pyhsical_device,
                                   VkFormat format) {
@@ -198,6 +198,17 @@ void insert_image_memory_barrier(device::ptr device,
                                  VkPipelineStageFlags dst_stage_mask,
                                  VkImageSubresourceRange subresource_range);
 
+/**
+ * @brief Insert image memory barriers with one command
+ * @note Uses synchronization2 if enabled, otherwise stages are combined (legacy stage and access bits only)
+ * @param device        Vulkan device
+ * @param cmd_buffer    Command buffer
+ * @param barriers      List of image memory barriers
+ */
+void insert_image_memory_barriers(device::ptr device,
+                                  VkCommandBuffer cmd_buffer,
+                                  std::vector<VkImageMemoryBarrier2> const& barriers);
+
 /**
  * @brief Surface format request
  */
@@ -238,6 +249,17 @@ VkSurfaceFormatKHR find_surface_format(VkPhysicalDevice device,
 bool support_blit(VkPhysicalDevice device,
                   VkFormat format);
 
+/**
+ * @brief Check if mip levels of format can be generated by blitting
+ * @param device    Vulkan physical device
+ * @param format    Format to check
+ * @param filter    Blit filter (linear if supported, otherwise nearest)
+ * @return Mip blitting is supported or not
+ */
+bool support_mip_blit(VkPhysicalDevice device,
+                      VkFormat format,
+                      VkFilter& filter);
+
 /**
  * @brief Check if vertex buffer format is supported
  * @param device    Vulkan physical device
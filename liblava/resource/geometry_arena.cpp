@@ -0,0 +1,322 @@
+/**
+ * @file         liblava/resource/geometry_arena.cpp
+ * @brief        Shared geometry buffers with indirect drawing
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/geometry_arena.hpp"
+#include "liblava/base/cmd_state.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+void range_allocator::reset(ui32 capacity) {
+    m_free.clear();
+    m_capacity = capacity;
+    m_used = 0;
+
+    if (capacity > 0)
+        m_free.emplace(0, capacity);
+}
+
+//-----------------------------------------------------------------------------
+ui32 range_allocator::alloc(ui32 count) {
+    if (count == 0)
+        return no_index;
+
+    for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+        auto const [offset, size] = *it;
+        if (size < count)
+            continue;
+
+        m_free.erase(it);
+        if (size > count)
+            m_free.emplace(offset + count, size - count);
+
+        m_used += count;
+        return offset;
+    }
+
+    return no_index;
+}
+
+//-----------------------------------------------------------------------------
+void range_allocator::free(ui32 offset,
+                           ui32 count) {
+    if (offset == no_index || count == 0)
+        return;
+
+    m_used -= count;
+
+    auto next = m_free.lower_bound(offset);
+
+    // merge with following range
+    if (next != m_free.end() && offset + count == next->first) {
+        count += next->second;
+        next = m_free.erase(next);
+    }
+
+    // merge with preceding range
+    if (next != m_free.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += count;
+            return;
+        }
+    }
+
+    m_free.emplace(offset, count);
+}
+
+//-----------------------------------------------------------------------------
+bool geometry_arena::create(device::ptr dev,
+                            ui32 vertex_capacity,
+                            ui32 index_capacity,
+                            ui32 vertex_stride) {
+    m_device = dev;
+    m_vertex_stride = vertex_stride;
+
+    m_vertex_buffer = buffer::make();
+    if (!m_vertex_buffer->create(m_device,
+                                 nullptr,
+                                 VkDeviceSize(vertex_capacity) * vertex_stride,
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+                                     | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) {
+        logger()->error("create geometry arena vertex buffer");
+        return false;
+    }
+
+    m_index_buffer = buffer::make();
+    if (!m_index_buffer->create(m_device,
+                                nullptr,
+                                VkDeviceSize(index_capacity) * sizeof(index),
+                                VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+                                    | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) {
+        logger()->error("create geometry arena index buffer");
+        return false;
+    }
+
+    m_vertices.reset(vertex_capacity);
+    m_indices.reset(index_capacity);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void geometry_arena::destroy() {
+    m_vertex_buffer = nullptr;
+    m_index_buffer = nullptr;
+
+    m_vertices.reset(0);
+    m_indices.reset(0);
+
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+geometry_range geometry_arena::add(void const* vertices,
+                                   ui32 vertex_count,
+                                   index const* indices,
+                                   ui32 index_count,
+                                   staging::ptr staging) {
+    geometry_range result;
+
+    if (!m_vertex_buffer || !vertices || vertex_count == 0)
+        return result;
+
+    auto const vertex_offset = m_vertices.alloc(vertex_count);
+    if (vertex_offset == no_index) {
+        logger()->error("geometry arena out of vertices: {}",
+                        m_vertices.get_capacity());
+        return result;
+    }
+
+    auto first_index = no_index;
+    if (index_count > 0) {
+        first_index = m_indices.alloc(index_count);
+        if (first_index == no_index) {
+            m_vertices.free(vertex_offset, vertex_count);
+
+            logger()->error("geometry arena out of indices: {}",
+                            m_indices.get_capacity());
+            return result;
+        }
+    }
+
+    auto const vertex_size = size_t(vertex_count) * m_vertex_stride;
+    auto const vertex_dst = VkDeviceSize(vertex_offset) * m_vertex_stride;
+
+    auto const index_size = size_t(index_count) * sizeof(index);
+    auto const index_dst = VkDeviceSize(first_index) * sizeof(index);
+
+    if (staging) {
+        staging->add(m_vertex_buffer, vertices, vertex_size, vertex_dst);
+
+        if (index_count > 0)
+            staging->add(m_index_buffer, indices, index_size, index_dst);
+    } else {
+        auto uploaded = m_vertex_buffer->upload(vertices, vertex_size, vertex_dst);
+
+        if (uploaded && index_count > 0)
+            uploaded = m_index_buffer->upload(indices, index_size, index_dst);
+
+        if (!uploaded) {
+            m_vertices.free(vertex_offset, vertex_count);
+            m_indices.free(first_index, index_count);
+            return result;
+        }
+    }
+
+    result.vertex_offset = vertex_offset;
+    result.vertex_count = vertex_count;
+    result.first_index = first_index;
+    result.index_count = index_count;
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+void geometry_arena::remove(geometry_range::ref range) {
+    if (!range.valid())
+        return;
+
+    m_vertices.free(range.vertex_offset, range.vertex_count);
+    m_indices.free(range.first_index, range.index_count);
+}
+
+//-----------------------------------------------------------------------------
+void geometry_arena::bind(VkCommandBuffer cmd_buf) const {
+    if (!m_vertex_buffer || !m_vertex_buffer->valid())
+        return;
+
+    std::array<VkDeviceSize, 1> const buffer_offsets = {0};
+    std::array<VkBuffer, 1> const buffers = {m_vertex_buffer->get()};
+
+    cmd_bind_vertex_buffers(cmd_buf, 0,
+                            to_ui32(buffers.size()), buffers.data(),
+                            buffer_offsets.data());
+
+    cmd_bind_index_buffer(cmd_buf,
+                          m_index_buffer->get(),
+                          0,
+                          VK_INDEX_TYPE_UINT32);
+}
+
+//-----------------------------------------------------------------------------
+void geometry_arena::draw(VkCommandBuffer cmd_buf,
+                          geometry_range::ref range,
+                          ui32 instance_count,
+                          ui32 first_instance) const {
+    if (!range.valid())
+        return;
+
+    if (range.index_count > 0)
+        vkCmdDrawIndexed(cmd_buf,
+                         range.index_count,
+                         instance_count,
+                         range.first_index,
+                         i32(range.vertex_offset),
+                         first_instance);
+    else
+        vkCmdDraw(cmd_buf,
+                  range.vertex_count,
+                  instance_count,
+                  range.vertex_offset,
+                  first_instance);
+}
+
+//-----------------------------------------------------------------------------
+bool indirect_draw_list::create(device::ptr dev,
+                                ui32 max_draws,
+                                index frame_count) {
+    m_device = dev;
+    m_max_draws = max_draws;
+
+    m_commands.reserve(max_draws);
+
+    for (auto i = 0u; i < frame_count; ++i) {
+        auto buffer = buffer::make();
+        if (!buffer->create_mapped(m_device,
+                                   nullptr,
+                                   sizeof(VkDrawIndexedIndirectCommand) * max_draws,
+                                   VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)) {
+            logger()->error("create indirect draw buffer");
+            return false;
+        }
+
+        m_buffers.push_back(buffer);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void indirect_draw_list::destroy() {
+    m_buffers.clear();
+    m_commands.clear();
+
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+bool indirect_draw_list::add(geometry_range::ref range,
+                             ui32 instance_count,
+                             ui32 first_instance) {
+    if (!range.valid() || range.index_count == 0)
+        return false;
+
+    if (m_commands.size() >= m_max_draws) {
+        logger()->error("indirect draw list full: {}", m_max_draws);
+        return false;
+    }
+
+    m_commands.push_back({
+        .indexCount = range.index_count,
+        .instanceCount = instance_count,
+        .firstIndex = range.first_index,
+        .vertexOffset = i32(range.vertex_offset),
+        .firstInstance = first_instance,
+    });
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void indirect_draw_list::draw(VkCommandBuffer cmd_buf,
+                              index frame) {
+    if (m_commands.empty() || frame >= m_buffers.size())
+        return;
+
+    auto& buffer = m_buffers.at(frame);
+
+    auto const size = sizeof(VkDrawIndexedIndirectCommand) * m_commands.size();
+    memcpy(buffer->get_mapped_data(), m_commands.data(), size);
+    buffer->flush(0, size);
+
+    auto const stride = to_ui32(sizeof(VkDrawIndexedIndirectCommand));
+    auto const count = get_count();
+
+    auto const& features = m_device->get_features();
+    auto const max_draw_count = m_device->get_properties().limits.maxDrawIndirectCount;
+
+    if (features.multiDrawIndirect && count <= max_draw_count) {
+        vkCmdDrawIndexedIndirect(cmd_buf,
+                                 buffer->get(),
+                                 0,
+                                 count,
+                                 stride);
+        return;
+    }
+
+    // without multiDrawIndirect every draw needs its own call
+    for (auto i = 0u; i < count; ++i)
+        vkCmdDrawIndexedIndirect(cmd_buf,
+                                 buffer->get(),
+                                 VkDeviceSize(i) * stride,
+                                 1,
+                                 stride);
+}
+
+} // namespace lava
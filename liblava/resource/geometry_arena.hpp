@@ -0,0 +1,345 @@
+/**
+ * @file         liblava/resource/geometry_arena.hpp
+ * @brief        Shared geometry buffers with indirect drawing
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/mesh.hpp"
+
+namespace lava {
+
+/**
+ * @brief Range allocator (first fit with coalescing)
+ */
+struct range_allocator {
+    /**
+     * @brief Reset the allocator
+     * @param capacity    Number of elements
+     */
+    void reset(ui32 capacity);
+
+    /**
+     * @brief Allocate a range
+     * @param count    Number of elements
+     * @return ui32    Offset of range (no_index: out of space)
+     */
+    ui32 alloc(ui32 count);
+
+    /**
+     * @brief Free a range
+     * @param offset    Offset of range
+     * @param count     Number of elements
+     */
+    void free(ui32 offset,
+              ui32 count);
+
+    /**
+     * @brief Get the capacity
+     * @return ui32    Number of elements
+     */
+    ui32 get_capacity() const {
+        return m_capacity;
+    }
+
+    /**
+     * @brief Get the number of used elements
+     * @return ui32    Number of used elements
+     */
+    ui32 get_used() const {
+        return m_used;
+    }
+
+private:
+    /// Free ranges (offset, count)
+    std::map<ui32, ui32> m_free;
+
+    /// Capacity
+    ui32 m_capacity = 0;
+
+    /// Used elements
+    ui32 m_used = 0;
+};
+
+/**
+ * @brief Range of a mesh in a geometry arena
+ */
+struct geometry_range {
+    /// Reference to geometry range
+    using ref = geometry_range const&;
+
+    /// List of geometry ranges
+    using list = std::vector<geometry_range>;
+
+    /// First vertex in arena
+    ui32 vertex_offset = no_index;
+
+    /// Number of vertices
+    ui32 vertex_count = 0;
+
+    /// First index in arena
+    ui32 first_index = no_index;
+
+    /// Number of indices
+    ui32 index_count = 0;
+
+    /**
+     * @brief Check if the range is valid
+     * @return Range is valid or not
+     */
+    bool valid() const {
+        return vertex_offset != no_index;
+    }
+};
+
+/**
+ * @brief Geometry arena (one vertex and one index buffer for many meshes)
+ */
+struct geometry_arena : entity {
+    /// Shared pointer to geometry arena
+    using s_ptr = std::shared_ptr<geometry_arena>;
+
+    /**
+     * @brief Make a new geometry arena
+     * @return s_ptr    Shared pointer to geometry arena
+     */
+    static s_ptr make() {
+        return std::make_shared<geometry_arena>();
+    }
+
+    /**
+     * @brief Destroy the geometry arena
+     */
+    ~geometry_arena() {
+        destroy();
+    }
+
+    /**
+     * @brief Create a new geometry arena
+     * @param device            Vulkan device
+     * @param vertex_capacity   Maximum number of vertices
+     * @param index_capacity    Maximum number of indices
+     * @param vertex_stride     Size of vertex
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                ui32 vertex_capacity,
+                ui32 index_capacity,
+                ui32 vertex_stride = sizeof(vertex));
+
+    /**
+     * @brief Destroy the geometry arena
+     */
+    void destroy();
+
+    /**
+     * @brief Add geometry to the arena
+     * @param vertices             Vertex data (vertex_stride each)
+     * @param vertex_count         Number of vertices
+     * @param indices              Indices (relative to first vertex)
+     * @param index_count          Number of indices
+     * @param staging              Staging for upload (nullptr: upload now)
+     * @return geometry_range      Allocated range (invalid: out of space)
+     */
+    geometry_range add(void const* vertices,
+                       ui32 vertex_count,
+                       index const* indices,
+                       ui32 index_count,
+                       staging::ptr staging = nullptr);
+
+    /**
+     * @brief Add mesh data to the arena
+     * @tparam T                   Vertex struct typename
+     * @param data                 Mesh data
+     * @param staging              Staging for upload (nullptr: upload now)
+     * @return geometry_range      Allocated range (invalid: out of space)
+     */
+    template <typename T>
+    geometry_range add(mesh_template_data<T> const& data,
+                       staging::ptr staging = nullptr) {
+        if (sizeof(T) != m_vertex_stride) {
+            logger()->error("geometry arena vertex stride mismatch");
+            return {};
+        }
+
+        return add(data.vertices.data(),
+                   to_ui32(data.vertices.size()),
+                   data.indices.data(),
+                   to_ui32(data.indices.size()),
+                   staging);
+    }
+
+    /**
+     * @brief Remove geometry from the arena
+     * @param range    Range to free
+     */
+    void remove(geometry_range::ref range);
+
+    /**
+     * @brief Bind the vertex and index buffer
+     * @param cmd_buf    Command buffer
+     */
+    void bind(VkCommandBuffer cmd_buf) const;
+
+    /**
+     * @brief Draw a range (arena must be bound)
+     * @param cmd_buf           Command buffer
+     * @param range             Range to draw
+     * @param instance_count    Number of instances
+     * @param first_instance    First instance
+     */
+    void draw(VkCommandBuffer cmd_buf,
+              geometry_range::ref range,
+              ui32 instance_count = 1,
+              ui32 first_instance = 0) const;
+
+    /**
+     * @brief Get the vertex buffer
+     * @return buffer::s_ptr    Vertex buffer
+     */
+    buffer::s_ptr get_vertex_buffer() const {
+        return m_vertex_buffer;
+    }
+
+    /**
+     * @brief Get the index buffer
+     * @return buffer::s_ptr    Index buffer
+     */
+    buffer::s_ptr get_index_buffer() const {
+        return m_index_buffer;
+    }
+
+    /**
+     * @brief Get the vertex stride
+     * @return ui32    Size of vertex
+     */
+    ui32 get_vertex_stride() const {
+        return m_vertex_stride;
+    }
+
+    /**
+     * @brief Get the vertex allocator
+     * @return range_allocator const&    Vertex allocator
+     */
+    range_allocator const& get_vertex_allocator() const {
+        return m_vertices;
+    }
+
+    /**
+     * @brief Get the index allocator
+     * @return range_allocator const&    Index allocator
+     */
+    range_allocator const& get_index_allocator() const {
+        return m_indices;
+    }
+
+private:
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Vertex buffer
+    buffer::s_ptr m_vertex_buffer;
+
+    /// Index buffer
+    buffer::s_ptr m_index_buffer;
+
+    /// Size of vertex
+    ui32 m_vertex_stride = 0;
+
+    /// Vertex allocator
+    range_allocator m_vertices;
+
+    /// Index allocator
+    range_allocator m_indices;
+};
+
+/**
+ * @brief Indirect draw list (draws geometry ranges with one call)
+ */
+struct indirect_draw_list : entity {
+    /// Shared pointer to indirect draw list
+    using s_ptr = std::shared_ptr<indirect_draw_list>;
+
+    /**
+     * @brief Make a new indirect draw list
+     * @return s_ptr    Shared pointer to indirect draw list
+     */
+    static s_ptr make() {
+        return std::make_shared<indirect_draw_list>();
+    }
+
+    /**
+     * @brief Destroy the indirect draw list
+     */
+    ~indirect_draw_list() {
+        destroy();
+    }
+
+    /**
+     * @brief Create a new indirect draw list
+     * @param device         Vulkan device
+     * @param max_draws      Maximum number of draws
+     * @param frame_count    Number of frames in flight
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                ui32 max_draws,
+                index frame_count);
+
+    /**
+     * @brief Destroy the indirect draw list
+     */
+    void destroy();
+
+    /**
+     * @brief Clear all draws
+     */
+    void clear() {
+        m_commands.clear();
+    }
+
+    /**
+     * @brief Add a draw
+     * @note A first instance other than 0 needs drawIndirectFirstInstance
+     * @param range             Geometry range
+     * @param instance_count    Number of instances
+     * @param first_instance    First instance
+     * @return Add was successful or failed (list is full)
+     */
+    bool add(geometry_range::ref range,
+             ui32 instance_count = 1,
+             ui32 first_instance = 0);
+
+    /**
+     * @brief Get the number of draws
+     * @return ui32    Number of draws
+     */
+    ui32 get_count() const {
+        return to_ui32(m_commands.size());
+    }
+
+    /**
+     * @brief Write the draws of a frame and draw them (arena must be bound)
+     * @param cmd_buf    Command buffer
+     * @param frame      Frame index
+     */
+    void draw(VkCommandBuffer cmd_buf,
+              index frame);
+
+private:
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Indirect buffers per frame
+    buffer::s_list m_buffers;
+
+    /// Draw commands
+    std::vector<VkDrawIndexedIndirectCommand> m_commands;
+
+    /// Maximum number of draws
+    ui32 m_max_draws = 0;
+};
+
+} // namespace lava
@@ -6,6 +6,7 @@
  */
 
 #include "liblava/resource/image.hpp"
+#include "liblava/resource/barrier_batch.hpp"
 #include "liblava/resource/format.hpp"
 #include "liblava/util/log.hpp"
 
@@ -74,6 +75,8 @@ bool image::create(device::ptr dev,
 
     m_info.extent = {size.x, size.y, 1};
 
+    m_state = {.layout = m_info.initialLayout};
+
     if (!m_vk_image) {
         VmaAllocationCreateInfo const create_info{
             .flags = allocation_flags,
@@ -140,6 +143,12 @@ image::s_ptr grab_image(image::s_ptr source) {
     auto const width = size.x;
     auto const height = size.y;
 
+    auto const source_layout = source->get_current_layout();
+    if (source_layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        logger()->error("grab image: source layout undefined");
+        return nullptr;
+    }
+
     auto image = image::make(VK_FORMAT_R8G8B8A8_UNORM);
     if (!image)
         return nullptr;
@@ -153,26 +162,17 @@ image::s_ptr grab_image(image::s_ptr source) {
         return nullptr;
 
     return one_time_submit(device, device->graphics_queue(), [&](VkCommandBuffer cmd_buf) {
-        insert_image_memory_barrier(device,
-                                    cmd_buf,
-                                    image->get(),
-                                    0,
-                                    VK_ACCESS_TRANSFER_WRITE_BIT,
-                                    VK_IMAGE_LAYOUT_UNDEFINED,
-                                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                    VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
-        insert_image_memory_barrier(device,
-                                    cmd_buf,
-                                    source->get(),
-                                    VK_ACCESS_MEMORY_READ_BIT,
-                                    VK_ACCESS_TRANSFER_READ_BIT,
-                                    VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                    VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
+        barrier_batch batch(device);
+        batch.transition(image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                         VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                         true);
+        batch.transition(source,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                         VK_ACCESS_2_TRANSFER_READ_BIT);
+        batch.flush(cmd_buf);
 
         if (support_blit(device->get_vk_physical_device(),
                          source->get_format())) {
@@ -226,28 +226,15 @@ image::s_ptr grab_image(image::s_ptr source) {
                 &image_copy_region);
         }
 
-        insert_image_memory_barrier(
-            device,
-            cmd_buf,
-            image->get(),
-            VK_ACCESS_TRANSFER_WRITE_BIT,
-            VK_ACCESS_MEMORY_READ_BIT,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_GENERAL,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
-        insert_image_memory_barrier(
-            device,
-            cmd_buf,
-            source->get(),
-            VK_ACCESS_TRANSFER_READ_BIT,
-            VK_ACCESS_MEMORY_READ_BIT,
-            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
+        batch.transition(image,
+                         VK_IMAGE_LAYOUT_GENERAL,
+                         VK_PIPELINE_STAGE_2_HOST_BIT,
+                         VK_ACCESS_2_HOST_READ_BIT);
+        batch.transition(source,
+                         source_layout,
+                         VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                         VK_ACCESS_2_MEMORY_READ_BIT);
+        batch.flush(cmd_buf);
     })
                ? image
                : nullptr;
@@ -24,6 +24,9 @@ struct image_data {
     /// Number of channels
     ui32 channels = 0;
 
+    /// Size of channel in bytes (1: 8-bit, 2: 16-bit, 4: 32-bit float)
+    ui32 channel_size = 1;
+
     /**
      * @brief Check if image data is ready
      * @return Image data is ready or not
@@ -53,7 +56,7 @@ struct image_data {
      * @return size_t    Image data size
      */
     size_t size() const {
-        return channels * dimensions.x * dimensions.y;
+        return size_t(channels) * channel_size * dimensions.x * dimensions.y;
     }
 
     /**
@@ -79,6 +82,26 @@ struct image : entity {
     /// List of images
     using s_list = std::vector<s_ptr>;
 
+    /**
+     * @brief Tracked image state of the last write and following reads
+     */
+    struct state {
+        /// Current image layout
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        /// Pipeline stages of last write (or layout transition)
+        VkPipelineStageFlags2 write_stage = VK_PIPELINE_STAGE_2_NONE;
+
+        /// Accesses of last write
+        VkAccessFlags2 write_access = VK_ACCESS_2_NONE;
+
+        /// Pipeline stages the last write is visible to
+        VkPipelineStageFlags2 visible_stage = VK_PIPELINE_STAGE_2_NONE;
+
+        /// Pipeline stages of reads since last write
+        VkPipelineStageFlags2 read_stage = VK_PIPELINE_STAGE_2_NONE;
+    };
+
     /**
      * @brief Make a new image
      * @param format      Image format
@@ -278,6 +301,31 @@ struct image : entity {
         return m_allocation;
     }
 
+    /**
+     * @brief Get the tracked state of the image
+     * @return state const&    Layout, last write and reads
+     */
+    state const& get_state() const {
+        return m_state;
+    }
+
+    /**
+     * @brief Get the current layout of the image
+     * @return VkImageLayout    Tracked image layout
+     */
+    VkImageLayout get_current_layout() const {
+        return m_state.layout;
+    }
+
+    /**
+     * @brief Set the tracked state of the image
+     * @note Required when the layout is changed outside of tracking (e.g. by a render pass)
+     * @param current    Layout, last write and reads
+     */
+    void set_state(state const& current) {
+        m_state = current;
+    }
+
 private:
     /// Vulkan device
     device::ptr m_device = nullptr;
@@ -299,6 +347,9 @@ private:
 
     /// Image subresource range
     VkImageSubresourceRange m_subresource_range;
+
+    /// Tracked image state
+    state m_state;
 };
 
 /**
@@ -316,6 +367,7 @@ image::s_ptr create_image(device::ptr device,
 
 /**
  * @brief Grab an image (with blit/copy)
+ * @note Source layout is taken from its tracked state and restored
  * @param source           Source image
  * @return image::s_ptr    Grabbed image
  */
@@ -0,0 +1,78 @@
+/**
+ * @file         liblava/resource/instance_buffer.cpp
+ * @brief        Per-instance vertex data
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/instance_buffer.hpp"
+#include "liblava/base/cmd_state.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+bool instance_buffer::create(device::ptr device,
+                             ui32 stride,
+                             ui32 capacity,
+                             index frame_count,
+                             ui32 binding) {
+    m_stride = stride;
+    m_capacity = capacity;
+    m_frame_count = std::max(frame_count, 1u);
+    m_binding = binding;
+
+    m_region_size = align_up(VkDeviceSize(stride) * capacity,
+                             VkDeviceSize(256));
+
+    m_buffer = buffer::make();
+    if (!m_buffer->create_mapped(device,
+                                 nullptr,
+                                 m_region_size * m_frame_count,
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)) {
+        logger()->error("create instance buffer");
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void instance_buffer::destroy() {
+    m_buffer = nullptr;
+    m_attributes.clear();
+}
+
+//-----------------------------------------------------------------------------
+void* instance_buffer::get_data(index frame) const {
+    if (!m_buffer)
+        return nullptr;
+
+    return data::as_ptr(m_buffer->get_mapped_data()) + get_offset(frame);
+}
+
+//-----------------------------------------------------------------------------
+void instance_buffer::flush(index frame,
+                            ui32 count) {
+    if (!m_buffer || count == 0)
+        return;
+
+    m_buffer->flush(get_offset(frame),
+                    VkDeviceSize(std::min(count, m_capacity)) * m_stride);
+}
+
+//-----------------------------------------------------------------------------
+void instance_buffer::bind(VkCommandBuffer cmd_buf,
+                           index frame) const {
+    if (!m_buffer || !m_buffer->valid())
+        return;
+
+    std::array<VkDeviceSize, 1> const buffer_offsets = {get_offset(frame)};
+    std::array<VkBuffer, 1> const buffers = {m_buffer->get()};
+
+    cmd_bind_vertex_buffers(cmd_buf, m_binding,
+                            to_ui32(buffers.size()), buffers.data(),
+                            buffer_offsets.data());
+}
+
+} // namespace lava
@@ -0,0 +1,187 @@
+/**
+ * @file         liblava/resource/instance_buffer.hpp
+ * @brief        Per-instance vertex data
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/buffer.hpp"
+
+namespace lava {
+
+/**
+ * @brief Instance buffer (persistently mapped, one region per frame)
+ */
+struct instance_buffer : entity {
+    /// Shared pointer to instance buffer
+    using s_ptr = std::shared_ptr<instance_buffer>;
+
+    /**
+     * @brief Make a new instance buffer
+     * @return s_ptr    Shared pointer to instance buffer
+     */
+    static s_ptr make() {
+        return std::make_shared<instance_buffer>();
+    }
+
+    /**
+     * @brief Destroy the instance buffer
+     */
+    ~instance_buffer() {
+        destroy();
+    }
+
+    /**
+     * @brief Create a new instance buffer
+     * @param device         Vulkan device
+     * @param stride         Size of instance data
+     * @param capacity       Maximum number of instances
+     * @param frame_count    Number of regions (frames in flight, 1: static data)
+     * @param binding        Vertex input binding
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                ui32 stride,
+                ui32 capacity,
+                index frame_count = 1,
+                ui32 binding = 1);
+
+    /**
+     * @brief Destroy the instance buffer
+     */
+    void destroy();
+
+    /**
+     * @brief Add an attribute to the instance layout
+     * @param location    Shader location
+     * @param format      Attribute format
+     * @param offset      Offset in instance data
+     */
+    void add_attribute(ui32 location,
+                       VkFormat format,
+                       ui32 offset) {
+        m_attributes.push_back({location, m_binding, format, offset});
+    }
+
+    /**
+     * @brief Add a 4x4 matrix attribute (uses 4 locations)
+     * @param location    First shader location
+     * @param offset      Offset in instance data
+     */
+    void add_mat4_attribute(ui32 location,
+                            ui32 offset) {
+        for (auto i = 0u; i < 4; ++i)
+            add_attribute(location + i,
+                          VK_FORMAT_R32G32B32A32_SFLOAT,
+                          offset + i * to_ui32(4 * sizeof(r32)));
+    }
+
+    /**
+     * @brief Get the vertex input binding description
+     * @return VkVertexInputBindingDescription    Binding description
+     */
+    VkVertexInputBindingDescription get_binding_description() const {
+        return {m_binding, m_stride, VK_VERTEX_INPUT_RATE_INSTANCE};
+    }
+
+    /**
+     * @brief Get the vertex input attributes
+     * @return VkVertexInputAttributeDescriptions const&    List of attributes
+     */
+    VkVertexInputAttributeDescriptions const& get_attributes() const {
+        return m_attributes;
+    }
+
+    /**
+     * @brief Get the instance data of a frame
+     * @param frame     Frame index
+     * @return void*    Pointer to frame region
+     */
+    void* get_data(index frame = 0) const;
+
+    /**
+     * @brief Get the typed instance data of a frame
+     * @tparam T        Instance data struct
+     * @param frame     Frame index
+     * @return T*       Pointer to frame region
+     */
+    template <typename T>
+    T* get(index frame = 0) const {
+        return static_cast<T*>(get_data(frame));
+    }
+
+    /**
+     * @brief Flush written instances of a frame
+     * @param frame    Frame index
+     * @param count    Number of instances
+     */
+    void flush(index frame,
+               ui32 count);
+
+    /**
+     * @brief Bind the region of a frame
+     * @param cmd_buf    Command buffer
+     * @param frame      Frame index
+     */
+    void bind(VkCommandBuffer cmd_buf,
+              index frame = 0) const;
+
+    /**
+     * @brief Get the buffer
+     * @return buffer::s_ptr    Shared pointer to buffer
+     */
+    buffer::s_ptr get_buffer() const {
+        return m_buffer;
+    }
+
+    /**
+     * @brief Get the size of instance data
+     * @return ui32    Stride
+     */
+    ui32 get_stride() const {
+        return m_stride;
+    }
+
+    /**
+     * @brief Get the maximum number of instances
+     * @return ui32    Capacity
+     */
+    ui32 get_capacity() const {
+        return m_capacity;
+    }
+
+private:
+    /**
+     * @brief Get the offset of a frame region
+     * @param frame              Frame index
+     * @return VkDeviceSize      Region offset
+     */
+    VkDeviceSize get_offset(index frame) const {
+        return VkDeviceSize(frame % m_frame_count) * m_region_size;
+    }
+
+    /// Instance buffer
+    buffer::s_ptr m_buffer;
+
+    /// List of instance attributes
+    VkVertexInputAttributeDescriptions m_attributes;
+
+    /// Size of instance data
+    ui32 m_stride = 0;
+
+    /// Maximum number of instances
+    ui32 m_capacity = 0;
+
+    /// Number of frame regions
+    index m_frame_count = 1;
+
+    /// Size of frame region
+    VkDeviceSize m_region_size = 0;
+
+    /// Vertex input binding
+    ui32 m_binding = 1;
+};
+
+} // namespace lava
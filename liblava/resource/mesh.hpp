@@ -7,9 +7,11 @@
 
 #pragma once
 
+#include "liblava/base/cmd_state.hpp"
 #include "liblava/core/misc.hpp"
 #include "liblava/resource/buffer.hpp"
 #include "liblava/resource/primitive.hpp"
+#include "liblava/resource/staging.hpp"
 #include "liblava/util/hex.hpp"
 #include "liblava/util/log.hpp"
 
@@ -103,14 +105,25 @@ struct mesh_template : entity {
 
     /**
      * @brief Create a new mesh
+     * @note Static meshes default to device local memory, uploaded immediately (blocking)
+     *       unless created with staging, mapped meshes default to host visible memory
      * @param device          Vulkan device
      * @param mapped          Map mesh data
-     * @param memory_usage    Memory usage
+     * @param memory_usage    Memory usage (UNKNOWN: GPU_ONLY, mapped: CPU_TO_GPU)
      * @return Create was successful or failed
      */
     bool create(device::ptr device,
                 bool mapped = false,
-                VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
+                VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_UNKNOWN);
+
+    /**
+     * @brief Create a new static mesh in device local memory
+     * @param device     Vulkan device
+     * @param staging    Staging to upload mesh data with
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                staging::ptr staging);
 
     /**
      * @brief Destroy the mesh
@@ -127,7 +140,19 @@ struct mesh_template : entity {
      * @brief Draw the mesh
      * @param cmd_buf    Command buffer
      */
-    void draw(VkCommandBuffer cmd_buf) const;
+    void draw(VkCommandBuffer cmd_buf) const {
+        draw_instanced(cmd_buf, 1);
+    }
+
+    /**
+     * @brief Draw instances of the mesh
+     * @param cmd_buf           Command buffer
+     * @param instance_count    Number of instances
+     * @param first_instance    First instance
+     */
+    void draw_instanced(VkCommandBuffer cmd_buf,
+                        ui32 instance_count,
+                        ui32 first_instance = 0) const;
 
     /**
      * @brief Bind and draw the mesh
@@ -258,6 +283,9 @@ private:
 
     /// Memory usage
     VmaMemoryUsage m_memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+
+    /// Staging for uploads
+    staging::ptr m_staging = nullptr;
 };
 
 //-----------------------------------------------------------------------------
@@ -267,29 +295,31 @@ void mesh_template<T>::bind(VkCommandBuffer cmd_buf) const {
         std::array<VkDeviceSize, 1> const buffer_offsets = {0};
         std::array<VkBuffer, 1> const buffers = {m_vertex_buffer->get()};
 
-        vkCmdBindVertexBuffers(cmd_buf, 0,
-                               to_ui32(buffers.size()), buffers.data(),
-                               buffer_offsets.data());
+        cmd_bind_vertex_buffers(cmd_buf, 0,
+                                to_ui32(buffers.size()), buffers.data(),
+                                buffer_offsets.data());
     }
 
     if (m_index_buffer && m_index_buffer->valid())
-        vkCmdBindIndexBuffer(cmd_buf,
-                             m_index_buffer->get(),
-                             0,
-                             VK_INDEX_TYPE_UINT32);
+        cmd_bind_index_buffer(cmd_buf,
+                              m_index_buffer->get(),
+                              0,
+                              VK_INDEX_TYPE_UINT32);
 }
 
 //-----------------------------------------------------------------------------
 template <typename T>
-void mesh_template<T>::draw(VkCommandBuffer cmd_buf) const {
+void mesh_template<T>::draw_instanced(VkCommandBuffer cmd_buf,
+                                      ui32 instance_count,
+                                      ui32 first_instance) const {
     if (!m_data.indices.empty())
         vkCmdDrawIndexed(cmd_buf,
                          to_ui32(m_data.indices.size()),
-                         1, 0, 0, 0);
+                         instance_count, 0, 0, first_instance);
     else
         vkCmdDraw(cmd_buf,
                   to_ui32(m_data.vertices.size()),
-                  1, 0, 0);
+                  instance_count, 0, first_instance);
 }
 
 //-----------------------------------------------------------------------------
@@ -306,6 +336,9 @@ bool mesh_template<T>::reload() {
     auto dev = m_device;
     destroy();
 
+    if (m_staging)
+        return create(dev, m_staging);
+
     return create(dev, m_mapped, m_memory_usage);
 }
 
@@ -361,6 +394,11 @@ bool mesh_template<T>::create(device::ptr dev,
     m_device = dev;
     m_mapped = m;
     m_memory_usage = mu;
+    m_staging = nullptr;
+
+    if (m_memory_usage == VMA_MEMORY_USAGE_UNKNOWN)
+        m_memory_usage = m_mapped ? VMA_MEMORY_USAGE_CPU_TO_GPU
+                                  : VMA_MEMORY_USAGE_GPU_ONLY;
 
     if (!m_data.vertices.empty()) {
         m_vertex_buffer = buffer::make();
@@ -393,6 +431,56 @@ bool mesh_template<T>::create(device::ptr dev,
     return true;
 }
 
+//-----------------------------------------------------------------------------
+template <typename T>
+bool mesh_template<T>::create(device::ptr dev,
+                              staging::ptr staging) {
+    m_device = dev;
+    m_mapped = false;
+    m_memory_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    m_staging = staging;
+
+    if (!m_data.vertices.empty()) {
+        auto const size = sizeof(T) * m_data.vertices.size();
+
+        m_vertex_buffer = buffer::make();
+
+        if (!m_vertex_buffer->create(m_device,
+                                     nullptr,
+                                     size,
+                                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+                                         | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                     false,
+                                     m_memory_usage)) {
+            logger()->error("create mesh vertex buffer");
+            return false;
+        }
+
+        m_staging->add(m_vertex_buffer, m_data.vertices.data(), size);
+    }
+
+    if (!m_data.indices.empty()) {
+        auto const size = sizeof(ui32) * m_data.indices.size();
+
+        m_index_buffer = buffer::make();
+
+        if (!m_index_buffer->create(m_device,
+                                    nullptr,
+                                    size,
+                                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+                                        | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                    false,
+                                    m_memory_usage)) {
+            logger()->error("create mesh index buffer");
+            return false;
+        }
+
+        m_staging->add(m_index_buffer, m_data.indices.data(), size);
+    }
+
+    return true;
+}
+
 /**
  * @brief Make primitive positions for cube
  * @tparam PosType                                      Type of position
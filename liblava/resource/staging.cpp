@@ -0,0 +1,680 @@
+/**
+ * @file         liblava/resource/staging.cpp
+ * @brief        Texture and buffer staging
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/staging.hpp"
+#include "liblava/base/cmd_state.hpp"
+#include "liblava/resource/format.hpp"
+#include "liblava/util/log.hpp"
+#include <numeric>
+
+namespace lava {
+
+/// Alignment of buffer uploads in ring
+constexpr VkDeviceSize buffer_upload_alignment = 16;
+
+/// Tracked state of an uploaded texture (readable in fragment shader)
+constexpr image::state shader_read_state{
+    .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    .write_stage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+    .visible_stage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+    .read_stage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+};
+
+//-----------------------------------------------------------------------------
+void staging::add(buffer::s_ptr target,
+                  void const* data,
+                  size_t size,
+                  VkDeviceSize offset) {
+    if (!target || !data || size == 0)
+        return;
+
+    buffer_upload upload{
+        .target = target,
+        .dst_offset = offset,
+    };
+
+    upload.data.resize(size);
+    memcpy(upload.data.data(), data, size);
+
+    m_buffer_todo.push_back(std::move(upload));
+}
+
+//-----------------------------------------------------------------------------
+void staging::clear() {
+    m_todo.clear();
+    m_buffer_todo.clear();
+    m_staged.clear();
+
+    m_ring = nullptr;
+    m_device = nullptr;
+
+    m_head = 0;
+    m_tail = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool staging::create_ring(device::ptr device) {
+    m_device = device;
+
+    m_ring = buffer::make();
+    if (!m_ring->create_mapped(m_device,
+                               nullptr,
+                               m_capacity,
+                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                               VMA_MEMORY_USAGE_CPU_TO_GPU)) {
+        logger()->error("create staging ring: {} bytes", m_capacity);
+        m_ring = nullptr;
+        return false;
+    }
+
+    m_head = 0;
+    m_tail = 0;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+VkDeviceSize staging::ring_free(VkDeviceSize alignment) const {
+    auto const free = m_capacity - (m_head - m_tail);
+
+    auto const position = m_head % m_capacity;
+    auto const aligned = align_up(position, alignment);
+
+    // space up to the end of the ring
+    VkDeviceSize tail_space = 0;
+    if (aligned < m_capacity && aligned - position < free)
+        tail_space = std::min(m_capacity - aligned, free - (aligned - position));
+
+    // space at the start of the ring (skipping the end)
+    auto const skip = m_capacity - position;
+    auto const front_space = free > skip ? free - skip : 0;
+
+    return std::max(tail_space, front_space);
+}
+
+//-----------------------------------------------------------------------------
+bool staging::ring_alloc(VkDeviceSize size,
+                         VkDeviceSize alignment,
+                         VkDeviceSize& offset) {
+    if (size == 0 || size > ring_free(alignment))
+        return false;
+
+    auto const position = m_head % m_capacity;
+    auto const aligned = align_up(position, alignment);
+
+    if (aligned + size <= m_capacity) {
+        m_head += aligned - position;
+        offset = aligned;
+    } else {
+        m_head += m_capacity - position;
+        offset = 0;
+    }
+
+    m_head += size;
+    m_spent += size;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+VkDeviceSize staging::frame_free(VkDeviceSize alignment) const {
+    auto const free = ring_free(alignment);
+    if (m_budget == 0)
+        return free;
+
+    return m_spent < m_budget ? std::min(free, m_budget - m_spent) : 0;
+}
+
+//-----------------------------------------------------------------------------
+bool staging::stage(VkCommandBuffer cmd_buf,
+                    index frame) {
+    mark_cmd_transient();
+
+    // frame is done on device, release its uploads
+    if (m_staged.count(frame)) {
+        auto& staged = m_staged.at(frame);
+
+        for (auto& texture : staged.textures)
+            texture->destroy_upload_data();
+
+        m_tail = std::max(m_tail, staged.ring_end);
+
+        m_staged.erase(frame);
+    }
+
+    m_wait_value = 0;
+
+    if (m_todo.empty() && m_buffer_todo.empty())
+        return false;
+
+    if (!m_ring) {
+        device::ptr device = nullptr;
+        if (!m_buffer_todo.empty())
+            device = m_buffer_todo.front().target->get_device();
+        else if (auto image = m_todo.front().texture->get_image())
+            device = image->get_device();
+
+        if (!device || !create_ring(device))
+            return false;
+    }
+
+    // restart at a ring boundary when everything is released
+    if (m_head == m_tail) {
+        m_head = align_up(m_head, m_capacity);
+        m_tail = m_head;
+    }
+
+    m_spent = 0;
+
+    auto& staged = m_staged[frame];
+
+    stage_buffers(cmd_buf, staged);
+
+    if (!m_scheduler || !m_scheduler->ready()) {
+        stage_textures(cmd_buf, staged);
+    } else if (!m_todo.empty()) {
+        // textures may be owned by transfer queue, retry next frame on failure
+        if (auto transfer_cmd_buf = m_scheduler->begin(frame)) {
+            auto const acquire_stages = stage_textures(transfer_cmd_buf, staged, cmd_buf);
+
+            if (m_scheduler->submit(frame)) {
+                // frame is done only when its transfer is done (ring reuse)
+                m_wait_value = m_scheduler->get_value();
+                m_wait_stage = acquire_stages ? acquire_stages
+                                              : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            }
+        }
+    }
+
+    staged.ring_end = m_head;
+
+    if (m_spent > 0)
+        m_ring->flush();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void staging::stage_buffers(VkCommandBuffer cmd_buf,
+                            frame_staged& staged) {
+    if (m_buffer_todo.empty())
+        return;
+
+    auto ring_data = static_cast<char*>(m_ring->get_mapped_data());
+
+    VkPipelineStageFlags dst_stages = 0;
+    VkAccessFlags dst_access = 0;
+
+    // uploads to the same buffer are recorded as one copy, the last write wins on overlaps
+    std::map<VkBuffer, std::vector<VkBufferCopy>> copies;
+
+    while (!m_buffer_todo.empty()) {
+        auto& upload = m_buffer_todo.front();
+        if (!upload.target->valid()) {
+            m_buffer_todo.pop_front();
+            continue;
+        }
+
+        auto const remaining = VkDeviceSize(upload.data.size()) - upload.done;
+        auto const size = std::min(remaining,
+                                   frame_free(buffer_upload_alignment));
+
+        VkDeviceSize offset = 0;
+        if (!ring_alloc(size, buffer_upload_alignment, offset))
+            break;
+
+        memcpy(ring_data + offset, upload.data.data() + upload.done, size);
+
+        add_buffer_copy(copies[upload.target->get()],
+                        {
+                            .srcOffset = offset,
+                            .dstOffset = upload.dst_offset + upload.done,
+                            .size = size,
+                        });
+
+        auto const usage = upload.target->get_usage();
+        dst_stages |= buffer_usage_to_possible_stages(usage);
+        dst_access |= buffer_usage_to_possible_access(usage);
+
+        staged.targets.push_back(upload.target);
+
+        upload.done += size;
+        if (upload.done < upload.data.size())
+            break;
+
+        m_buffer_todo.pop_front();
+    }
+
+    if (copies.empty())
+        return;
+
+    auto const use_stages = dst_stages ? dst_stages
+                                       : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    // earlier reads and copies of the targets are done before overwriting
+    VkMemoryBarrier const pre_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    };
+
+    m_device->call().vkCmdPipelineBarrier(cmd_buf,
+                                          use_stages | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                          0,
+                                          1, &pre_barrier,
+                                          0, nullptr,
+                                          0, nullptr);
+
+    for (auto const& [target, regions] : copies)
+        m_device->call().vkCmdCopyBuffer(cmd_buf,
+                                         m_ring->get(),
+                                         target,
+                                         to_ui32(regions.size()),
+                                         regions.data());
+
+    VkMemoryBarrier const barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = dst_access,
+    };
+
+    m_device->call().vkCmdPipelineBarrier(cmd_buf,
+                                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                          use_stages,
+                                          0,
+                                          1, &barrier,
+                                          0, nullptr,
+                                          0, nullptr);
+
+    logger()->trace("buffers staged: {} ({} bytes)",
+                    staged.targets.size(), m_spent);
+}
+
+//-----------------------------------------------------------------------------
+VkPipelineStageFlags staging::stage_textures(VkCommandBuffer cmd_buf,
+                                             frame_staged& staged,
+                                             VkCommandBuffer acquire_cmd_buf) {
+    if (m_todo.empty())
+        return 0;
+
+    auto ring_data = static_cast<char*>(m_ring->get_mapped_data());
+
+    std::vector<VkImageMemoryBarrier2> pre_barriers;
+    std::vector<VkImageMemoryBarrier2> post_barriers;
+    std::vector<VkImageMemoryBarrier2> acquire_barriers;
+
+    // copies to one image
+    struct image_copy {
+        VkImage image = VK_NULL_HANDLE;
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    std::vector<image_copy> image_copies;
+    std::vector<VkBufferImageCopy> copies;
+
+    texture::s_list mip_textures;
+    VkPipelineStageFlags acquire_stages = 0;
+    auto finished = 0u;
+
+    while (!m_todo.empty()) {
+        auto& upload = m_todo.front();
+        auto& texture = upload.texture;
+
+        auto image = texture->get_image();
+        if (!image || texture->get_upload_size() == 0) {
+            logger()->error("stage texture");
+            m_todo.pop_front();
+            continue;
+        }
+
+        auto const format = texture->get_format();
+
+        ui32 block_width = 1, block_height = 1;
+        format_block_dim(format, block_width, block_height);
+
+        VkDeviceSize const block_size = std::max(format_block_size(format), 1u);
+
+        // buffer offset must be a multiple of 4 and the texel block size
+        auto const alignment = std::lcm(block_size, VkDeviceSize(4));
+
+        if (!upload.started) {
+            if (frame_free(alignment) == 0)
+                break;
+
+            upload.regions = texture->get_upload_regions();
+
+            pre_barriers.push_back({
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_HOST_BIT,
+                .srcAccessMask = VK_ACCESS_2_NONE,
+                .dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = image->get(),
+                .subresourceRange = texture->get_subresource_range(),
+            });
+
+            image->set_state({
+                .layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .write_stage = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                .write_access = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            });
+
+            upload.started = true;
+        }
+
+        auto const upload_data = texture->get_upload_data();
+
+        image_copy target_copy{
+            .image = image->get(),
+            .first = copies.size(),
+        };
+
+        while (upload.next_region < upload.regions.size()) {
+            auto const& region = upload.regions[upload.next_region];
+
+            auto const width = region.imageExtent.width;
+            auto const height = region.imageExtent.height;
+
+            auto const row_size = ((width + block_width - 1) / block_width) * block_size;
+            auto const row_count = (height + block_height - 1) / block_height;
+
+            if (row_size > m_capacity) {
+                logger()->error("stage texture row: {} bytes (capacity {})",
+                                row_size, m_capacity);
+                upload.next_region = to_ui32(upload.regions.size());
+                break;
+            }
+
+            // first upload of frame may exceed the budget by a row
+            auto limit = frame_free(alignment);
+            if (limit < row_size && m_spent == 0)
+                limit = ring_free(alignment);
+
+            // as many block rows as fit in this frame
+            auto const rows = std::min(VkDeviceSize(row_count - upload.next_row),
+                                       limit / row_size);
+
+            VkDeviceSize offset = 0;
+            if (rows == 0 || !ring_alloc(rows * row_size, alignment, offset))
+                break;
+
+            memcpy(ring_data + offset,
+                   upload_data.addr + region.bufferOffset + upload.next_row * row_size,
+                   rows * row_size);
+
+            auto const first_line = upload.next_row * block_height;
+            auto const last_line = std::min(height, ui32(upload.next_row + rows) * block_height);
+
+            auto copy = region;
+            copy.bufferOffset = offset;
+            copy.imageOffset.y = i32(first_line);
+            copy.imageExtent.height = last_line - first_line;
+            copies.push_back(copy);
+
+            upload.next_row += ui32(rows);
+            if (upload.next_row == row_count) {
+                upload.next_row = 0;
+                ++upload.next_region;
+            }
+        }
+
+        target_copy.count = copies.size() - target_copy.first;
+        if (target_copy.count > 0)
+            image_copies.push_back(target_copy);
+
+        // continue next frame
+        if (upload.next_region < upload.regions.size())
+            break;
+
+        VkImageMemoryBarrier2 post_barrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            .dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image->get(),
+            .subresourceRange = texture->get_subresource_range(),
+        };
+
+        auto const mips = texture->generate_mips();
+        if (mips) {
+            // levels are blitted on the graphics queue, stay in transfer layout
+            post_barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+            post_barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT
+                                         | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            post_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+            mip_textures.push_back(texture);
+        }
+
+        if (acquire_cmd_buf) {
+            // queue family ownership transfer: release on transfer, acquire on graphics
+            post_barrier.srcQueueFamilyIndex = m_scheduler->get_family();
+            post_barrier.dstQueueFamilyIndex = m_scheduler->get_graphics_family();
+
+            auto acquire_barrier = post_barrier;
+            acquire_barrier.srcStageMask = post_barrier.dstStageMask;
+            acquire_barrier.srcAccessMask = VK_ACCESS_2_NONE;
+            acquire_barriers.push_back(acquire_barrier);
+
+            acquire_stages |= mips ? VK_PIPELINE_STAGE_TRANSFER_BIT
+                                   : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+            post_barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+            post_barrier.dstAccessMask = VK_ACCESS_2_NONE;
+        }
+
+        // mip cascade covers the layout transition on the same queue
+        if (!mips || acquire_cmd_buf)
+            post_barriers.push_back(post_barrier);
+
+        if (!mips)
+            image->set_state(shader_read_state);
+
+        staged.textures.push_back(texture);
+        m_todo.pop_front();
+
+        ++finished;
+    }
+
+    // one barrier before and after all copies
+    insert_image_memory_barriers(m_device, cmd_buf, pre_barriers);
+
+    for (auto const& target_copy : image_copies)
+        m_device->call().vkCmdCopyBufferToImage(cmd_buf,
+                                                m_ring->get(),
+                                                target_copy.image,
+                                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                to_ui32(target_copy.count),
+                                                copies.data() + target_copy.first);
+
+    insert_image_memory_barriers(m_device, cmd_buf, post_barriers);
+
+    if (acquire_cmd_buf)
+        insert_image_memory_barriers(m_device, acquire_cmd_buf, acquire_barriers);
+
+    // blits need the graphics queue
+    generate_mips(acquire_cmd_buf ? acquire_cmd_buf : cmd_buf, mip_textures);
+
+    if (finished == 0)
+        return 0;
+
+    logger()->trace("textures staged: {} ({} copies)",
+                    finished, copies.size());
+
+    return acquire_stages;
+}
+
+//-----------------------------------------------------------------------------
+void staging::generate_mips(VkCommandBuffer cmd_buf,
+                            texture::s_list const& textures) {
+    if (textures.empty())
+        return;
+
+    auto level_barrier = [](texture::s_ptr const& texture,
+                            ui32 level,
+                            ui32 level_count) {
+        auto range = texture->get_subresource_range();
+        range.baseMipLevel = level;
+        range.levelCount = level_count;
+
+        return VkImageMemoryBarrier2{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            .dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = texture->get_image()->get(),
+            .subresourceRange = range,
+        };
+    };
+
+    auto level_extent = [](uv2 size,
+                           ui32 level) {
+        return VkOffset3D{
+            std::max(i32(size.x >> level), 1),
+            std::max(i32(size.y >> level), 1),
+            1,
+        };
+    };
+
+    auto max_level_count = 0u;
+    for (auto const& texture : textures)
+        max_level_count = std::max(max_level_count, texture->get_level_count());
+
+    std::vector<VkImageMemoryBarrier2> barriers;
+
+    // cascade: each level is blitted from the previous one, textures share the barriers
+    for (auto level = 1u; level < max_level_count; ++level) {
+        barriers.clear();
+
+        for (auto const& texture : textures)
+            if (level < texture->get_level_count())
+                barriers.push_back(level_barrier(texture, level - 1, 1));
+
+        insert_image_memory_barriers(m_device, cmd_buf, barriers);
+
+        for (auto const& texture : textures) {
+            if (level >= texture->get_level_count())
+                continue;
+
+            auto const size = texture->get_size();
+            auto const layer_count = texture->get_subresource_range().layerCount;
+
+            VkImageBlit const blit{
+                .srcSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level - 1,
+                    .baseArrayLayer = 0,
+                    .layerCount = layer_count,
+                },
+                .srcOffsets = {{0, 0, 0}, level_extent(size, level - 1)},
+                .dstSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level,
+                    .baseArrayLayer = 0,
+                    .layerCount = layer_count,
+                },
+                .dstOffsets = {{0, 0, 0}, level_extent(size, level)},
+            };
+
+            auto image = texture->get_image()->get();
+            m_device->call().vkCmdBlitImage(cmd_buf,
+                                            image,
+                                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                            image,
+                                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                            1,
+                                            &blit,
+                                            texture->get_mip_filter());
+        }
+    }
+
+    // source levels and last level become readable
+    barriers.clear();
+
+    for (auto const& texture : textures) {
+        auto const level_count = texture->get_level_count();
+
+        auto barrier = level_barrier(texture, 0, level_count - 1);
+        barrier.srcAccessMask = VK_ACCESS_2_NONE;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers.push_back(barrier);
+
+        barrier = level_barrier(texture, level_count - 1, 1);
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers.push_back(barrier);
+
+        texture->get_image()->set_state(shader_read_state);
+    }
+
+    insert_image_memory_barriers(m_device, cmd_buf, barriers);
+
+    logger()->trace("texture mips generated: {} ({} levels)",
+                    textures.size(), max_level_count);
+}
+
+//-----------------------------------------------------------------------------
+void add_buffer_copy(std::vector<VkBufferCopy>& regions,
+                     VkBufferCopy const& region) {
+    if (region.size == 0)
+        return;
+
+    auto const begin = region.dstOffset;
+    auto const end = region.dstOffset + region.size;
+
+    std::vector<VkBufferCopy> result;
+    result.reserve(regions.size() + 2);
+
+    // keep the parts of earlier regions outside of the new one
+    for (auto const& item : regions) {
+        auto const item_end = item.dstOffset + item.size;
+
+        if (item_end <= begin || item.dstOffset >= end) {
+            result.push_back(item);
+            continue;
+        }
+
+        if (item.dstOffset < begin)
+            result.push_back({
+                .srcOffset = item.srcOffset,
+                .dstOffset = item.dstOffset,
+                .size = begin - item.dstOffset,
+            });
+
+        if (item_end > end)
+            result.push_back({
+                .srcOffset = item.srcOffset + (end - item.dstOffset),
+                .dstOffset = end,
+                .size = item_end - end,
+            });
+    }
+
+    result.push_back(region);
+    regions = std::move(result);
+}
+
+} // namespace lava
@@ -0,0 +1,305 @@
+/**
+ * @file         liblava/resource/staging.hpp
+ * @brief        Texture and buffer staging
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/buffer.hpp"
+#include "liblava/resource/texture.hpp"
+#include "liblava/resource/upload_scheduler.hpp"
+#include <deque>
+
+namespace lava {
+
+/// Default capacity of staging ring (bytes)
+constexpr VkDeviceSize default_staging_capacity = 32 * 1024 * 1024;
+
+/**
+ * @brief Texture and buffer staging (through a persistent ring buffer)
+ */
+struct staging {
+    /// Pointer to staging
+    using ptr = staging*;
+
+    /**
+     * @brief Destroy the staging
+     */
+    ~staging() {
+        clear();
+    }
+
+    /**
+     * @brief Add texture for staging
+     * @param texture    Texture to stage (with upload data)
+     */
+    void add(texture::s_ptr texture) {
+        m_todo.push_back({.texture = texture});
+    }
+
+    /**
+     * @brief Add buffer data for staging
+     * @note Target buffer needs VK_BUFFER_USAGE_TRANSFER_DST_BIT
+     * @param target    Target buffer
+     * @param data      Data to upload (copied)
+     * @param size      Size of data
+     * @param offset    Offset in target buffer
+     */
+    void add(buffer::s_ptr target,
+             void const* data,
+             size_t size,
+             VkDeviceSize offset = 0);
+
+    /**
+     * @brief Stage textures and buffers
+     * @note Uploads are staged in order, large uploads are split across frames
+     * @param cmd_buf    Command buffer
+     * @param frame      Frame index
+     * @return Stage was successful or failed
+     */
+    bool stage(VkCommandBuffer cmd_buf,
+               index frame);
+
+    /**
+     * @brief Clear staging and release the ring buffer
+     */
+    void clear();
+
+    /**
+     * @brief Check if staging is busy
+     * @return Staging is busy or not
+     */
+    bool busy() const {
+        return !m_todo.empty() || !m_buffer_todo.empty() || !m_staged.empty();
+    }
+
+    /**
+     * @brief Set the upload budget per frame
+     * @param bytes    Bytes per frame (0: unlimited)
+     */
+    void set_budget(VkDeviceSize bytes) {
+        m_budget = bytes;
+    }
+
+    /**
+     * @brief Get the upload budget per frame
+     * @return VkDeviceSize    Bytes per frame (0: unlimited)
+     */
+    VkDeviceSize get_budget() const {
+        return m_budget;
+    }
+
+    /**
+     * @brief Set the capacity of the ring buffer
+     * @note Takes effect when the ring buffer is created
+     * @param bytes    Size of ring buffer
+     */
+    void set_capacity(VkDeviceSize bytes) {
+        m_capacity = bytes;
+    }
+
+    /**
+     * @brief Get the capacity of the ring buffer
+     * @return VkDeviceSize    Size of ring buffer
+     */
+    VkDeviceSize get_capacity() const {
+        return m_capacity;
+    }
+
+    /**
+     * @brief Set the upload scheduler for textures
+     * @note Without a ready scheduler textures are staged on the frame command buffer
+     * @param scheduler    Upload scheduler (nullptr: none)
+     */
+    void set_scheduler(upload_scheduler::ptr scheduler) {
+        m_scheduler = scheduler;
+    }
+
+    /**
+     * @brief Get the upload scheduler
+     * @return upload_scheduler::ptr    Upload scheduler
+     */
+    upload_scheduler::ptr get_scheduler() const {
+        return m_scheduler;
+    }
+
+    /**
+     * @brief Get the timeline value the frame submit has to wait for
+     * @return ui64    Timeline value of scheduler (0: no wait)
+     */
+    ui64 get_wait_value() const {
+        return m_wait_value;
+    }
+
+    /**
+     * @brief Get the pipeline stage the frame submit has to wait at
+     * @return VkPipelineStageFlags    Pipeline wait stage
+     */
+    VkPipelineStageFlags get_wait_stage() const {
+        return m_wait_stage;
+    }
+
+private:
+    /**
+     * @brief Create the ring buffer
+     * @param device    Vulkan device
+     * @return Create was successful or failed
+     */
+    bool create_ring(device::ptr device);
+
+    /**
+     * @brief Get the largest allocation that fits in the ring
+     * @param alignment        Alignment of allocation
+     * @return VkDeviceSize    Size of allocation
+     */
+    VkDeviceSize ring_free(VkDeviceSize alignment) const;
+
+    /**
+     * @brief Allocate space in the ring
+     * @param size         Size of allocation
+     * @param alignment    Alignment of allocation
+     * @param offset       Offset in ring buffer
+     * @return Allocation was successful or failed
+     */
+    bool ring_alloc(VkDeviceSize size,
+                    VkDeviceSize alignment,
+                    VkDeviceSize& offset);
+
+    /**
+     * @brief Get the bytes left for this frame
+     * @param alignment        Alignment of allocation
+     * @return VkDeviceSize    Bytes left (ring and budget)
+     */
+    VkDeviceSize frame_free(VkDeviceSize alignment) const;
+
+    /**
+     * @brief Staged uploads of a frame
+     */
+    struct frame_staged {
+        /// Finished textures (upload data released when frame is done)
+        texture::s_list textures;
+
+        /// Target buffers (kept alive until frame is done)
+        buffer::s_list targets;
+
+        /// Ring position at end of frame
+        VkDeviceSize ring_end = 0;
+    };
+
+    /**
+     * @brief Stage pending buffer uploads
+     * @param cmd_buf    Command buffer
+     * @param staged     Staged uploads of frame
+     */
+    void stage_buffers(VkCommandBuffer cmd_buf,
+                       frame_staged& staged);
+
+    /**
+     * @brief Stage pending textures
+     * @param cmd_buf            Command buffer for copies
+     * @param staged             Staged uploads of frame
+     * @param acquire_cmd_buf    Command buffer to acquire textures from transfer queue (VK_NULL_HANDLE: same queue)
+     * @return VkPipelineStageFlags    Stages of acquired textures (0: none)
+     */
+    VkPipelineStageFlags stage_textures(VkCommandBuffer cmd_buf,
+                                        frame_staged& staged,
+                                        VkCommandBuffer acquire_cmd_buf = VK_NULL_HANDLE);
+
+    /**
+     * @brief Generate mip levels of uploaded textures
+     * @note Textures are in transfer layout and end up shader readable
+     * @param cmd_buf     Command buffer (graphics queue)
+     * @param textures    List of textures
+     */
+    void generate_mips(VkCommandBuffer cmd_buf,
+                       texture::s_list const& textures);
+
+    /**
+     * @brief Pending texture upload
+     */
+    struct texture_upload {
+        /// Target texture
+        texture::s_ptr texture;
+
+        /// Copy regions
+        std::vector<VkBufferImageCopy> regions;
+
+        /// Next region to copy
+        index next_region = 0;
+
+        /// Next block row of region
+        ui32 next_row = 0;
+
+        /// Upload started (image in transfer layout)
+        bool started = false;
+    };
+
+    /// List of textures to stage
+    std::deque<texture_upload> m_todo;
+
+    /**
+     * @brief Pending buffer upload
+     */
+    struct buffer_upload {
+        /// Target buffer
+        buffer::s_ptr target;
+
+        /// Data to upload
+        std::vector<char> data;
+
+        /// Offset in target buffer
+        VkDeviceSize dst_offset = 0;
+
+        /// Bytes already staged
+        VkDeviceSize done = 0;
+    };
+
+    /// List of buffers to stage
+    std::deque<buffer_upload> m_buffer_todo;
+
+    /// Map of staged uploads by frame index
+    std::map<index, frame_staged> m_staged;
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Ring buffer (persistently mapped)
+    buffer::s_ptr m_ring;
+
+    /// Capacity of ring buffer
+    VkDeviceSize m_capacity = default_staging_capacity;
+
+    /// Ring write position (monotonic)
+    VkDeviceSize m_head = 0;
+
+    /// Ring release position (monotonic)
+    VkDeviceSize m_tail = 0;
+
+    /// Upload budget per frame (0: unlimited)
+    VkDeviceSize m_budget = 0;
+
+    /// Bytes staged in current frame
+    VkDeviceSize m_spent = 0;
+
+    /// Upload scheduler for textures
+    upload_scheduler::ptr m_scheduler = nullptr;
+
+    /// Timeline value to wait for in frame submit
+    ui64 m_wait_value = 0;
+
+    /// Pipeline stage to wait at in frame submit
+    VkPipelineStageFlags m_wait_stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+};
+
+/**
+ * @brief Add a copy region, later regions overwrite overlapped parts of earlier ones
+ * @note Regions of one copy command must not overlap in the target (undefined order)
+ * @param regions    List of copy regions (without overlaps in target)
+ * @param region     Copy region to add
+ */
+void add_buffer_copy(std::vector<VkBufferCopy>& regions,
+                     VkBufferCopy const& region);
+
+} // namespace lava
@@ -0,0 +1,62 @@
+/**
+ * @file         liblava/resource/test/bindless_table.cpp
+ * @brief        Bindless table unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("slot allocator", "[bindless_table]") {
+    slot_allocator allocator;
+    allocator.reset(4);
+
+    SECTION("alloc until full") {
+        for (auto i = 0u; i < 4; ++i)
+            REQUIRE(allocator.alloc() == i);
+
+        REQUIRE(allocator.alloc() == no_index);
+        REQUIRE(allocator.get_used() == 4);
+    }
+
+    SECTION("fresh slots before freed ones") {
+        auto const a = allocator.alloc();
+        allocator.free(a);
+
+        REQUIRE(allocator.alloc() == 1);
+        REQUIRE(allocator.get_used() == 1);
+    }
+
+    SECTION("recycle oldest freed slot") {
+        for (auto i = 0u; i < 4; ++i)
+            allocator.alloc();
+
+        allocator.free(2);
+        allocator.free(0);
+
+        REQUIRE(allocator.alloc() == 2);
+        REQUIRE(allocator.alloc() == 0);
+        REQUIRE(allocator.alloc() == no_index);
+    }
+
+    SECTION("ignore unallocated slot") {
+        REQUIRE_FALSE(allocator.free(3));
+        REQUIRE(allocator.get_used() == 0);
+        REQUIRE(allocator.alloc() == 0);
+    }
+
+    SECTION("ignore double free") {
+        for (auto i = 0u; i < 4; ++i)
+            allocator.alloc();
+
+        REQUIRE(allocator.free(1));
+        REQUIRE_FALSE(allocator.free(1));
+        REQUIRE(allocator.get_used() == 3);
+
+        // freed once, handed out once
+        REQUIRE(allocator.alloc() == 1);
+        REQUIRE(allocator.alloc() == no_index);
+        REQUIRE(allocator.get_used() == 4);
+    }
+}
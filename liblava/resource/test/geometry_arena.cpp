@@ -0,0 +1,48 @@
+/**
+ * @file         liblava/resource/test/geometry_arena.cpp
+ * @brief        Geometry arena unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("range allocator", "[geometry_arena]") {
+    range_allocator allocator;
+    allocator.reset(100);
+
+    SECTION("alloc until full") {
+        REQUIRE(allocator.alloc(60) == 0);
+        REQUIRE(allocator.alloc(40) == 60);
+        REQUIRE(allocator.alloc(1) == no_index);
+        REQUIRE(allocator.get_used() == 100);
+    }
+
+    SECTION("reuse freed range") {
+        auto const a = allocator.alloc(30);
+        auto const b = allocator.alloc(30);
+        allocator.alloc(30);
+
+        allocator.free(a, 30);
+        REQUIRE(allocator.alloc(20) == a);
+
+        allocator.free(b, 30);
+        REQUIRE(allocator.alloc(40) == 20);
+        REQUIRE(allocator.alloc(20) == no_index);
+    }
+
+    SECTION("coalesce neighbours") {
+        auto const a = allocator.alloc(25);
+        auto const b = allocator.alloc(25);
+        auto const c = allocator.alloc(25);
+        allocator.alloc(25);
+
+        allocator.free(a, 25);
+        allocator.free(c, 25);
+        allocator.free(b, 25);
+
+        REQUIRE(allocator.get_used() == 25);
+        REQUIRE(allocator.alloc(75) == 0);
+    }
+}
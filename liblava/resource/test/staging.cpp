@@ -0,0 +1,85 @@
+/**
+ * @file         liblava/resource/test/staging.cpp
+ * @brief        Staging unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+namespace {
+
+/**
+ * @brief Get the source offset of a target byte
+ * @param regions       List of copy regions
+ * @param dst_offset    Target byte
+ * @return VkDeviceSize    Source offset (~0: not copied)
+ */
+VkDeviceSize source_of(std::vector<VkBufferCopy> const& regions,
+                       VkDeviceSize dst_offset) {
+    auto result = ~VkDeviceSize(0);
+    auto count = 0u;
+
+    for (auto const& region : regions) {
+        if (dst_offset < region.dstOffset || dst_offset >= region.dstOffset + region.size)
+            continue;
+
+        result = region.srcOffset + (dst_offset - region.dstOffset);
+        ++count;
+    }
+
+    // regions must not overlap
+    REQUIRE(count <= 1);
+    return result;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("staging buffer copy regions", "[staging]") {
+    std::vector<VkBufferCopy> regions;
+
+    SECTION("disjoint regions are kept") {
+        add_buffer_copy(regions, {.srcOffset = 0, .dstOffset = 0, .size = 16});
+        add_buffer_copy(regions, {.srcOffset = 16, .dstOffset = 32, .size = 16});
+
+        REQUIRE(regions.size() == 2);
+        REQUIRE(source_of(regions, 8) == 8);
+        REQUIRE(source_of(regions, 40) == 24);
+        REQUIRE(source_of(regions, 20) == ~VkDeviceSize(0));
+    }
+
+    SECTION("same range: last write wins") {
+        add_buffer_copy(regions, {.srcOffset = 0, .dstOffset = 64, .size = 16});
+        add_buffer_copy(regions, {.srcOffset = 128, .dstOffset = 64, .size = 16});
+
+        REQUIRE(regions.size() == 1);
+        REQUIRE(source_of(regions, 64) == 128);
+    }
+
+    SECTION("inner overwrite splits earlier region") {
+        add_buffer_copy(regions, {.srcOffset = 0, .dstOffset = 0, .size = 64});
+        add_buffer_copy(regions, {.srcOffset = 256, .dstOffset = 16, .size = 16});
+
+        REQUIRE(regions.size() == 3);
+        REQUIRE(source_of(regions, 0) == 0);
+        REQUIRE(source_of(regions, 20) == 260);
+        REQUIRE(source_of(regions, 40) == 40);
+    }
+
+    SECTION("partial overlaps are trimmed") {
+        add_buffer_copy(regions, {.srcOffset = 0, .dstOffset = 0, .size = 32});
+        add_buffer_copy(regions, {.srcOffset = 100, .dstOffset = 48, .size = 32});
+        add_buffer_copy(regions, {.srcOffset = 200, .dstOffset = 16, .size = 48});
+
+        REQUIRE(source_of(regions, 15) == 15);
+        REQUIRE(source_of(regions, 16) == 200);
+        REQUIRE(source_of(regions, 63) == 247);
+        REQUIRE(source_of(regions, 64) == 116);
+    }
+
+    SECTION("empty region is ignored") {
+        add_buffer_copy(regions, {.srcOffset = 0, .dstOffset = 0, .size = 0});
+        REQUIRE(regions.empty());
+    }
+}
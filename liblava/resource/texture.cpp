@@ -7,6 +7,7 @@
 
 #include "liblava/resource/texture.hpp"
 #include "liblava/core/misc.hpp"
+#include "liblava/resource/bindless_table.hpp"
 #include "liblava/resource/format.hpp"
 #include "liblava/util/log.hpp"
 
@@ -17,7 +18,8 @@ bool texture::create(device::ptr device,
                      uv2 size,
                      VkFormat format,
                      layer::list const& l,
-                     texture_type t) {
+                     texture_type t,
+                     bool mips) {
     m_layers = l;
     m_type = t;
 
@@ -31,6 +33,24 @@ bool texture::create(device::ptr device,
         m_layers.push_back(layer);
     }
 
+    m_level_count = to_ui32(m_layers.front().levels.size());
+    m_generate_mips = false;
+
+    if (mips && m_level_count == 1) {
+        if (support_mip_blit(device->get_vk_physical_device(),
+                             format,
+                             m_mip_filter)) {
+            // full chain down to 1x1
+            for (auto dim = std::max(size.x, size.y); dim > 1; dim >>= 1)
+                ++m_level_count;
+
+            m_generate_mips = m_level_count > 1;
+        } else {
+            logger()->warn("texture mip generation not supported: format {}",
+                           to_ui32(format));
+        }
+    }
+
     VkSamplerAddressMode sampler_address_mode = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     if (m_type == texture_type::array || m_type == texture_type::cube_map)
         sampler_address_mode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
@@ -49,7 +69,7 @@ bool texture::create(device::ptr device,
         .compareEnable = VK_FALSE,
         .compareOp = VK_COMPARE_OP_NEVER,
         .minLod = 0.f,
-        .maxLod = to_r32(m_layers.front().levels.size()),
+        .maxLod = to_r32(m_level_count),
         .borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,
         .unnormalizedCoordinates = VK_FALSE,
     };
@@ -70,9 +90,10 @@ bool texture::create(device::ptr device,
     else if (m_type == texture_type::cube_map)
         view_type = VK_IMAGE_VIEW_TYPE_CUBE;
 
-    m_img->set_level_count(to_ui32(m_layers.front().levels.size()));
+    m_img->set_level_count(m_level_count);
     m_img->set_layer_count(to_ui32(m_layers.size()));
     m_img->set_view_type(view_type);
+    m_img->set_component(m_component);
 
     if (!m_img->create(device, size, VMA_MEMORY_USAGE_GPU_ONLY)) {
         logger()->error("create texture image");
@@ -83,12 +104,23 @@ bool texture::create(device::ptr device,
     m_descriptor.imageView = m_img->get_view();
     m_descriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
+    if (auto table = bindless_table::find(device))
+        m_bindless_index = table->add_texture(m_descriptor);
+
     return true;
 }
 
 //-----------------------------------------------------------------------------
 void texture::destroy() {
-    destroy_upload_buffer();
+    destroy_upload_data();
+
+    if (m_bindless_index != no_index) {
+        if (m_img)
+            if (auto table = bindless_table::find(m_img->get_device()))
+                table->remove_texture(m_bindless_index);
+
+        m_bindless_index = no_index;
+    }
 
     if (m_sampler) {
         if (m_img)
@@ -105,154 +137,65 @@ void texture::destroy() {
 }
 
 //-----------------------------------------------------------------------------
-void texture::destroy_upload_buffer() {
-    m_upload_buffer = nullptr;
+void texture::destroy_upload_data() {
+    m_upload_data.clear();
+    m_upload_data.shrink_to_fit();
 }
 
 //-----------------------------------------------------------------------------
 bool texture::upload(void const* data,
                      size_t data_size) {
-    m_upload_buffer = buffer::make();
-
-    return m_upload_buffer->create(m_img->get_device(),
-                                   data,
-                                   data_size,
-                                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                   false,
-                                   VMA_MEMORY_USAGE_CPU_TO_GPU);
-}
-
-//-----------------------------------------------------------------------------
-bool texture::stage(VkCommandBuffer cmd_buf) {
-    if (!m_upload_buffer || !m_upload_buffer->valid()) {
-        logger()->error("stage texture");
+    if (!m_img || !data || data_size == 0) {
+        logger()->error("upload texture");
         return false;
     }
 
-    VkImageSubresourceRange subresource_range{
-        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-        .baseMipLevel = 0,
-        .levelCount = to_ui32(m_layers.front().levels.size()),
-        .baseArrayLayer = 0,
-        .layerCount = to_ui32(m_layers.size()),
-    };
-
-    auto device = m_img->get_device();
+    m_upload_data.resize(data_size);
+    memcpy(m_upload_data.data(), data, data_size);
 
-    set_image_layout(device, cmd_buf, m_img->get(), VK_IMAGE_LAYOUT_UNDEFINED,
-                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range,
-                     VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    return true;
+}
 
+//-----------------------------------------------------------------------------
+std::vector<VkBufferImageCopy> texture::get_upload_regions() const {
     std::vector<VkBufferImageCopy> regions;
 
-    if (to_ui32(m_layers.front().levels.size()) > 1) {
-        auto offset = 0u;
+    // single level layers are packed, size is not stored
+    auto const layer_size = m_upload_data.size() / m_layers.size();
+
+    VkDeviceSize offset = 0;
 
-        for (auto layer = 0u; layer < m_layers.size(); ++layer) {
-            for (auto level = 0u;
-                 level < to_ui32(m_layers.front().levels.size());
-                 ++level) {
-                VkImageSubresourceLayers image_subresource{
+    for (auto layer = 0u; layer < m_layers.size(); ++layer) {
+        for (auto level = 0u; level < m_layers[layer].levels.size(); ++level) {
+            auto const& mip_level = m_layers[layer].levels[level];
+
+            regions.push_back({
+                .bufferOffset = offset,
+                .imageSubresource = {
                     .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
                     .mipLevel = level,
                     .baseArrayLayer = layer,
                     .layerCount = 1,
-                };
-
-                VkExtent3D image_extent{
-                    .width = m_layers[layer].levels[level].extent.x,
-                    .height = m_layers[layer].levels[level].extent.y,
-                    .depth = 1,
-                };
-
-                VkBufferImageCopy buffer_copy_region{
-                    .bufferOffset = offset,
-                    .imageSubresource = image_subresource,
-                    .imageExtent = image_extent,
-                };
+                },
+                .imageExtent = {mip_level.extent.x, mip_level.extent.y, 1},
+            });
 
-                regions.push_back(buffer_copy_region);
-
-                offset += m_layers[layer].levels[level].size;
-            }
+            offset += mip_level.size > 0 ? mip_level.size : layer_size;
         }
-    } else {
-        VkImageSubresourceLayers subresource_layers{
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .mipLevel = 0,
-            .baseArrayLayer = 0,
-            .layerCount = to_ui32(m_layers.size()),
-        };
-
-        auto size = m_img->get_size();
-
-        VkBufferImageCopy region{
-            .bufferOffset = 0,
-            .bufferRowLength = size.x,
-            .bufferImageHeight = size.y,
-            .imageSubresource = subresource_layers,
-            .imageOffset = {},
-            .imageExtent = {size.x, size.y, 1},
-        };
-
-        regions.push_back(region);
     }
 
-    device->call().vkCmdCopyBufferToImage(cmd_buf,
-                                          m_upload_buffer->get(),
-                                          m_img->get(),
-                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                          to_ui32(regions.size()),
-                                          regions.data());
-
-    set_image_layout(device,
-                     cmd_buf,
-                     m_img->get(),
-                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                     subresource_range,
-                     VK_PIPELINE_STAGE_TRANSFER_BIT,
-                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-
-    logger()->trace("texture staged: {}", get_id().value);
-
-    return true;
+    return regions;
 }
 
 //-----------------------------------------------------------------------------
-bool staging::stage(VkCommandBuffer cmd_buf,
-                    index frame) {
-    if (!m_staged.empty() && m_staged.count(frame)
-        && !m_staged.at(frame).empty()) {
-        for (auto& texture : m_staged.at(frame))
-            texture->destroy_upload_buffer();
-
-        m_staged.erase(frame);
-    }
-
-    if (m_todo.empty())
-        return false;
-
-    texture::s_list stage_done;
-
-    for (auto& texture : m_todo) {
-        if (!texture->stage(cmd_buf))
-            continue;
-
-        stage_done.push_back(texture);
-    }
-
-    if (!m_staged.count(frame))
-        m_staged.emplace(frame, texture::s_list());
-
-    for (auto& texture : stage_done) {
-        if (!contains(m_staged.at(frame), texture))
-            m_staged.at(frame).push_back(texture);
-
-        remove(m_todo, texture);
-    }
-
-    return true;
+VkImageSubresourceRange texture::get_subresource_range() const {
+    return {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = m_level_count,
+        .baseArrayLayer = 0,
+        .layerCount = to_ui32(m_layers.size()),
+    };
 }
 
 } // namespace lava
@@ -96,13 +96,15 @@ struct texture : entity {
      * @param format    Texture format
      * @param layers    List of layers
      * @param type      Texture type
+     * @param mips      Generate mip levels on device (single level layers only)
      * @return Create was successful or failed
      */
     bool create(device::ptr device,
                 uv2 size,
                 VkFormat format,
                 layer::list const& layers = {},
-                texture_type type = texture_type::tex_2d);
+                texture_type type = texture_type::tex_2d,
+                bool mips = false);
 
     /**
      * @brief Destroy the texture
@@ -110,7 +112,15 @@ struct texture : entity {
     void destroy();
 
     /**
-     * @brief Upload data to texture
+     * @brief Set the component mapping of the texture view (before create)
+     * @param mapping    Component mapping
+     */
+    void set_component(VkComponentMapping mapping = {}) {
+        m_component = mapping;
+    }
+
+    /**
+     * @brief Upload data to texture (kept until staged)
      * @param data         Data to upload
      * @param data_size    Size of data
      * @return Upload was successful or failed
@@ -119,16 +129,61 @@ struct texture : entity {
                 size_t data_size);
 
     /**
-     * @brief Stage the texture
-     * @param cmd_buffer    Command buffer
-     * @return Stage was successful or failed
+     * @brief Get the copy regions of upload data (one per layer and level)
+     * @return std::vector<VkBufferImageCopy>    List of regions with offsets in upload data
      */
-    bool stage(VkCommandBuffer cmd_buffer);
+    std::vector<VkBufferImageCopy> get_upload_regions() const;
 
     /**
-     * @brief Destroy the upload buffer
+     * @brief Check if mip levels are generated on device
+     * @return Mip levels are generated or not
      */
-    void destroy_upload_buffer();
+    bool generate_mips() const {
+        return m_generate_mips;
+    }
+
+    /**
+     * @brief Get the filter to generate mip levels
+     * @return VkFilter    Blit filter
+     */
+    VkFilter get_mip_filter() const {
+        return m_mip_filter;
+    }
+
+    /**
+     * @brief Get the number of mip levels of the image
+     * @return ui32    Number of levels (uploaded and generated)
+     */
+    ui32 get_level_count() const {
+        return m_level_count;
+    }
+
+    /**
+     * @brief Get the subresource range of all layers and levels
+     * @return VkImageSubresourceRange    Image subresource range
+     */
+    VkImageSubresourceRange get_subresource_range() const;
+
+    /**
+     * @brief Get the pending upload data
+     * @return c_data    Upload data
+     */
+    c_data get_upload_data() const {
+        return {m_upload_data.data(), m_upload_data.size()};
+    }
+
+    /**
+     * @brief Get the size of pending upload data
+     * @return VkDeviceSize    Size of upload data (0: nothing to upload)
+     */
+    VkDeviceSize get_upload_size() const {
+        return m_upload_data.size();
+    }
+
+    /**
+     * @brief Destroy the upload data
+     */
+    void destroy_upload_data();
 
     /**
      * @brief Get the descriptor information
@@ -138,6 +193,14 @@ struct texture : entity {
         return &m_descriptor;
     }
 
+    /**
+     * @brief Get the index in the bindless table of the device
+     * @return index    Texture index (no_index: no table)
+     */
+    index get_bindless_index() const {
+        return m_bindless_index;
+    }
+
     /**
      * @brief Get the image of the texture
      * @return image::s_ptr    Shared pointer to image
@@ -186,59 +249,23 @@ private:
     /// Descriptor image information
     VkDescriptorImageInfo m_descriptor = {};
 
-    /// Upload buffer
-    buffer::s_ptr m_upload_buffer;
-};
-
-/**
- * @brief Texture staging
- */
-struct staging {
-    /// Pointer to staging
-    using ptr = staging*;
-
-    /**
-     * @brief Add texture for staging
-     * @param texture    Texture to stage
-     */
-    void add(texture::s_ptr texture) {
-        m_todo.push_back(texture);
-    }
-
-    /**
-     * @brief Stage textures
-     * @param cmd_buf    Command buffer
-     * @param frame      Frame index
-     * @return Stage was successful or failed
-     */
-    bool stage(VkCommandBuffer cmd_buf,
-               index frame);
+    /// Index in bindless table
+    index m_bindless_index = no_index;
 
-    /**
-     * @brief Clear staging
-     */
-    void clear() {
-        m_todo.clear();
-        m_staged.clear();
-    }
+    /// Component mapping of texture view
+    VkComponentMapping m_component = {};
 
-    /**
-     * @brief Check if staging is busy
-     * @return Staging is busy or not
-     */
-    bool busy() const {
-        return !m_todo.empty() || !m_staged.empty();
-    }
+    /// Upload data
+    std::vector<char> m_upload_data;
 
-private:
-    /// List of textures to stage
-    texture::s_list m_todo;
+    /// Number of mip levels of the image
+    ui32 m_level_count = 1;
 
-    /// Map of textures by frame index
-    using frame_stage_map = std::map<index, texture::s_list>;
+    /// Generate mip levels on device
+    bool m_generate_mips = false;
 
-    /// Map of staged textures
-    frame_stage_map m_staged;
+    /// Filter to generate mip levels
+    VkFilter m_mip_filter = VK_FILTER_LINEAR;
 };
 
 /// Texture registry
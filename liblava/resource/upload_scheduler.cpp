@@ -0,0 +1,195 @@
+/**
+ * @file         liblava/resource/upload_scheduler.cpp
+ * @brief        Upload scheduler on dedicated transfer queue
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/upload_scheduler.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+bool upload_scheduler::create(device::ptr dev,
+                              queue::ref transfer_queue,
+                              index graphics_family,
+                              index frame_count) {
+    if (!dev->has_timeline_semaphore()) {
+        logger()->warn("upload scheduler needs timeline semaphores");
+        return false;
+    }
+
+    if (!transfer_queue.valid() || transfer_queue.family == graphics_family) {
+        logger()->warn("upload scheduler needs a dedicated transfer queue");
+        return false;
+    }
+
+    m_device = dev;
+    m_queue = transfer_queue;
+    m_graphics_family = graphics_family;
+
+    VkSemaphoreTypeCreateInfo const type_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
+
+    VkSemaphoreCreateInfo const semaphore_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type_info,
+    };
+
+    if (!m_device->vkCreateSemaphore(&semaphore_info, &m_semaphore)) {
+        logger()->error("create upload scheduler semaphore");
+        return false;
+    }
+
+    m_value = 0;
+
+    m_pools.resize(frame_count);
+    m_cmd_bufs.resize(frame_count);
+    m_frame_values.resize(frame_count, 0);
+
+    for (auto i = 0u; i < frame_count; ++i) {
+        VkCommandPoolCreateInfo const pool_info{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = m_queue.family,
+        };
+
+        if (!m_device->vkCreateCommandPool(&pool_info, &m_pools[i])) {
+            logger()->error("create upload scheduler command pool");
+            destroy();
+            return false;
+        }
+
+        if (!m_device->vkAllocateCommandBuffers(m_pools[i], 1, &m_cmd_bufs[i])) {
+            logger()->error("create upload scheduler command buffer");
+            destroy();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void upload_scheduler::destroy() {
+    if (!m_device)
+        return;
+
+    // uploads still in flight
+    if (m_semaphore && m_value > 0) {
+        VkSemaphoreWaitInfo const wait_info{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores = &m_semaphore,
+            .pValues = &m_value,
+        };
+
+        auto wait_semaphores = m_device->call().vkWaitSemaphores
+                                   ? m_device->call().vkWaitSemaphores
+                                   : m_device->call().vkWaitSemaphoresKHR;
+        if (wait_semaphores)
+            check(wait_semaphores(m_device->get(), &wait_info, UINT64_MAX));
+    }
+
+    for (auto i = 0u; i < m_pools.size(); ++i) {
+        if (!m_pools[i])
+            continue;
+
+        if (m_cmd_bufs[i])
+            m_device->vkFreeCommandBuffers(m_pools[i], 1, &m_cmd_bufs[i]);
+
+        m_device->vkDestroyCommandPool(m_pools[i]);
+    }
+
+    m_pools.clear();
+    m_cmd_bufs.clear();
+    m_frame_values.clear();
+
+    if (m_semaphore) {
+        m_device->vkDestroySemaphore(m_semaphore);
+        m_semaphore = VK_NULL_HANDLE;
+    }
+
+    m_value = 0;
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+VkCommandBuffer upload_scheduler::begin(index frame) {
+    if (!ready() || frame >= m_cmd_bufs.size())
+        return nullptr;
+
+    // previous uploads of this frame must be done before reuse
+    if (m_frame_values[frame] > 0) {
+        VkSemaphoreWaitInfo const wait_info{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores = &m_semaphore,
+            .pValues = &m_frame_values[frame],
+        };
+
+        auto wait_semaphores = m_device->call().vkWaitSemaphores
+                                   ? m_device->call().vkWaitSemaphores
+                                   : m_device->call().vkWaitSemaphoresKHR;
+        if (!wait_semaphores
+            || failed(wait_semaphores(m_device->get(), &wait_info, UINT64_MAX)))
+            return nullptr;
+    }
+
+    if (failed(m_device->call().vkResetCommandPool(m_device->get(),
+                                                   m_pools[frame],
+                                                   0)))
+        return nullptr;
+
+    VkCommandBufferBeginInfo const begin_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+
+    if (failed(m_device->call().vkBeginCommandBuffer(m_cmd_bufs[frame],
+                                                     &begin_info)))
+        return nullptr;
+
+    return m_cmd_bufs[frame];
+}
+
+//-----------------------------------------------------------------------------
+bool upload_scheduler::submit(index frame) {
+    auto cmd_buf = m_cmd_bufs.at(frame);
+
+    if (failed(m_device->call().vkEndCommandBuffer(cmd_buf)))
+        return false;
+
+    auto const signal_value = m_value + 1;
+
+    VkTimelineSemaphoreSubmitInfo const timeline_info{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &signal_value,
+    };
+
+    VkSubmitInfo const submit_info{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timeline_info,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &cmd_buf,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &m_semaphore,
+    };
+
+    if (!m_device->vkQueueSubmit(m_queue.vk_queue, 1, &submit_info, VK_NULL_HANDLE)) {
+        logger()->error("submit uploads");
+        return false;
+    }
+
+    m_value = signal_value;
+    m_frame_values[frame] = signal_value;
+
+    return true;
+}
+
+} // namespace lava
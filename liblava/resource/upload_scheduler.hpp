@@ -0,0 +1,127 @@
+/**
+ * @file         liblava/resource/upload_scheduler.hpp
+ * @brief        Upload scheduler on dedicated transfer queue
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/base/device.hpp"
+
+namespace lava {
+
+/**
+ * @brief Upload scheduler (records uploads on a dedicated transfer queue)
+ */
+struct upload_scheduler {
+    /// Pointer to upload scheduler
+    using ptr = upload_scheduler*;
+
+    /**
+     * @brief Destroy the upload scheduler
+     */
+    ~upload_scheduler() {
+        destroy();
+    }
+
+    /**
+     * @brief Create a new upload scheduler
+     * @note Needs timeline semaphores and a transfer queue of another family
+     * @param device             Vulkan device
+     * @param transfer_queue     Dedicated transfer queue
+     * @param graphics_family    Queue family of graphics queue
+     * @param frame_count        Number of frames in flight
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                queue::ref transfer_queue,
+                index graphics_family,
+                index frame_count);
+
+    /**
+     * @brief Destroy the upload scheduler
+     */
+    void destroy();
+
+    /**
+     * @brief Begin to record uploads of a frame
+     * @param frame               Frame index
+     * @return VkCommandBuffer    Transfer command buffer (nullptr: failed)
+     */
+    VkCommandBuffer begin(index frame);
+
+    /**
+     * @brief Submit the recorded uploads of a frame
+     * @param frame    Frame index
+     * @return Submit was successful or failed
+     */
+    bool submit(index frame);
+
+    /**
+     * @brief Check if the upload scheduler is ready
+     * @return Upload scheduler is ready or not
+     */
+    bool ready() const {
+        return m_semaphore != VK_NULL_HANDLE;
+    }
+
+    /**
+     * @brief Get the timeline semaphore
+     * @return VkSemaphore    Timeline semaphore
+     */
+    VkSemaphore get_semaphore() const {
+        return m_semaphore;
+    }
+
+    /**
+     * @brief Get the last signaled timeline value
+     * @return ui64    Timeline value
+     */
+    ui64 get_value() const {
+        return m_value;
+    }
+
+    /**
+     * @brief Get the transfer queue family
+     * @return index    Queue family index
+     */
+    index get_family() const {
+        return m_queue.family;
+    }
+
+    /**
+     * @brief Get the graphics queue family
+     * @return index    Queue family index
+     */
+    index get_graphics_family() const {
+        return m_graphics_family;
+    }
+
+private:
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Transfer queue
+    queue m_queue;
+
+    /// Graphics queue family
+    index m_graphics_family = 0;
+
+    /// Transfer command pools per frame
+    VkCommandPools m_pools;
+
+    /// Transfer command buffers per frame
+    VkCommandBuffers m_cmd_bufs;
+
+    /// Timeline values of last submit per frame
+    std::vector<ui64> m_frame_values;
+
+    /// Timeline semaphore
+    VkSemaphore m_semaphore = VK_NULL_HANDLE;
+
+    /// Last signaled timeline value
+    ui64 m_value = 0;
+};
+
+} // namespace lava
@@ -58,15 +58,27 @@ struct thread_pool {
 
     /**
      * @brief Tear down the thread pool
+     * @note Queued tasks which have not started are discarded
      */
     void teardown() {
-        m_stop = true;
+        {
+            std::unique_lock<std::mutex> lock(m_queue_mutex);
+            m_stop = true;
+        }
         m_condition.notify_all();
 
         for (auto& worker : m_workers)
             worker.join();
 
         m_workers.clear();
+
+        {
+            std::unique_lock<std::mutex> lock(m_queue_mutex);
+            m_tasks.clear();
+            m_busy = 0;
+            m_stop = false;
+        }
+        m_done.notify_all();
     }
 
     /**
@@ -77,10 +89,21 @@ struct thread_pool {
         {
             std::unique_lock<std::mutex> lock(m_queue_mutex);
             m_tasks.push_back(task(f));
+            ++m_busy;
         }
         m_condition.notify_one();
     }
 
+    /**
+     * @brief Wait until all enqueued tasks are done (or discarded by teardown)
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        m_done.wait(lock, [&]() {
+            return m_busy == 0;
+        });
+    }
+
 private:
     /**
      * @brief Thread worker
@@ -115,6 +138,12 @@ private:
                 }
 
                 task(thread_id);
+
+                {
+                    std::unique_lock<std::mutex> lock(m_pool.m_queue_mutex);
+                    if (--m_pool.m_busy == 0)
+                        m_pool.m_done.notify_all();
+                }
             }
         }
 
@@ -135,6 +164,12 @@ private:
     /// Condition variable
     std::condition_variable m_condition;
 
+    /// Tasks done condition
+    std::condition_variable m_done;
+
+    /// Number of queued and running tasks
+    ui32 m_busy = 0;
+
     /// Stop state
     bool m_stop = false;
 };
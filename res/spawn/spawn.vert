@@ -3,6 +3,7 @@
 layout(location = 0) in vec3 inPos;
 layout(location = 1) in vec4 inColor;
 layout(location = 2) in vec2 inUV;
+layout(location = 3) in mat4 inInstanceModel;
 
 layout(binding = 0) uniform Ubo_Camera {
     mat4 projection;
@@ -26,5 +27,5 @@ void main() {
     outColor = inColor;
     outUV = inUV;
 
-    gl_Position = ubo_camera.projection * ubo_camera.view * ubo_spawn.model * vec4(inPos, 1.0);
+    gl_Position = ubo_camera.projection * ubo_camera.view * ubo_spawn.model * inInstanceModel * vec4(inPos, 1.0);
 }